@@ -0,0 +1,178 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserEntryIndex.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "gui/UrlTools.h"
+
+/**
+ * The index is owned by the database and follows its entries through
+ * the entryRegistered() and entryUnregistered() signals.
+ */
+BrowserEntryIndex::BrowserEntryIndex(Database* db)
+    : QObject(db)
+{
+    Q_ASSERT(db);
+    connect(db, &Database::entryRegistered, this, &BrowserEntryIndex::addEntry);
+    connect(db, &Database::entryUnregistered, this, &BrowserEntryIndex::removeEntry);
+
+    if (db->rootGroup()) {
+        for (auto entry : db->rootGroup()->entriesRecursive()) {
+            addEntry(entry);
+        }
+    }
+}
+
+void BrowserEntryIndex::addEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    if (!m_dirty.contains(entry) && !m_entryKeys.contains(entry) && !m_unindexed.contains(entry)) {
+        connect(entry, &Entry::modified, this, [this, entry] { m_dirty.insert(entry); });
+    }
+    m_dirty.insert(entry);
+}
+
+void BrowserEntryIndex::removeEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    disconnect(entry, nullptr, this, nullptr);
+    m_dirty.remove(entry);
+    unindexEntry(entry);
+}
+
+/**
+ * Number of entries known to the index
+ */
+int BrowserEntryIndex::size() const
+{
+    auto entries = m_dirty;
+    entries.unite(m_unindexed);
+    for (auto it = m_entryKeys.constBegin(); it != m_entryKeys.constEnd(); ++it) {
+        entries.insert(it.key());
+    }
+    return entries.size();
+}
+
+/**
+ * Key an entry URL has to be indexed under to possibly match the site URL.
+ * An URL can only match if both share the same base domain.
+ */
+QString BrowserEntryIndex::siteKey(const QString& siteUrl)
+{
+    const auto site = urlTools()->normalizeUrl(siteUrl);
+    return site.hasScheme ? site.baseDomain : QString();
+}
+
+/**
+ * Determine the entries that can possibly match the given site URL.
+ * The result is unordered and still has to be matched exactly.
+ */
+QList<Entry*> BrowserEntryIndex::candidates(const QString& siteUrl)
+{
+    updateDirtyEntries();
+
+    auto result = m_unindexed;
+    const auto key = siteKey(siteUrl);
+    if (!key.isEmpty()) {
+        result.unite(m_domains.value(key));
+    }
+    return result.values();
+}
+
+void BrowserEntryIndex::indexEntry(Entry* entry)
+{
+    QStringList keys;
+    if (!urlKeys(entry, keys)) {
+        m_unindexed.insert(entry);
+        return;
+    }
+
+    for (const auto& key : asConst(keys)) {
+        m_domains[key].insert(entry);
+    }
+    m_entryKeys.insert(entry, keys);
+}
+
+void BrowserEntryIndex::unindexEntry(Entry* entry)
+{
+    m_unindexed.remove(entry);
+
+    const auto keys = m_entryKeys.take(entry);
+    for (const auto& key : keys) {
+        auto it = m_domains.find(key);
+        if (it != m_domains.end()) {
+            it->remove(entry);
+            if (it->isEmpty()) {
+                m_domains.erase(it);
+            }
+        }
+    }
+}
+
+void BrowserEntryIndex::updateDirtyEntries()
+{
+    for (auto entry : asConst(m_dirty)) {
+        unindexEntry(entry);
+        indexEntry(entry);
+    }
+    m_dirty.clear();
+}
+
+/**
+ * Collect the base domains of all URLs of an entry. Returns false if the
+ * URLs contain placeholders, their value may change without the entry
+ * being modified.
+ */
+bool BrowserEntryIndex::urlKeys(const Entry* entry, QStringList& keys)
+{
+    if (entry->url().contains('{')) {
+        return false;
+    }
+
+    // Same attributes as Entry::getAllUrls()
+    const auto attributes = entry->attributes();
+    const auto relyingPartyKey = QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute);
+    for (const auto& key : attributes->keys()) {
+        if ((key.startsWith(EntryAttributes::AdditionalUrlAttribute) || key == relyingPartyKey)
+            && attributes->value(key).contains('{')) {
+            return false;
+        }
+    }
+
+    const auto urls = entry->getAllUrls();
+    for (const auto& url : urls) {
+        const auto normalized = urlTools()->normalizeUrl(url);
+        const auto& host = normalized.host;
+        if (host.isEmpty()) {
+            // Can only ever match local files, which are not looked up through the index
+            continue;
+        }
+
+        keys << normalized.baseDomain;
+        // Groups can omit the www subdomain of their entries
+        if (host.startsWith("www.")) {
+            keys << urlTools()->getBaseDomainFromUrl(QString(host).remove("www."));
+        }
+    }
+
+    keys.removeDuplicates();
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERENTRYINDEX_H
+#define KEEPASSXC_BROWSERENTRYINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class Database;
+class Entry;
+
+/**
+ * Index from the base domain of every entry URL, including additional
+ * URLs, to the entries of a database.
+ *
+ * The index only narrows down the entries a browser request has to look at,
+ * BrowserService still matches every candidate against the site URL. Entries
+ * with placeholders in their URLs are not indexed and always reported as
+ * candidates. Modified entries are re-indexed lazily on the next query.
+ */
+class BrowserEntryIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BrowserEntryIndex(Database* db);
+
+    QList<Entry*> candidates(const QString& siteUrl);
+    int size() const;
+
+    static QString siteKey(const QString& siteUrl);
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+private:
+    void indexEntry(Entry* entry);
+    void unindexEntry(Entry* entry);
+    void updateDirtyEntries();
+
+    static bool urlKeys(const Entry* entry, QStringList& keys);
+
+    QHash<QString, QSet<Entry*>> m_domains;
+    QHash<Entry*, QStringList> m_entryKeys;
+    QSet<Entry*> m_unindexed;
+    QSet<Entry*> m_dirty;
+};
+
+#endif // KEEPASSXC_BROWSERENTRYINDEX_H
@@ -17,6 +17,7 @@
 
 #include "BrowserHost.h"
 #include "BrowserShared.h"
+#include "core/Global.h"
 
 #include <QJsonDocument>
 #include <QLocalServer>
@@ -53,7 +54,7 @@ void BrowserHost::start()
 
 void BrowserHost::stop()
 {
-    m_socketList.clear();
+    m_connections.clear();
     m_localServer->close();
 }
 
@@ -61,7 +62,14 @@ void BrowserHost::proxyConnected()
 {
     auto socket = m_localServer->nextPendingConnection();
     if (socket) {
-        m_socketList.append(socket);
+        socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+        int socketDesc = socket->socketDescriptor();
+        if (socketDesc) {
+            int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
+            setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+        }
+
+        m_connections.insert(socket, {});
         connect(socket, SIGNAL(readyRead()), this, SLOT(readProxyMessage()));
         connect(socket, SIGNAL(disconnected()), this, SLOT(proxyDisconnected()));
     }
@@ -69,33 +77,56 @@ void BrowserHost::proxyConnected()
 
 void BrowserHost::readProxyMessage()
 {
-    QLocalSocket* socket = qobject_cast<QLocalSocket*>(QObject::sender());
-    if (!socket || socket->bytesAvailable() <= 0) {
+    QPointer<QLocalSocket> socket = qobject_cast<QLocalSocket*>(QObject::sender());
+    if (!socket || socket->bytesAvailable() <= 0 || !m_connections.contains(socket)) {
         return;
     }
 
-    socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
-    int socketDesc = socket->socketDescriptor();
-    if (socketDesc) {
-        int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
-        setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+    // Split the received data into messages before handling any of them, handlers may run an event loop
+    auto& connection = m_connections[socket];
+    connection.buffer.append(socket->readAll());
+    QList<QByteArray> messages;
+    while (connection.buffer.size() >= BrowserShared::NATIVEMSG_HEADER_LENGTH) {
+        QByteArray message;
+        if (!BrowserShared::isFramedMessage(connection.buffer)) {
+            // Older proxies send one bare JSON document at a time
+            connection.framed = false;
+            message = connection.buffer;
+            connection.buffer.clear();
+        } else if (BrowserShared::takeFramedMessage(connection.buffer, message)) {
+            connection.framed = true;
+            if (message.isEmpty()) {
+                // Acknowledge the framing handshake of the proxy
+                socket->write(BrowserShared::frameMessage({}));
+                socket->flush();
+                continue;
+            }
+        } else {
+            break;
+        }
+        messages << message;
     }
 
-    QJsonParseError error;
-    auto json = QJsonDocument::fromJson(socket->readAll(), &error);
-    if (json.isNull()) {
-        qWarning() << "Failed to read proxy message: " << error.errorString();
-        return;
+    for (const auto& message : asConst(messages)) {
+        QJsonParseError error;
+        auto json = QJsonDocument::fromJson(message, &error);
+        if (json.isNull()) {
+            qWarning() << "Failed to read proxy message: " << error.errorString();
+            continue;
+        }
+
+        emit clientMessageReceived(socket, json.object());
+        if (!socket) {
+            break;
+        }
     }
-
-    emit clientMessageReceived(socket, json.object());
 }
 
 void BrowserHost::broadcastClientMessage(const QJsonObject& json)
 {
     QString reply(QJsonDocument(json).toJson(QJsonDocument::Compact));
-    for (const auto socket : m_socketList) {
-        sendClientData(socket, reply);
+    for (auto it = m_connections.cbegin(); it != m_connections.cend(); ++it) {
+        sendClientData(it.key(), reply);
     }
 }
 
@@ -109,6 +140,9 @@ void BrowserHost::sendClientData(QLocalSocket* socket, const QString& data)
 {
     if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
         QByteArray arr = data.toUtf8();
+        if (m_connections.value(socket).framed) {
+            arr = BrowserShared::frameMessage(arr);
+        }
         socket->write(arr.constData(), arr.length());
         socket->flush();
     }
@@ -117,5 +151,5 @@ void BrowserHost::sendClientData(QLocalSocket* socket, const QString& data)
 void BrowserHost::proxyDisconnected()
 {
     auto socket = qobject_cast<QLocalSocket*>(QObject::sender());
-    m_socketList.removeOne(socket);
+    m_connections.remove(socket);
 }
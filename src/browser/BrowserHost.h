@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_NATIVEMESSAGINGHOST_H
 #define KEEPASSXC_NATIVEMESSAGINGHOST_H
 
+#include <QHash>
 #include <QJsonObject>
 #include <QObject>
 #include <QPointer>
@@ -52,8 +53,15 @@ private:
     void sendClientData(QLocalSocket* socket, const QString& data);
 
 private:
+    struct ProxyConnection
+    {
+        QByteArray buffer;
+        // Reply in the framing of the last message received, older proxies send bare JSON
+        bool framed = false;
+    };
+
     QPointer<QLocalServer> m_localServer;
-    QList<QLocalSocket*> m_socketList;
+    QHash<QLocalSocket*, ProxyConnection> m_connections;
 };
 
 #endif // KEEPASSXC_NATIVEMESSAGINGHOST_H
@@ -20,6 +20,7 @@
 #include "BrowserService.h"
 #include "BrowserAction.h"
 #include "BrowserEntryConfig.h"
+#include "BrowserEntryIndex.h"
 #include "BrowserEntrySaveDialog.h"
 #include "BrowserHost.h"
 #include "BrowserMessageBuilder.h"
@@ -74,6 +75,16 @@ const QString BrowserService::OPTION_RESTRICT_KEY = QStringLiteral("BrowserRestr
 
 Q_GLOBAL_STATIC(BrowserService, s_browserService);
 
+// Position of an entry in a pre-order walk of the groups, entries of a group come before those of its children
+static QPair<QVector<int>, int> treePosition(const Entry* entry)
+{
+    QVector<int> groupPath;
+    for (auto group = entry->group(); group->parentGroup(); group = group->parentGroup()) {
+        groupPath.prepend(group->parentGroup()->children().indexOf(const_cast<Group*>(group)));
+    }
+    return qMakePair(groupPath, entry->group()->entries().indexOf(const_cast<Entry*>(entry)));
+}
+
 BrowserService::BrowserService()
     : QObject()
     , m_browserHost(new BrowserHost)
@@ -1019,49 +1030,88 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group->isRecycled()
-            || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
-            continue;
+    // Special schemes and passkeys are not matched by domain, check every entry for them
+    QList<Entry*> candidates;
+    if (passkey || siteUrl.startsWith("keepassxc://") || siteUrl.startsWith("file://")) {
+        candidates = rootGroup->entriesRecursive();
+    } else {
+        candidates = entryIndex(db)->candidates(siteUrl);
+    }
+
+    // Group options are inherited, resolve them once per group
+    struct GroupOptions
+    {
+        bool skip;
+        bool omitWwwSubdomain;
+    };
+    QHash<const Group*, GroupOptions> groupOptions;
+    auto optionsForGroup = [&](const Group* group) {
+        auto it = groupOptions.constFind(group);
+        if (it != groupOptions.constEnd()) {
+            return it.value();
         }
 
+        GroupOptions options;
         // If a key restriction is specified and not contained in the keys list then skip this group.
-        auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
-        if (!restrictKey.isEmpty() && !keys.contains(restrictKey)) {
+        const auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
+        options.skip = group->isRecycled()
+                       || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable
+                       || (!restrictKey.isEmpty() && !keys.contains(restrictKey));
+        options.omitWwwSubdomain = group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
+        return *groupOptions.insert(group, options);
+    };
+
+    for (auto* entry : candidates) {
+        const auto options = optionsForGroup(entry->group());
+        if (options.skip) {
             continue;
         }
 
-        const auto omitWwwSubdomain =
-            group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
-
-        for (auto* entry : group->entries()) {
-            if (entry->isRecycled()
-                || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
-                    && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
-                continue;
-            }
+        if (entry->isRecycled()
+            || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
+                && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
+            continue;
+        }
 
-            if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
-                continue;
-            }
+        if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, options.omitWwwSubdomain)) {
+            continue;
+        }
 
 #ifdef WITH_XC_BROWSER_PASSKEYS
-            // With Passkeys, check for the Relying Party instead of URL
-            if (passkey && entry->attributes()->value(EntryAttributes::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
-                continue;
-            }
+        // With Passkeys, check for the Relying Party instead of URL
+        if (passkey && entry->attributes()->value(EntryAttributes::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
+            continue;
+        }
 #endif
 
-            // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
-                entries.append(entry);
-            }
-        }
+        entries.append(entry);
     }
 
+    // Report the entries in the order they appear in the database, independent of the index
+    QHash<const Entry*, QPair<QVector<int>, int>> positions;
+    for (const auto* entry : asConst(entries)) {
+        positions.insert(entry, treePosition(entry));
+    }
+    std::sort(entries.begin(), entries.end(), [&positions](const Entry* lhs, const Entry* rhs) {
+        return positions.value(lhs) < positions.value(rhs);
+    });
     return entries;
 }
 
+/**
+ * Get the URL index of a database, it is created on first use and
+ * destroyed together with the database.
+ */
+BrowserEntryIndex* BrowserService::entryIndex(const QSharedPointer<Database>& db)
+{
+    auto& index = m_entryIndexes[db.data()];
+    if (!index) {
+        index = new BrowserEntryIndex(db.data());
+        connect(db.data(), &QObject::destroyed, this, [this, key = db.data()] { m_entryIndexes.remove(key); });
+    }
+    return index;
+}
+
 QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
                                             const QString& formUrl,
                                             const StringPairList& keyList,
@@ -1099,14 +1149,10 @@ QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
         }
     }
 
-    // Search entries matching the hostname
-    QString hostname = QUrl(siteUrl).host();
     QList<Entry*> entries;
-    do {
-        for (const auto& db : databases) {
-            entries << searchEntries(db, siteUrl, formUrl, keys, passkey);
-        }
-    } while (entries.isEmpty() && removeFirstDomain(hostname));
+    for (const auto& db : databases) {
+        entries << searchEntries(db, siteUrl, formUrl, keys, passkey);
+    }
 
     return entries;
 }
@@ -1281,10 +1327,11 @@ int BrowserService::sortPriority(const QStringList& urls, const QString& siteUrl
     const auto adjustedFormUrl = QUrl(formUrl).adjusted(stdOpts);
 
     auto getPriority = [&](const QString& givenUrl) {
-        auto url = QUrl::fromUserInput(givenUrl).adjusted(stdOpts);
+        const auto normalizedUrl = urlTools()->normalizeUrl(givenUrl);
+        auto url = normalizedUrl.url.adjusted(stdOpts);
 
         // Default to https scheme if undefined
-        if (url.scheme().isEmpty() || !givenUrl.contains("://")) {
+        if (url.scheme().isEmpty() || !normalizedUrl.hasScheme) {
             url.setScheme("https");
         }
 
@@ -1342,23 +1389,6 @@ int BrowserService::sortPriority(const QStringList& urls, const QString& siteUrl
     return *std::max_element(priorityList.begin(), priorityList.end());
 }
 
-bool BrowserService::removeFirstDomain(QString& hostname)
-{
-    int pos = hostname.indexOf(".");
-    if (pos < 0) {
-        return false;
-    }
-
-    // Don't remove the second-level domain if it's the only one
-    if (hostname.count(".") > 1) {
-        hostname = hostname.mid(pos + 1);
-        return !hostname.isEmpty();
-    }
-
-    // Nothing removed
-    return false;
-}
-
 /* Test if a search URL matches a custom entry. If the URL has the schema "keepassxc", some special checks will be made.
  * Otherwise, this simply delegates to handleURL(). */
 bool BrowserService::shouldIncludeEntry(Entry* entry,
@@ -1469,57 +1499,57 @@ bool BrowserService::handleURL(const QString& entryUrl,
         return false;
     }
 
-    QUrl entryQUrl;
-    if (entryUrl.contains("://")) {
-        entryQUrl = entryUrl;
-    } else {
-        entryQUrl = QUrl::fromUserInput(entryUrl);
-
-        if (browserSettings()->matchUrlScheme()) {
-            entryQUrl.setScheme("https");
-        }
+    // Make a direct compare if a local file is used
+    if (siteUrl.startsWith("file://")) {
+        return entryUrl == formUrl;
     }
 
+    const auto entryQUrl = urlTools()->normalizeUrl(entryUrl);
+    auto entryHost = entryQUrl.host;
+    auto entryBaseDomain = entryQUrl.baseDomain;
+
     // Remove WWW subdomain from matching if group setting is enabled
-    if (omitWwwSubdomain && entryQUrl.host().startsWith("www.")) {
-        entryQUrl.setHost(entryQUrl.host().remove("www."));
+    if (omitWwwSubdomain && entryHost.startsWith("www.")) {
+        entryHost.remove("www.");
+        entryBaseDomain = urlTools()->getBaseDomainFromUrl(entryHost);
     }
 
-    // Make a direct compare if a local file is used
-    if (siteUrl.startsWith("file://")) {
-        return entryUrl == formUrl;
+    // URL host validation fails
+    if (entryHost.isEmpty()) {
+        return false;
     }
 
-    // URL host validation fails
-    if (entryQUrl.host().isEmpty()) {
+    // Site URLs are always sent with a scheme
+    const auto siteQUrl = urlTools()->normalizeUrl(siteUrl);
+    if (!siteQUrl.hasScheme) {
         return false;
     }
 
     // Match port, if used
-    QUrl siteQUrl(siteUrl);
-    if (entryQUrl.port() > 0 && entryQUrl.port() != siteQUrl.port()) {
+    if (entryQUrl.port > 0 && entryQUrl.port != siteQUrl.port) {
         return false;
     }
 
-    // Match scheme
-    if (browserSettings()->matchUrlScheme() && !entryQUrl.scheme().isEmpty()
-        && entryQUrl.scheme().compare(siteQUrl.scheme()) != 0) {
-        return false;
+    // Match scheme, entry URLs without one default to https
+    if (browserSettings()->matchUrlScheme()) {
+        const auto entryScheme = entryQUrl.hasScheme ? entryQUrl.scheme : QStringLiteral("https");
+        if (!entryScheme.isEmpty() && entryScheme != siteQUrl.scheme) {
+            return false;
+        }
     }
 
     // Check for illegal characters
-    QRegularExpression re("[<>\\^`{|}]");
-    if (re.match(entryUrl).hasMatch()) {
+    if (entryQUrl.hasIllegalCharacters) {
         return false;
     }
 
     // Match the base domain
-    if (urlTools()->getBaseDomainFromUrl(siteQUrl.host()) != urlTools()->getBaseDomainFromUrl(entryQUrl.host())) {
+    if (siteQUrl.baseDomain != entryBaseDomain) {
         return false;
     }
 
     // Match the subdomains with the limited wildcard
-    if (siteQUrl.host().endsWith(entryQUrl.host())) {
+    if (siteQUrl.host.endsWith(entryHost)) {
         return true;
     }
 
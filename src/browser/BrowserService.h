@@ -59,6 +59,7 @@ struct EntryParameters
 class DatabaseWidget;
 class BrowserHost;
 class BrowserAction;
+class BrowserEntryIndex;
 
 class BrowserService : public QObject
 {
@@ -169,6 +170,7 @@ private:
                                 bool passkey = false);
     QList<Entry*>
     searchEntries(const QString& siteUrl, const QString& formUrl, const StringPairList& keyList, bool passkey = false);
+    BrowserEntryIndex* entryIndex(const QSharedPointer<Database>& db);
     QList<Entry*> sortEntries(QList<Entry*>& entries, const QString& siteUrl, const QString& formUrl);
     QList<Entry*> confirmEntries(QList<Entry*>& entriesToConfirm,
                                  const EntryParameters& entryParameters,
@@ -182,7 +184,6 @@ private:
     Access checkAccess(const Entry* entry, const QString& siteHost, const QString& formHost, const QString& realm);
     Group* getDefaultEntryGroup(const QSharedPointer<Database>& selectedDb = {});
     int sortPriority(const QStringList& urls, const QString& siteUrl, const QString& formUrl);
-    bool removeFirstDomain(QString& hostname);
     bool
     shouldIncludeEntry(Entry* entry, const QString& url, const QString& submitUrl, const bool omitWwwSubdomain = false);
 #ifdef WITH_XC_BROWSER_PASSKEYS
@@ -208,6 +209,7 @@ private:
 
     QPointer<BrowserHost> m_browserHost;
     QHash<QString, QSharedPointer<BrowserAction>> m_browserClients;
+    QHash<const Database*, QPointer<BrowserEntryIndex>> m_entryIndexes;
 
     bool m_dialogActive;
     bool m_bringToFrontRequested;
@@ -21,6 +21,7 @@
 
 #include <QDir>
 #include <QStandardPaths>
+#include <QtEndian>
 #if defined(KEEPASSXC_DIST_SNAP)
 #include <QProcessEnvironment>
 #endif
@@ -57,4 +58,55 @@ namespace BrowserShared
         return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverName;
 #endif
     }
+
+    /**
+     * Prefix a message with its length for the local socket.
+     *
+     * @param message message to send
+     * @return framed message
+     */
+    QByteArray frameMessage(const QByteArray& message)
+    {
+        QByteArray framed(NATIVEMSG_HEADER_LENGTH, '\0');
+        qToLittleEndian<quint32>(static_cast<quint32>(message.size()), framed.data());
+        framed.append(message);
+        return framed;
+    }
+
+    /**
+     * Check whether a receive buffer starts with a framed message.
+     *
+     * Older proxies and hosts send bare JSON documents. JSON text never contains
+     * a NUL byte, while the most significant byte of a length prefix is zero for
+     * any message below 16 MiB, which tells both apart.
+     *
+     * @param buffer received bytes, at least NATIVEMSG_HEADER_LENGTH
+     * @return true if the buffer starts with a framed message
+     */
+    bool isFramedMessage(const QByteArray& buffer)
+    {
+        Q_ASSERT(buffer.size() >= NATIVEMSG_HEADER_LENGTH);
+        return buffer.at(NATIVEMSG_HEADER_LENGTH - 1) == '\0';
+    }
+
+    /**
+     * Remove the first complete framed message from a receive buffer.
+     *
+     * @param buffer received bytes, the message is removed from it
+     * @param message set to the message payload
+     * @return true if a complete message was available
+     */
+    bool takeFramedMessage(QByteArray& buffer, QByteArray& message)
+    {
+        if (buffer.size() < NATIVEMSG_HEADER_LENGTH) {
+            return false;
+        }
+        const auto length = qFromLittleEndian<quint32>(buffer.constData());
+        if (static_cast<quint64>(buffer.size()) < NATIVEMSG_HEADER_LENGTH + static_cast<quint64>(length)) {
+            return false;
+        }
+        message = buffer.mid(NATIVEMSG_HEADER_LENGTH, static_cast<int>(length));
+        buffer.remove(0, NATIVEMSG_HEADER_LENGTH + static_cast<int>(length));
+        return true;
+    }
 } // namespace BrowserShared
@@ -18,11 +18,15 @@
 #ifndef KEEPASSXC_BROWSERSHARED_H
 #define KEEPASSXC_BROWSERSHARED_H
 
+#include <QByteArray>
 #include <QString>
 
 namespace BrowserShared
 {
     constexpr int NATIVEMSG_MAX_LENGTH = 1024 * 1024;
+    // Messages on the local socket are prefixed with their length as a little-endian quint32
+    constexpr int NATIVEMSG_HEADER_LENGTH = 4;
+    constexpr int NATIVEMSG_MAX_FRAMED_LENGTH = 16 * 1024 * 1024 - 1;
 
     enum SupportedBrowsers : int
     {
@@ -38,6 +42,10 @@ namespace BrowserShared
     };
 
     QString localServerPath();
+
+    QByteArray frameMessage(const QByteArray& message);
+    bool isFramedMessage(const QByteArray& buffer);
+    bool takeFramedMessage(QByteArray& buffer, QByteArray& message);
 } // namespace BrowserShared
 
 #endif // KEEPASSXC_BROWSERSHARED_H
@@ -95,7 +95,7 @@ int PasskeyUtils::getEffectiveDomain(const QString& origin, QString* result) con
         return ERROR_PASSKEYS_ORIGIN_NOT_ALLOWED;
     }
 
-    const auto effectiveDomain = QUrl::fromUserInput(origin).host();
+    const auto effectiveDomain = urlTools()->normalizeUrl(origin).host;
     if (!isDomain(effectiveDomain)) {
         return ERROR_PASSKEYS_DOMAIN_IS_NOT_VALID;
     }
@@ -218,7 +218,7 @@ bool PasskeyUtils::isRegistrableDomainSuffix(const QString& hostSuffixString, co
         return false;
     }
 
-    const auto hostSuffix = QUrl::fromUserInput(hostSuffixString).host();
+    const auto hostSuffix = urlTools()->normalizeUrl(hostSuffixString).host;
     if (hostSuffix == originalHost) {
         return true;
     }
@@ -254,7 +254,7 @@ bool PasskeyUtils::isRegistrableDomainSuffix(const QString& hostSuffixString, co
 
 bool PasskeyUtils::isDomain(const QString& hostName) const
 {
-    const auto domain = QUrl::fromUserInput(hostName).host();
+    const auto domain = urlTools()->normalizeUrl(hostName).host;
     return !domain.isEmpty() && !domain.endsWith('.') && Tools::isAsciiString(domain)
            && !urlTools()->domainHasIllegalCharacters(domain) && !urlTools()->isIpAddress(hostName);
 }
@@ -277,7 +277,7 @@ bool PasskeyUtils::isOriginAllowedWithLocalhost(bool allowLocalhostWithPasskeys,
         return false;
     }
 
-    const auto host = QUrl::fromUserInput(origin).host();
+    const auto host = urlTools()->normalizeUrl(origin).host;
     return host == "localhost" || host == "localhost." || host.endsWith(".localhost") || host.endsWith(".localhost.");
 }
 
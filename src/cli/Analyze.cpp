@@ -29,20 +29,14 @@ const QCommandLineOption Analyze::HIBPDatabaseOption = QCommandLineOption(
     {"H", "hibp"},
     QObject::tr("Check if any passwords have been publicly leaked. FILENAME must be the path of a file listing "
                 "SHA-1 hashes of leaked passwords in HIBP format, as available from "
-                "https://haveibeenpwned.com/Passwords."),
+                "https://haveibeenpwned.com/Passwords, or an index built from it with the hibp-index command."),
     QObject::tr("FILENAME"));
 
-const QCommandLineOption Analyze::OkonOption =
-    QCommandLineOption("okon",
-                       QObject::tr("Path to okon-cli to search a formatted HIBP file"),
-                       QObject::tr("okon-cli"));
-
 Analyze::Analyze()
 {
     name = QString("analyze");
     description = QObject::tr("Analyze passwords for weaknesses and problems.");
     options.append(Analyze::HIBPDatabaseOption);
-    options.append(Analyze::OkonOption);
 }
 
 int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
@@ -59,28 +53,18 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
         return EXIT_FAILURE;
     }
 
-    auto okon = parser->value(Analyze::OkonOption);
-    if (!okon.isEmpty()) {
-        out << QObject::tr("Evaluating database entries using okon…") << Qt::endl;
-
-        if (!HibpOffline::okonReport(database, okon, hibpDatabase, findings, &error)) {
-            err << error << Qt::endl;
-            return EXIT_FAILURE;
-        }
-    } else {
-        QFile hibpFile(hibpDatabase);
-        if (!hibpFile.open(QFile::ReadOnly)) {
-            err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString())
-                << Qt::endl;
-            return EXIT_FAILURE;
-        }
+    QFile hibpFile(hibpDatabase);
+    if (!hibpFile.open(QFile::ReadOnly)) {
+        err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString())
+            << Qt::endl;
+        return EXIT_FAILURE;
+    }
 
-        out << QObject::tr("Evaluating database entries against HIBP file, this will take a while…") << Qt::endl;
+    out << QObject::tr("Evaluating database entries against HIBP file…") << Qt::endl;
 
-        if (!HibpOffline::report(database, hibpFile, findings, &error)) {
-            err << error << Qt::endl;
-            return EXIT_FAILURE;
-        }
+    if (!HibpOffline::report(database, hibpFile, findings, &error)) {
+        err << error << Qt::endl;
+        return EXIT_FAILURE;
     }
 
     for (const auto& finding : findings) {
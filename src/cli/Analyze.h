@@ -27,7 +27,6 @@ public:
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
 
     static const QCommandLineOption HIBPDatabaseOption;
-    static const QCommandLineOption OkonOption;
 };
 
 #endif // KEEPASSXC_HIBP_H
@@ -62,9 +62,15 @@ int AttachmentExport::executeWithDatabase(QSharedPointer<Database> database, QSh
         return EXIT_FAILURE;
     }
 
+    QByteArray attachmentData;
+    if (!attachments->readValue(attachmentName, attachmentData)) {
+        err << QObject::tr("Could not read attachment with name %1.").arg(attachmentName) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
     if (parser->isSet(AttachmentExport::StdoutOption)) {
         // Output to STDOUT even in quiet mode
-        Utils::STDOUT << attachments->value(attachmentName) << Qt::flush;
+        Utils::STDOUT << attachmentData << Qt::flush;
         return EXIT_SUCCESS;
     }
 
@@ -79,7 +85,7 @@ int AttachmentExport::executeWithDatabase(QSharedPointer<Database> database, QSh
         err << QObject::tr("Could not open output file %1.").arg(exportFileName) << Qt::endl;
         return EXIT_FAILURE;
     }
-    exportFile.write(attachments->value(attachmentName));
+    exportFile.write(attachmentData);
 
     out << QObject::tr("Successfully exported attachment %1 of entry %2 to %3.")
                .arg(attachmentName, entryPath, exportFileName)
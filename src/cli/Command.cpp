@@ -33,6 +33,7 @@
 #include "Export.h"
 #include "Generate.h"
 #include "Help.h"
+#include "HibpIndex.h"
 #include "Import.h"
 #include "List.h"
 #include "Merge.h"
@@ -176,6 +177,7 @@ namespace Commands
         s_commands.insert(QStringLiteral("estimate"), QSharedPointer<Command>(new Estimate()));
         s_commands.insert(QStringLiteral("generate"), QSharedPointer<Command>(new Generate()));
         s_commands.insert(QStringLiteral("help"), QSharedPointer<Command>(new Help()));
+        s_commands.insert(QStringLiteral("hibp-index"), QSharedPointer<Command>(new HibpIndex()));
         s_commands.insert(QStringLiteral("ls"), QSharedPointer<Command>(new List()));
         s_commands.insert(QStringLiteral("merge"), QSharedPointer<Command>(new Merge()));
         s_commands.insert(QStringLiteral("mkdir"), QSharedPointer<Command>(new AddGroup()));
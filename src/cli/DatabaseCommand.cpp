@@ -60,7 +60,8 @@ int DatabaseCommand::execute(const QStringList& arguments)
 #else
                                    "",
 #endif
-                                   parser->isSet(Command::QuietOption));
+                                   parser->isSet(Command::QuietOption),
+                                   readOptions(parser));
         if (!db) {
             return EXIT_FAILURE;
         }
@@ -68,3 +69,14 @@ int DatabaseCommand::execute(const QStringList& arguments)
 
     return executeWithDatabase(db, parser);
 }
+
+/**
+ * Parts of the database the command does not need. They are skipped when the
+ * database is opened for a single command, which makes read-only commands on
+ * large databases faster. The interactive mode always opens the full database.
+ */
+KeePass2::ReadOptions DatabaseCommand::readOptions(QSharedPointer<QCommandLineParser> parser) const
+{
+    Q_UNUSED(parser);
+    return KeePass2::ReadAll;
+}
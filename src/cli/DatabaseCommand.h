@@ -26,6 +26,9 @@ public:
     DatabaseCommand();
     int execute(const QStringList& arguments) override;
     virtual int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) = 0;
+
+protected:
+    virtual KeePass2::ReadOptions readOptions(QSharedPointer<QCommandLineParser> parser) const;
 };
 
 #endif // KEEPASSXC_DATABASECOMMAND_H
@@ -72,3 +72,8 @@ int DatabaseInfo::executeWithDatabase(QSharedPointer<Database> database, QShared
 
     return EXIT_SUCCESS;
 }
+
+KeePass2::ReadOptions DatabaseInfo::readOptions(QSharedPointer<QCommandLineParser>) const
+{
+    return KeePass2::SkipAll;
+}
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HibpIndex.h"
+
+#include "Utils.h"
+#include "core/Global.h"
+#include "core/HibpOffline.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QSaveFile>
+
+const QCommandLineOption HibpIndex::HashBytesOption =
+    QCommandLineOption(QStringList() << "b" << "hash-bytes",
+                       QObject::tr("Number of bytes of each SHA-1 hash to store, between 6 and 20. Shorter hashes "
+                                   "make the index smaller but may report false matches.\n[Default: 20]"),
+                       QObject::tr("bytes", "CLI parameter"));
+
+HibpIndex::HibpIndex()
+{
+    name = QString("hibp-index");
+    description = QObject::tr("Build a compact binary index from a HIBP file for use with analyze.");
+    positionalArguments.append({QString("hibp"), QObject::tr("Path of the HIBP file, ordered by hash."), QString("")});
+    positionalArguments.append({QString("index"), QObject::tr("Path of the index file to create."), QString("")});
+    options.append(HibpIndex::HashBytesOption);
+}
+
+int HibpIndex::execute(const QStringList& arguments)
+{
+    QSharedPointer<QCommandLineParser> parser = getCommandLineParser(arguments);
+    if (parser.isNull()) {
+        return EXIT_FAILURE;
+    }
+
+    auto& out = Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    const QString& hibpPath = args.at(0);
+    const QString& indexPath = args.at(1);
+
+    int hashBytes = 20;
+    if (parser->isSet(HibpIndex::HashBytesOption)) {
+        bool ok = false;
+        hashBytes = parser->value(HibpIndex::HashBytesOption).toInt(&ok);
+        if (!ok) {
+            err << QObject::tr("Invalid hash length %1").arg(parser->value(HibpIndex::HashBytesOption)) << Qt::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    QFile hibpFile(hibpPath);
+    if (!hibpFile.open(QFile::ReadOnly)) {
+        err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpPath, hibpFile.errorString()) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    QSaveFile indexFile(indexPath);
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        err << QObject::tr("Failed to open index file %1: %2").arg(indexPath, indexFile.errorString()) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Building HIBP index, this will take a while…") << Qt::endl;
+
+    QString error;
+    if (!HibpOffline::buildIndex(hibpFile, indexFile, hashBytes, &error)) {
+        err << error << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!indexFile.commit()) {
+        err << QObject::tr("Failed to write index file %1: %2").arg(indexPath, indexFile.errorString()) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Successfully built HIBP index %1.").arg(indexPath) << Qt::endl;
+    return EXIT_SUCCESS;
+}
@@ -64,3 +64,8 @@ int List::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
     out << group->print(recursive, flatten) << Qt::flush;
     return EXIT_SUCCESS;
 }
+
+KeePass2::ReadOptions List::readOptions(QSharedPointer<QCommandLineParser>) const
+{
+    return KeePass2::SkipAll;
+}
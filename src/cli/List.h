@@ -29,6 +29,9 @@ public:
 
     static const QCommandLineOption RecursiveOption;
     static const QCommandLineOption FlattenOption;
+
+protected:
+    KeePass2::ReadOptions readOptions(QSharedPointer<QCommandLineParser> parser) const override;
 };
 
 #endif // KEEPASSXC_LIST_H
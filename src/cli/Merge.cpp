@@ -87,7 +87,15 @@ int Merge::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer
     }
 
     Merger merger(db2.data(), database.data());
-    QStringList changeList = merger.merge();
+    QStringList changeList;
+    if (parser->isSet(Merge::DryRunOption)) {
+        // Only plan the merge, the database is left untouched
+        for (const auto& change : merger.plan()) {
+            changeList << change.description;
+        }
+    } else {
+        changeList = merger.merge();
+    }
 
     for (auto& mergeChange : changeList) {
         out << "\t" << mergeChange << Qt::endl;
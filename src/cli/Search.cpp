@@ -50,3 +50,9 @@ int Search::executeWithDatabase(QSharedPointer<Database> database, QSharedPointe
     }
     return EXIT_SUCCESS;
 }
+
+KeePass2::ReadOptions Search::readOptions(QSharedPointer<QCommandLineParser>) const
+{
+    // Attachment names can be searched for
+    return KeePass2::SkipHistory | KeePass2::SkipCustomIcons;
+}
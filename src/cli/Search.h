@@ -26,6 +26,9 @@ public:
     Search();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+
+protected:
+    KeePass2::ReadOptions readOptions(QSharedPointer<QCommandLineParser> parser) const override;
 };
 
 #endif // KEEPASSXC_SEARCH_H
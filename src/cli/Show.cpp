@@ -162,3 +162,11 @@ int Show::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
 
     return encounteredError ? EXIT_FAILURE : EXIT_SUCCESS;
 }
+
+KeePass2::ReadOptions Show::readOptions(QSharedPointer<QCommandLineParser> parser) const
+{
+    if (parser->isSet(Show::AttachmentsOption)) {
+        return KeePass2::SkipHistory | KeePass2::SkipCustomIcons;
+    }
+    return KeePass2::SkipAll;
+}
@@ -32,6 +32,9 @@ public:
     static const QCommandLineOption AttributesOption;
     static const QCommandLineOption ProtectedAttributesOption;
     static const QCommandLineOption AttachmentsOption;
+
+protected:
+    KeePass2::ReadOptions readOptions(QSharedPointer<QCommandLineParser> parser) const override;
 };
 
 #endif // KEEPASSXC_SHOW_H
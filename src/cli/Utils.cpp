@@ -105,7 +105,8 @@ namespace Utils
                                             bool isPasswordProtected,
                                             const QString& keyFilename,
                                             const QString& yubiKeySlot,
-                                            bool quiet)
+                                            bool quiet,
+                                            KeePass2::ReadOptions readOptions)
     {
         auto& err = quiet ? DEVNULL : STDERR;
         auto compositeKey = QSharedPointer<CompositeKey>::create();
@@ -191,7 +192,7 @@ namespace Utils
 
         auto db = QSharedPointer<Database>::create();
         QString error;
-        if (db->open(databaseFilename, compositeKey, &error)) {
+        if (db->open(databaseFilename, compositeKey, &error, readOptions)) {
             return db;
         } else {
             err << error << Qt::endl;
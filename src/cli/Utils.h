@@ -18,6 +18,8 @@
 #ifndef KEEPASSXC_UTILS_H
 #define KEEPASSXC_UTILS_H
 
+#include "format/KeePass2.h"
+
 #include <QTextStream>
 
 class CompositeKey;
@@ -49,7 +51,8 @@ namespace Utils
                                             bool isPasswordProtected = true,
                                             const QString& keyFilename = {},
                                             const QString& yubiKeySlot = {},
-                                            bool quiet = false);
+                                            bool quiet = false,
+                                            KeePass2::ReadOptions readOptions = KeePass2::ReadAll);
 
     QStringList splitCommandString(const QString& command);
 
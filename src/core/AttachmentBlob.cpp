@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttachmentBlob.h"
+
+#include "crypto/CryptoHash.h"
+
+AttachmentBlob::AttachmentBlob(QByteArray data)
+    : m_data(std::move(data))
+    , m_size(m_data.size())
+{
+    auto spillFile = AttachmentSpillFile::instance();
+    const int threshold = spillFile->threshold();
+    if (threshold <= 0 || m_size < threshold || !spillFile->write(m_data, m_spillRegion)) {
+        return;
+    }
+
+    // The plain content is at hand only now, so compute the digest right away
+    std::call_once(m_digestFlag, [this] { m_digest = CryptoHash::hash(m_data, CryptoHash::Sha256); });
+    m_spillFile = spillFile;
+    m_data.clear();
+}
+
+AttachmentBlob::~AttachmentBlob()
+{
+    if (m_spillFile) {
+        m_spillFile->release(m_spillRegion);
+    }
+}
+
+QSharedPointer<const AttachmentBlob> AttachmentBlob::create(const QByteArray& data)
+{
+    return QSharedPointer<const AttachmentBlob>::create(data);
+}
+
+/**
+ * Content of the blob, empty if it was spilled and can not be read back.
+ * Use readData() wherever such a failure has to be reported.
+ */
+QByteArray AttachmentBlob::data() const
+{
+    QByteArray data;
+    readData(data);
+    return data;
+}
+
+/**
+ * @param data content of the blob
+ * @return false if the spilled content could not be read back or does not match its digest
+ */
+bool AttachmentBlob::readData(QByteArray& data) const
+{
+    if (m_spillFile) {
+        if (!m_spillFile->read(m_spillRegion, data)) {
+            return false;
+        }
+        // The spill file is not authenticated, make sure it was not modified behind our back
+        if (CryptoHash::hash(data, CryptoHash::Sha256) != m_digest) {
+            qWarning("AttachmentBlob: spilled attachment content does not match its digest");
+            data.clear();
+            return false;
+        }
+        return true;
+    }
+    data = m_data;
+    return true;
+}
+
+int AttachmentBlob::size() const
+{
+    return m_size;
+}
+
+/**
+ * SHA-256 digest of the content, computed on first use.
+ */
+QByteArray AttachmentBlob::digest() const
+{
+    std::call_once(m_digestFlag, [this] { m_digest = CryptoHash::hash(m_data, CryptoHash::Sha256); });
+    return m_digest;
+}
+
+bool AttachmentBlob::isSpilled() const
+{
+    return !m_spillFile.isNull();
+}
+
+/**
+ * Compare the content of two blobs, spilled blobs are compared by their digest to avoid decrypting them.
+ */
+bool AttachmentBlob::contentEquals(const AttachmentBlob& other) const
+{
+    if (this == &other) {
+        return true;
+    }
+    if (m_size != other.m_size) {
+        return false;
+    }
+    if (isSpilled() || other.isSpilled()) {
+        return digest() == other.digest();
+    }
+    return m_data == other.m_data;
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ATTACHMENTBLOB_H
+#define KEEPASSXC_ATTACHMENTBLOB_H
+
+#include "core/AttachmentSpillFile.h"
+
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <mutex>
+
+/**
+ * Immutable content of an attachment.
+ *
+ * Blobs are reference counted and shared by all attachments with the same
+ * origin, e.g. an entry and its history items or all entries referencing the
+ * same binary of a database file. The SHA-256 digest of the content is only
+ * computed once per blob and reused for deduplication on every save.
+ *
+ * Content of at least AttachmentSpillFile::threshold() bytes is moved to the
+ * encrypted spill file and only decrypted when it is accessed.
+ */
+class AttachmentBlob
+{
+public:
+    explicit AttachmentBlob(QByteArray data);
+    ~AttachmentBlob();
+
+    static QSharedPointer<const AttachmentBlob> create(const QByteArray& data);
+
+    QByteArray data() const;
+    bool readData(QByteArray& data) const;
+    int size() const;
+    QByteArray digest() const;
+    bool isSpilled() const;
+    bool contentEquals(const AttachmentBlob& other) const;
+
+private:
+    Q_DISABLE_COPY(AttachmentBlob)
+
+    QByteArray m_data;
+    int m_size;
+    QSharedPointer<AttachmentSpillFile> m_spillFile;
+    AttachmentSpillFile::Region m_spillRegion;
+    mutable QByteArray m_digest;
+    mutable std::once_flag m_digestFlag;
+};
+
+#endif // KEEPASSXC_ATTACHMENTBLOB_H
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttachmentSpillFile.h"
+
+#include "crypto/Random.h"
+#include "crypto/SymmetricCipher.h"
+
+const int AttachmentSpillFile::DefaultThreshold = 256 * 1024;
+const int AttachmentSpillFile::MaxCacheSizeKiB = 32 * 1024;
+
+AttachmentSpillFile::AttachmentSpillFile()
+    : m_key(randomGen()->randomArray(SymmetricCipher::keySize(SymmetricCipher::ChaCha20)))
+    , m_threshold(DefaultThreshold)
+{
+    m_cache.setMaxCost(MaxCacheSizeKiB);
+}
+
+/**
+ * Spilled blobs keep a reference to the file, so it is only removed once
+ * the last of them is gone.
+ */
+QSharedPointer<AttachmentSpillFile> AttachmentSpillFile::instance()
+{
+    static const QSharedPointer<AttachmentSpillFile> spillFile(new AttachmentSpillFile());
+    return spillFile;
+}
+
+/**
+ * Minimum attachment size in bytes to move it out of memory, 0 keeps all attachments in memory.
+ */
+int AttachmentSpillFile::threshold() const
+{
+    return m_threshold.loadAcquire();
+}
+
+void AttachmentSpillFile::setThreshold(int threshold)
+{
+    m_threshold.storeRelease(threshold);
+}
+
+/**
+ * Encrypt data and store it in the spill file.
+ *
+ * @param data attachment content
+ * @param region location of the encrypted data, only valid on success
+ * @return false if the data could not be written, it has to be kept in memory then
+ */
+bool AttachmentSpillFile::write(const QByteArray& data, Region& region)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_file.isOpen() && (!m_file.open() || !m_file.setPermissions(QFile::ReadOwner | QFile::WriteOwner))) {
+        qWarning("AttachmentSpillFile: unable to create spill file: %s", qPrintable(m_file.errorString()));
+        return false;
+    }
+
+    QByteArray encrypted(data);
+    const QByteArray iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(SymmetricCipher::ChaCha20));
+    if (!crypt(encrypted, iv)) {
+        return false;
+    }
+
+    const qint64 offset = allocate(encrypted.size());
+    if (!m_file.seek(offset) || m_file.write(encrypted) != encrypted.size() || !m_file.flush()) {
+        qWarning("AttachmentSpillFile: unable to write spill file: %s", qPrintable(m_file.errorString()));
+        deallocate(offset, encrypted.size());
+        return false;
+    }
+
+    region.offset = offset;
+    region.size = data.size();
+    region.iv = iv;
+    return true;
+}
+
+/**
+ * Decrypt a region of the spill file.
+ *
+ * @param region location of the encrypted data
+ * @param data decrypted content, empty on failure
+ * @return false if the region could not be read back
+ */
+bool AttachmentSpillFile::read(const Region& region, QByteArray& data)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (const auto cached = m_cache.object(region.offset)) {
+        data = *cached;
+        return true;
+    }
+
+    data.clear();
+    uchar* mapped = m_file.map(region.offset, region.size);
+    if (mapped) {
+        data = QByteArray(reinterpret_cast<const char*>(mapped), region.size);
+        m_file.unmap(mapped);
+    } else if (m_file.seek(region.offset)) {
+        data = m_file.read(region.size);
+    }
+
+    if (data.size() != region.size || !crypt(data, region.iv)) {
+        qWarning("AttachmentSpillFile: unable to read spill file: %s", qPrintable(m_file.errorString()));
+        data.clear();
+        return false;
+    }
+
+    m_cache.insert(region.offset, new QByteArray(data), qMax(1, region.size / 1024));
+    return true;
+}
+
+/**
+ * Forget a region that is no longer referenced, its space is reused by later writes.
+ */
+void AttachmentSpillFile::release(const Region& region)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_cache.remove(region.offset);
+    deallocate(region.offset, region.size);
+}
+
+bool AttachmentSpillFile::crypt(QByteArray& data, const QByteArray& iv)
+{
+    SymmetricCipher cipher;
+    if (!cipher.init(SymmetricCipher::ChaCha20, SymmetricCipher::Encrypt, m_key, iv) || !cipher.process(data)) {
+        qWarning("AttachmentSpillFile: %s", qPrintable(cipher.errorString()));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Find space for a new region, the first unused gap large enough or the end of the file.
+ * Must be called with m_mutex locked.
+ */
+qint64 AttachmentSpillFile::allocate(qint64 size)
+{
+    for (auto it = m_freeSpace.begin(); it != m_freeSpace.end(); ++it) {
+        if (it.value() < size) {
+            continue;
+        }
+        const qint64 offset = it.key();
+        const qint64 remaining = it.value() - size;
+        m_freeSpace.erase(it);
+        if (remaining > 0) {
+            m_freeSpace.insert(offset + size, remaining);
+        }
+        return offset;
+    }
+    return m_file.size();
+}
+
+/**
+ * Give back the space of a region, merged with the unused space around it.
+ * Must be called with m_mutex locked.
+ */
+void AttachmentSpillFile::deallocate(qint64 offset, qint64 size)
+{
+    auto next = m_freeSpace.find(offset + size);
+    if (next != m_freeSpace.end()) {
+        size += next.value();
+        m_freeSpace.erase(next);
+    }
+
+    auto previous = m_freeSpace.lowerBound(offset);
+    if (previous != m_freeSpace.begin()) {
+        --previous;
+        if (previous.key() + previous.value() == offset) {
+            offset = previous.key();
+            size += previous.value();
+            m_freeSpace.erase(previous);
+        }
+    }
+
+    if (offset + size >= m_file.size()) {
+        // Nothing is stored behind this space, shrink the file instead
+        m_file.resize(offset);
+    } else {
+        m_freeSpace.insert(offset, size);
+    }
+}
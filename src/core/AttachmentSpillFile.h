@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ATTACHMENTSPILLFILE_H
+#define KEEPASSXC_ATTACHMENTSPILLFILE_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QCache>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QTemporaryFile>
+
+/**
+ * Encrypted temporary file holding the content of large attachments, so
+ * they do not need to stay in memory while a database is open.
+ *
+ * Every region is encrypted with a random key that only exists in memory for
+ * the current session. Recently read regions are kept decrypted in a small
+ * cache, everything else is decrypted from the memory mapped file on demand.
+ * The space of released regions is reused by later writes, released space
+ * at the end of the file is cut off right away.
+ */
+class AttachmentSpillFile
+{
+public:
+    struct Region
+    {
+        qint64 offset = -1;
+        int size = 0;
+        QByteArray iv;
+    };
+
+    static QSharedPointer<AttachmentSpillFile> instance();
+
+    int threshold() const;
+    void setThreshold(int threshold);
+
+    bool write(const QByteArray& data, Region& region);
+    bool read(const Region& region, QByteArray& data);
+    void release(const Region& region);
+
+    static const int DefaultThreshold;
+    static const int MaxCacheSizeKiB;
+
+private:
+    AttachmentSpillFile();
+    Q_DISABLE_COPY(AttachmentSpillFile)
+
+    bool crypt(QByteArray& data, const QByteArray& iv);
+    qint64 allocate(qint64 size);
+    void deallocate(qint64 offset, qint64 size);
+
+    QMutex m_mutex;
+    QTemporaryFile m_file;
+    QByteArray m_key;
+    // Read by any thread creating a blob, without taking the mutex
+    QAtomicInt m_threshold;
+    // Unused space between the regions, size by offset
+    QMap<qint64, qint64> m_freeSpace;
+    QCache<qint64, QByteArray> m_cache;
+};
+
+#endif // KEEPASSXC_ATTACHMENTSPILLFILE_H
@@ -65,6 +65,10 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
     {Config::UseAtomicSaves,{QS("UseAtomicSaves"), Roaming, true}},
     {Config::UseDirectWriteSaves,{QS("UseDirectWriteSaves"), Local, false}},
     {Config::SearchLimitGroup,{QS("SearchLimitGroup"), Roaming, false}},
+    {Config::SearchIndex,{QS("SearchIndex"), Local, false}},
+    {Config::SearchIndexProtected,{QS("SearchIndexProtected"), Local, false}},
+    {Config::SearchThreadCount,{QS("SearchThreadCount"), Local, 0}},
+    {Config::PasswordHealthService,{QS("PasswordHealthService"), Local, true}},
     {Config::MinimizeOnOpenUrl,{QS("MinimizeOnOpenUrl"), Roaming, false}},
     {Config::OpenURLOnDoubleClick, {QS("OpenURLOnDoubleClick"), Roaming, true}},
     {Config::HideWindowOnCopy,{QS("HideWindowOnCopy"), Roaming, false}},
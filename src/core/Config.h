@@ -48,6 +48,10 @@ public:
         UseAtomicSaves,
         UseDirectWriteSaves,
         SearchLimitGroup,
+        SearchIndex,
+        SearchIndexProtected,
+        SearchThreadCount,
+        PasswordHealthService,
         MinimizeOnOpenUrl,
         OpenURLOnDoubleClick,
         HideWindowOnCopy,
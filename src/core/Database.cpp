@@ -19,8 +19,11 @@
 #include "Database.h"
 
 #include "core/AsyncTask.h"
+#include "core/DatabasePatcher.h"
+#include "core/EntrySearchIndex.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
+#include "core/PasswordHealthService.h"
 #include "crypto/Random.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
@@ -120,12 +123,19 @@ bool Database::open(QSharedPointer<const CompositeKey> key, QString* error)
  *
  * If key is provided as null, only headers will be read.
  *
+ * Parts of the database can be skipped with readOptions to speed up read-only
+ * access, such a partially loaded database cannot be saved.
+ *
  * @param filePath path to the file
  * @param key composite key for unlocking the database
  * @param error error message in case of failure
+ * @param readOptions parts of the database to leave out
  * @return true on success
  */
-bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error)
+bool Database::open(const QString& filePath,
+                    QSharedPointer<const CompositeKey> key,
+                    QString* error,
+                    KeePass2::ReadOptions readOptions)
 {
     QFile dbFile(filePath);
     if (!dbFile.exists()) {
@@ -152,6 +162,7 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
     setEmitModified(false);
 
     KeePass2Reader reader;
+    reader.setReadOptions(readOptions);
     if (!reader.readDatabase(&dbFile, std::move(key), this)) {
         if (error) {
             *error = tr("Error while reading the database: %1").arg(reader.errorString());
@@ -159,6 +170,7 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
         return false;
     }
 
+    m_data.readOptions = readOptions;
     setFilePath(filePath);
     dbFile.close();
 
@@ -260,6 +272,14 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
         return false;
     }
 
+    // Saving would drop everything that was skipped while reading
+    if (isPartiallyLoaded()) {
+        if (error) {
+            *error = tr("Could not save, database has only been partially loaded.");
+        }
+        return false;
+    }
+
     if (filePath == m_data.filePath) {
         // Fail-safe check to make sure we don't overwrite underlying file changes
         // that have not yet triggered a file reload/merge operation.
@@ -278,6 +298,9 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     int length = Random::instance()->randomUIntRange(64, 512);
     m_metadata->customData()->set(CustomData::RandomSlug, Random::instance()->randomArray(length).toHex());
 
+    // Drop duplicate and expired deleted object records
+    compactDeletedObjects();
+
     // Prevent destructive operations while saving
     QMutexLocker locker(&m_saveMutex);
 
@@ -506,6 +529,7 @@ void Database::releaseData()
     m_fileWatcher->stop();
 
     m_deletedObjects.clear();
+    m_deletedObjectUuids.clear();
     m_commonUsernames.clear();
     m_tagList.clear();
 }
@@ -566,6 +590,14 @@ bool Database::isInitialized() const
     return m_data.key && !m_data.key->isEmpty() && m_rootGroup;
 }
 
+/**
+ * @return true if parts of the database were skipped when it was opened
+ */
+bool Database::isPartiallyLoaded() const
+{
+    return m_data.readOptions != KeePass2::ReadAll;
+}
+
 Group* Database::rootGroup()
 {
     return m_rootGroup;
@@ -590,6 +622,10 @@ Group* Database::setRootGroup(Group* group)
     }
 
     auto oldRoot = m_rootGroup;
+    if (oldRoot) {
+        unregisterGroupRecursive(oldRoot);
+    }
+
     m_rootGroup = group;
     m_rootGroup->setParent(this);
 
@@ -602,6 +638,108 @@ Group* Database::setRootGroup(Group* group)
     return oldRoot;
 }
 
+void Database::registerEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    invalidatePlaceholders(entry);
+    if (m_searchIndex) {
+        m_searchIndex->addEntry(entry);
+    }
+    if (m_passwordHealthService) {
+        m_passwordHealthService->addEntry(entry);
+    }
+
+    // Entries without an uuid can never be looked up
+    if (!entry->uuid().isNull() && !m_entryUuidIndex.contains(entry->uuid(), entry)) {
+        m_entryUuidIndex.insert(entry->uuid(), entry);
+    }
+
+    emit entryRegistered(entry);
+}
+
+void Database::registerGroup(Group* group)
+{
+    Q_ASSERT(group);
+    if (!m_groupUuidIndex.contains(group->uuid(), group)) {
+        m_groupUuidIndex.insert(group->uuid(), group);
+    }
+}
+
+void Database::unregisterEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    invalidatePlaceholders(entry);
+    if (m_searchIndex) {
+        m_searchIndex->removeEntry(entry);
+    }
+    if (m_passwordHealthService) {
+        m_passwordHealthService->removeEntry(entry);
+    }
+
+    if (!entry->uuid().isNull()) {
+        m_entryUuidIndex.remove(entry->uuid(), entry);
+    }
+
+    emit entryUnregistered(entry);
+}
+
+void Database::unregisterGroup(Group* group)
+{
+    Q_ASSERT(group);
+    m_groupUuidIndex.remove(group->uuid(), group);
+}
+
+void Database::unregisterGroupRecursive(Group* group)
+{
+    for (auto child : group->groupsRecursive(true)) {
+        unregisterGroup(child);
+        for (auto entry : child->entries()) {
+            unregisterEntry(entry);
+        }
+    }
+}
+
+/**
+ * Record that the cached placeholder values of an entry were resolved
+ * using the given referenced entries.
+ */
+void Database::addPlaceholderReferences(const Entry* entry, const QSet<const Entry*>& references)
+{
+    QMutexLocker locker(&m_placeholderMutex);
+    m_placeholderReferences[entry].unite(references);
+    for (auto reference : references) {
+        m_placeholderDependents[reference].insert(entry);
+    }
+}
+
+/**
+ * Drop the cached placeholder values of an entry and, transitively,
+ * of every entry whose cached values were resolved through it.
+ */
+void Database::invalidatePlaceholders(const Entry* entry)
+{
+    QMutexLocker locker(&m_placeholderMutex);
+
+    QList<const Entry*> pending{entry};
+    while (!pending.isEmpty()) {
+        auto current = pending.takeLast();
+        current->clearPlaceholderCache();
+
+        // Its references are recorded again on the next resolution
+        for (auto reference : m_placeholderReferences.take(current)) {
+            auto it = m_placeholderDependents.find(reference);
+            if (it != m_placeholderDependents.end()) {
+                it->remove(current);
+                if (it->isEmpty()) {
+                    m_placeholderDependents.erase(it);
+                }
+            }
+        }
+
+        pending.append(m_placeholderDependents.take(current).values());
+    }
+}
+
 Metadata* Database::metadata()
 {
     return m_metadata;
@@ -660,22 +798,12 @@ const QList<DeletedObject>& Database::deletedObjects() const
 
 bool Database::containsDeletedObject(const QUuid& uuid) const
 {
-    for (const DeletedObject& currentObject : m_deletedObjects) {
-        if (currentObject.uuid == uuid) {
-            return true;
-        }
-    }
-    return false;
+    return m_deletedObjectUuids.contains(uuid);
 }
 
 bool Database::containsDeletedObject(const DeletedObject& object) const
 {
-    for (const DeletedObject& currentObject : m_deletedObjects) {
-        if (currentObject.uuid == object.uuid) {
-            return true;
-        }
-    }
-    return false;
+    return m_deletedObjectUuids.contains(object.uuid);
 }
 
 void Database::setDeletedObjects(const QList<DeletedObject>& delObjs)
@@ -684,12 +812,18 @@ void Database::setDeletedObjects(const QList<DeletedObject>& delObjs)
         return;
     }
     m_deletedObjects = delObjs;
+    m_deletedObjectUuids.clear();
+    m_deletedObjectUuids.reserve(m_deletedObjects.size());
+    for (const auto& object : asConst(m_deletedObjects)) {
+        m_deletedObjectUuids.insert(object.uuid);
+    }
 }
 
 void Database::addDeletedObject(const DeletedObject& delObj)
 {
     Q_ASSERT(delObj.deletionTime.timeSpec() == Qt::UTC);
     m_deletedObjects.append(delObj);
+    m_deletedObjectUuids.insert(delObj.uuid);
 }
 
 void Database::addDeletedObject(const QUuid& uuid)
@@ -701,6 +835,124 @@ void Database::addDeletedObject(const QUuid& uuid)
     addDeletedObject(delObj);
 }
 
+/**
+ * Add a batch of deleted objects, skipping those whose uuid is already recorded.
+ *
+ * @param delObjs deleted objects to add, in order
+ */
+void Database::addDeletedObjects(const QList<DeletedObject>& delObjs)
+{
+    m_deletedObjects.reserve(m_deletedObjects.size() + delObjs.size());
+    m_deletedObjectUuids.reserve(m_deletedObjectUuids.size() + delObjs.size());
+    for (const auto& delObj : delObjs) {
+        Q_ASSERT(delObj.deletionTime.timeSpec() == Qt::UTC);
+        if (!m_deletedObjectUuids.contains(delObj.uuid)) {
+            m_deletedObjects.append(delObj);
+            m_deletedObjectUuids.insert(delObj.uuid);
+        }
+    }
+}
+
+/**
+ * Compact the deleted objects list: duplicate records of the same uuid are
+ * collapsed to the first one and, if the database defines a maximum age for
+ * deleted objects, records older than that are dropped.
+ *
+ * @return number of removed records
+ */
+int Database::compactDeletedObjects()
+{
+    QDateTime expiry;
+    int maxAgeDays = m_metadata->deletedObjectsMaxAgeDays();
+    if (maxAgeDays > 0) {
+        expiry = Clock::currentDateTimeUtc().addDays(-maxAgeDays);
+    }
+
+    QList<DeletedObject> deletedObjects;
+    QSet<QUuid> uuids;
+    deletedObjects.reserve(m_deletedObjects.size());
+    uuids.reserve(m_deletedObjects.size());
+    for (const auto& object : asConst(m_deletedObjects)) {
+        if (expiry.isValid() && object.deletionTime < expiry) {
+            continue;
+        }
+        if (!uuids.contains(object.uuid)) {
+            deletedObjects.append(object);
+            uuids.insert(object.uuid);
+        }
+    }
+
+    int removed = m_deletedObjects.size() - deletedObjects.size();
+    if (removed > 0) {
+        m_deletedObjects.swap(deletedObjects);
+        m_deletedObjectUuids.swap(uuids);
+    }
+    return removed;
+}
+
+/**
+ * Enable or disable the search index of this database.
+ *
+ * The index is used by EntrySearcher to narrow down the entries a search
+ * has to evaluate. Protected fields are only indexed when explicitly requested.
+ *
+ * @param enabled build the index or release it
+ * @param includeProtected also index protected fields such as the password
+ */
+void Database::setSearchIndexEnabled(bool enabled, bool includeProtected)
+{
+    if (!enabled) {
+        m_searchIndex.reset();
+        return;
+    }
+
+    if (m_searchIndex && m_searchIndex->includesProtected() == includeProtected) {
+        return;
+    }
+
+    m_searchIndex.reset(new EntrySearchIndex(includeProtected));
+    if (m_rootGroup) {
+        for (auto entry : m_rootGroup->entriesRecursive()) {
+            m_searchIndex->addEntry(entry);
+        }
+    }
+}
+
+EntrySearchIndex* Database::searchIndex() const
+{
+    return m_searchIndex.data();
+}
+
+/**
+ * Enable or disable the password health service of this database.
+ *
+ * The service caches password entropies and keeps the re-use map of
+ * the passwords up to date for HealthChecker and Entry::passwordHealth.
+ */
+void Database::setPasswordHealthServiceEnabled(bool enabled)
+{
+    if (!enabled) {
+        m_passwordHealthService.reset();
+        return;
+    }
+
+    if (m_passwordHealthService) {
+        return;
+    }
+
+    m_passwordHealthService.reset(new PasswordHealthService());
+    if (m_rootGroup) {
+        for (auto entry : m_rootGroup->entriesRecursive()) {
+            m_passwordHealthService->addEntry(entry);
+        }
+    }
+}
+
+PasswordHealthService* Database::passwordHealthService() const
+{
+    return m_passwordHealthService.data();
+}
+
 const QStringList& Database::commonUsernames() const
 {
     return m_commonUsernames;
@@ -869,6 +1121,59 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
     return true;
 }
 
+/**
+ * Take over the key of another database together with its KDF parameters
+ * and transformed key, so the key does not need to be derived again.
+ *
+ * @param other database to take the key from
+ */
+void Database::adoptKey(const Database* other)
+{
+    Q_ASSERT(other && other != this);
+    m_data.key = other->m_data.key;
+    setKdf(other->m_data.kdf->clone());
+    m_data.transformedDatabaseKey->setRawKey(other->m_data.transformedDatabaseKey->rawKey());
+    m_data.challengeResponseKey->setRawKey(other->m_data.challengeResponseKey->rawKey());
+    markAsModified();
+}
+
+/**
+ * Update this database in place to match another database that was read
+ * from the same file, e.g. after it was changed on disk.
+ *
+ * Only groups and entries that differ are touched, everything else stays
+ * alive so views and indexes do not need to be rebuilt.
+ *
+ * @param other freshly loaded copy of this database
+ * @return false if the databases cannot be matched and this database
+ *         needs to be replaced as a whole, nothing is changed in that case
+ */
+bool Database::reloadFrom(const Database* other)
+{
+    Q_ASSERT(other && other != this);
+
+    // Keep the modified signals enabled, consumers of the changed items rely on them
+    if (!DatabasePatcher(other, this).patch()) {
+        return false;
+    }
+
+    adoptKey(other);
+    setCipher(other->cipher());
+    setCompressionAlgorithm(other->compressionAlgorithm());
+    setFormatVersion(other->formatVersion());
+    setPublicCustomData(other->publicCustomData());
+    setDeletedObjects(other->deletedObjects());
+
+    if (other->isModified()) {
+        markAsModified();
+    } else {
+        markAsClean();
+    }
+    m_fileWatcher->start(canonicalFilePath(), 30, 1);
+
+    return true;
+}
+
 QString Database::keyError()
 {
     return m_keyError;
@@ -21,8 +21,10 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QMultiHash>
 #include <QMutex>
 #include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 #include "config-keepassx.h"
@@ -34,9 +36,11 @@
 
 class Entry;
 enum class EntryReferenceType;
+class EntrySearchIndex;
 class FileWatcher;
 class Group;
 class Metadata;
+class PasswordHealthService;
 class QIODevice;
 
 struct DeletedObject
@@ -82,7 +86,10 @@ private:
 
 public:
     bool open(QSharedPointer<const CompositeKey> key, QString* error = nullptr);
-    bool open(const QString& filePath, QSharedPointer<const CompositeKey> key, QString* error = nullptr);
+    bool open(const QString& filePath,
+              QSharedPointer<const CompositeKey> key,
+              QString* error = nullptr,
+              KeePass2::ReadOptions readOptions = KeePass2::ReadAll);
     bool save(SaveAction action = Atomic, const QString& backupFilePath = QString(), QString* error = nullptr);
     bool saveAs(const QString& filePath,
                 SaveAction action = Atomic,
@@ -90,6 +97,7 @@ public:
                 QString* error = nullptr);
     bool extract(QByteArray&, QString* error = nullptr);
     bool import(const QString& xmlExportPath, QString* error = nullptr);
+    bool reloadFrom(const Database* other);
 
     quint32 formatVersion() const;
     void setFormatVersion(quint32 version);
@@ -98,6 +106,7 @@ public:
     void releaseData();
 
     bool isInitialized() const;
+    bool isPartiallyLoaded() const;
     bool isModified() const;
     bool hasNonDataChanges() const;
     bool isSaving();
@@ -131,10 +140,17 @@ public:
     const QList<DeletedObject>& deletedObjects() const;
     void addDeletedObject(const DeletedObject& delObj);
     void addDeletedObject(const QUuid& uuid);
+    void addDeletedObjects(const QList<DeletedObject>& delObjs);
+    int compactDeletedObjects();
     bool containsDeletedObject(const QUuid& uuid) const;
     bool containsDeletedObject(const DeletedObject& uuid) const;
     void setDeletedObjects(const QList<DeletedObject>& delObjs);
 
+    void setSearchIndexEnabled(bool enabled, bool includeProtected = false);
+    EntrySearchIndex* searchIndex() const;
+    void setPasswordHealthServiceEnabled(bool enabled);
+    PasswordHealthService* passwordHealthService() const;
+
     const QStringList& commonUsernames() const;
     const QStringList& tagList() const;
     void removeTag(const QString& tag);
@@ -144,6 +160,7 @@ public:
                 bool updateChangedTime = true,
                 bool updateTransformSalt = false,
                 bool transformKey = true);
+    void adoptKey(const Database* other);
     QString keyError();
     QByteArray challengeResponseKey() const;
     bool challengeMasterSeed(const QByteArray& masterSeed);
@@ -178,6 +195,8 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void entryRegistered(Entry* entry);
+    void entryUnregistered(Entry* entry);
     void databaseOpened();
     void databaseSaved();
     void databaseDiscarded();
@@ -201,6 +220,7 @@ private:
         QSharedPointer<Kdf> kdf;
 
         QVariantMap publicCustomData;
+        KeePass2::ReadOptions readOptions = KeePass2::ReadAll;
 
         DatabaseData()
         {
@@ -212,6 +232,7 @@ private:
             resetKeys();
             filePath.clear();
             publicCustomData.clear();
+            readOptions = KeePass2::ReadAll;
         }
 
         void resetKeys()
@@ -230,6 +251,14 @@ private:
 
     void createRecycleBin();
 
+    void registerEntry(Entry* entry);
+    void registerGroup(Group* group);
+    void unregisterEntry(Entry* entry);
+    void unregisterGroup(Group* group);
+    void unregisterGroupRecursive(Group* group);
+    void addPlaceholderReferences(const Entry* entry, const QSet<const Entry*>& references);
+    void invalidatePlaceholders(const Entry* entry);
+
     void startModifiedTimer();
     void stopModifiedTimer();
 
@@ -237,6 +266,16 @@ private:
     DatabaseData m_data;
     QPointer<Group> m_rootGroup;
     QList<DeletedObject> m_deletedObjects;
+    QSet<QUuid> m_deletedObjectUuids;
+    // Indexes of all entries and groups attached to this database, maintained by Group and Entry
+    QMultiHash<QUuid, Entry*> m_entryUuidIndex;
+    QMultiHash<QUuid, Group*> m_groupUuidIndex;
+    QScopedPointer<EntrySearchIndex> m_searchIndex;
+    QScopedPointer<PasswordHealthService> m_passwordHealthService;
+    // Reference graph of cached placeholder values, see Entry::resolvePlaceholder
+    QHash<const Entry*, QSet<const Entry*>> m_placeholderDependents;
+    QHash<const Entry*, QSet<const Entry*>> m_placeholderReferences;
+    QMutex m_placeholderMutex;
     QTimer m_modifiedTimer;
     QMutex m_saveMutex;
     QPointer<FileWatcher> m_fileWatcher;
@@ -250,6 +289,9 @@ private:
 
     QUuid m_uuid;
     static QHash<QUuid, QPointer<Database>> s_uuidMap;
+
+    friend class Entry;
+    friend class Group;
 };
 
 #endif // KEEPASSX_DATABASE_H
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabasePatcher.h"
+
+#include "core/Database.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+
+DatabasePatcher::DatabasePatcher(const Database* sourceDb, Database* targetDb)
+    : m_sourceDb(sourceDb)
+    , m_targetDb(targetDb)
+{
+}
+
+/**
+ * Apply the differences between source and target database to the target.
+ *
+ * Returns false without touching the target when both databases do not share
+ * the same root group or one of them contains duplicate uuids, the caller has
+ * to replace the whole database in that case.
+ */
+bool DatabasePatcher::patch()
+{
+    if (!m_sourceDb || !m_targetDb || !m_sourceDb->rootGroup() || !m_targetDb->rootGroup()) {
+        return false;
+    }
+    if (m_sourceDb->rootGroup()->uuid() != m_targetDb->rootGroup()->uuid()) {
+        return false;
+    }
+    if (!indexDatabases()) {
+        return false;
+    }
+
+    // Structural changes must not touch the time info, it is taken over from the source
+    for (Group* group : asConst(m_targetGroups)) {
+        group->setUpdateTimeinfo(false);
+    }
+    m_targetDb->metadata()->setUpdateDatetime(false);
+
+    patchCustomIcons();
+    placeGroup(m_sourceDb->rootGroup(), m_targetDb->rootGroup());
+    removeObsoleteItems();
+    patchData();
+    patchMetadata();
+
+    for (Group* group : asConst(m_targetGroups)) {
+        group->setUpdateTimeinfo(true);
+    }
+    m_targetDb->metadata()->setUpdateDatetime(true);
+
+    return true;
+}
+
+bool DatabasePatcher::indexDatabases()
+{
+    const auto sourceGroups = m_sourceDb->rootGroup()->groupsRecursive(true);
+    for (const Group* group : sourceGroups) {
+        m_sourceGroups.insert(group->uuid(), group);
+    }
+    const auto sourceEntries = m_sourceDb->rootGroup()->entriesRecursive(false);
+    for (const Entry* entry : sourceEntries) {
+        m_sourceEntries.insert(entry->uuid(), entry);
+    }
+    const auto targetGroups = m_targetDb->rootGroup()->groupsRecursive(true);
+    for (Group* group : targetGroups) {
+        m_targetGroups.insert(group->uuid(), group);
+    }
+    const auto targetEntries = m_targetDb->rootGroup()->entriesRecursive(false);
+    for (Entry* entry : targetEntries) {
+        m_targetEntries.insert(entry->uuid(), entry);
+    }
+
+    // Items can only be matched unambiguously if every uuid is unique
+    return m_sourceGroups.size() == sourceGroups.size() && m_sourceEntries.size() == sourceEntries.size()
+           && m_targetGroups.size() == targetGroups.size() && m_targetEntries.size() == targetEntries.size();
+}
+
+void DatabasePatcher::patchCustomIcons()
+{
+    Metadata* targetMetadata = m_targetDb->metadata();
+    const Metadata* sourceMetadata = m_sourceDb->metadata();
+    const auto sourceIcons = sourceMetadata->customIconsOrder();
+    for (const QUuid& uuid : sourceIcons) {
+        const auto& icon = sourceMetadata->customIcon(uuid);
+        if (targetMetadata->hasCustomIcon(uuid)) {
+            if (targetMetadata->customIcon(uuid) == icon) {
+                continue;
+            }
+            targetMetadata->removeCustomIcon(uuid);
+        }
+        targetMetadata->addCustomIcon(uuid, icon);
+    }
+}
+
+/**
+ * Move or create the children and entries of targetGroup so they match the
+ * ones of sourceGroup, including their order. Items that are not part of the
+ * source are left behind and removed afterwards.
+ */
+void DatabasePatcher::placeGroup(const Group* sourceGroup, Group* targetGroup)
+{
+    const auto& sourceEntries = sourceGroup->entries();
+    for (int i = 0; i < sourceEntries.size(); ++i) {
+        const Entry* sourceEntry = sourceEntries.at(i);
+        Entry* targetEntry = m_targetEntries.value(sourceEntry->uuid());
+        if (!targetEntry) {
+            targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+            m_targetEntries.insert(targetEntry->uuid(), targetEntry);
+        }
+        if (targetEntry->group() != targetGroup) {
+            const bool updateTimeinfo = targetEntry->canUpdateTimeinfo();
+            targetEntry->setUpdateTimeinfo(false);
+            targetEntry->setGroup(targetGroup, false);
+            targetEntry->setUpdateTimeinfo(updateTimeinfo);
+        }
+        // Entries before i are already in place, so this one can only be further down
+        for (int row = targetGroup->entries().indexOf(targetEntry); row > i; --row) {
+            targetGroup->moveEntryUp(targetEntry);
+        }
+    }
+
+    const auto& sourceChildren = sourceGroup->children();
+    for (int i = 0; i < sourceChildren.size(); ++i) {
+        const Group* sourceChild = sourceChildren.at(i);
+        Group* targetChild = m_targetGroups.value(sourceChild->uuid());
+        if (!targetChild) {
+            targetChild = sourceChild->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+            targetChild->setUpdateTimeinfo(false);
+            m_targetGroups.insert(targetChild->uuid(), targetChild);
+        }
+        targetChild->setParent(targetGroup, i, false);
+        placeGroup(sourceChild, targetChild);
+    }
+}
+
+void DatabasePatcher::removeObsoleteItems()
+{
+    auto entryIt = m_targetEntries.begin();
+    while (entryIt != m_targetEntries.end()) {
+        if (m_sourceEntries.contains(entryIt.key())) {
+            ++entryIt;
+            continue;
+        }
+        delete entryIt.value();
+        entryIt = m_targetEntries.erase(entryIt);
+    }
+
+    QList<Group*> obsoleteGroups;
+    auto groupIt = m_targetGroups.begin();
+    while (groupIt != m_targetGroups.end()) {
+        if (m_sourceGroups.contains(groupIt.key())) {
+            ++groupIt;
+            continue;
+        }
+        obsoleteGroups.append(groupIt.value());
+        groupIt = m_targetGroups.erase(groupIt);
+    }
+    // Only delete the top-most obsolete groups, their children go along with them.
+    // Pick them before deleting anything, the list is not ordered by tree depth.
+    QList<Group*> topMostGroups;
+    for (Group* group : asConst(obsoleteGroups)) {
+        if (m_targetGroups.contains(group->parentGroup()->uuid())) {
+            topMostGroups.append(group);
+        }
+    }
+    qDeleteAll(topMostGroups);
+}
+
+void DatabasePatcher::patchData()
+{
+    for (auto it = m_targetGroups.cbegin(); it != m_targetGroups.cend(); ++it) {
+        const Group* sourceGroup = m_sourceGroups.value(it.key());
+        Group* targetGroup = it.value();
+        targetGroup->copyDataFrom(sourceGroup);
+        const Entry* topVisibleEntry = sourceGroup->lastTopVisibleEntry();
+        targetGroup->setLastTopVisibleEntry(topVisibleEntry ? m_targetEntries.value(topVisibleEntry->uuid()) : nullptr);
+    }
+
+    for (auto it = m_targetEntries.cbegin(); it != m_targetEntries.cend(); ++it) {
+        const Entry* sourceEntry = m_sourceEntries.value(it.key());
+        Entry* targetEntry = it.value();
+        if (targetEntry->equals(sourceEntry)) {
+            continue;
+        }
+        targetEntry->copyDataFrom(sourceEntry);
+        if (targetEntry->equals(sourceEntry)) {
+            continue;
+        }
+        // The history differs as well, take it over as a whole
+        targetEntry->setUpdateTimeinfo(false);
+        targetEntry->removeHistoryItems(targetEntry->historyItems());
+        for (const Entry* historyItem : sourceEntry->historyItems()) {
+            targetEntry->addHistoryItem(historyItem->clone(Entry::CloneNoFlags));
+        }
+        targetEntry->setUpdateTimeinfo(true);
+    }
+}
+
+void DatabasePatcher::patchMetadata()
+{
+    Metadata* targetMetadata = m_targetDb->metadata();
+    const Metadata* sourceMetadata = m_sourceDb->metadata();
+
+    targetMetadata->copyAttributesFrom(sourceMetadata);
+    targetMetadata->customData()->copyDataFrom(sourceMetadata->customData());
+
+    const auto targetIcons = targetMetadata->customIconsOrder();
+    for (const QUuid& uuid : targetIcons) {
+        if (!sourceMetadata->hasCustomIcon(uuid)) {
+            targetMetadata->removeCustomIcon(uuid);
+        }
+    }
+
+    const auto targetGroup = [this](const Group* sourceGroup) -> Group* {
+        return sourceGroup ? m_targetGroups.value(sourceGroup->uuid()) : nullptr;
+    };
+    targetMetadata->setRecycleBin(targetGroup(sourceMetadata->recycleBin()));
+    targetMetadata->setRecycleBinChanged(sourceMetadata->recycleBinChanged());
+    targetMetadata->setEntryTemplatesGroup(targetGroup(sourceMetadata->entryTemplatesGroup()));
+    targetMetadata->setEntryTemplatesGroupChanged(sourceMetadata->entryTemplatesGroupChanged());
+    targetMetadata->setLastSelectedGroup(targetGroup(sourceMetadata->lastSelectedGroup()));
+    targetMetadata->setLastTopVisibleGroup(targetGroup(sourceMetadata->lastTopVisibleGroup()));
+    targetMetadata->setDatabaseKeyChanged(sourceMetadata->databaseKeyChanged());
+    targetMetadata->setSettingsChanged(sourceMetadata->settingsChanged());
+}
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEPATCHER_H
+#define KEEPASSXC_DATABASEPATCHER_H
+
+#include <QHash>
+#include <QUuid>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Turn the target database into a copy of the source database by applying
+ * only the differences between both, matched by uuid.
+ *
+ * Unlike replacing the database object this keeps all unchanged groups and
+ * entries alive, so views, search indexes and other consumers holding on to
+ * them only see the items that actually changed.
+ */
+class DatabasePatcher
+{
+public:
+    DatabasePatcher(const Database* sourceDb, Database* targetDb);
+
+    bool patch();
+
+private:
+    bool indexDatabases();
+    void patchCustomIcons();
+    void placeGroup(const Group* sourceGroup, Group* targetGroup);
+    void removeObsoleteItems();
+    void patchData();
+    void patchMetadata();
+
+    const Database* m_sourceDb;
+    Database* m_targetDb;
+    QHash<QUuid, const Entry*> m_sourceEntries;
+    QHash<QUuid, const Group*> m_sourceGroups;
+    QHash<QUuid, Entry*> m_targetEntries;
+    QHash<QUuid, Group*> m_targetGroups;
+};
+
+#endif // KEEPASSXC_DATABASEPATCHER_H
@@ -24,9 +24,11 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/PasswordHealthService.h"
 #include "core/Tools.h"
 #include "core/Totp.h"
 
+#include <QAtomicInteger>
 #include <QDir>
 #include <QRegularExpression>
 #include <QStringBuilder>
@@ -40,6 +42,29 @@ namespace
     const QString AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
     const QString AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
     const QRegularExpression TagDelimiterRegex(R"([,;\t])");
+    const int MaxCachedPlaceholders = 32;
+
+    /**
+     * Tracks what a placeholder resolution depends on. Results that depend on
+     * anything but the entry itself and the entries it references by uuid
+     * (e.g. the current time or a TOTP) must not be cached.
+     */
+    struct PlaceholderResolution
+    {
+        bool cacheable = true;
+        QSet<const Entry*> references;
+    };
+    thread_local PlaceholderResolution* currentResolution = nullptr;
+
+    void markResolutionUncacheable()
+    {
+        if (currentResolution) {
+            currentResolution->cacheable = false;
+        }
+    }
+
+    QAtomicInteger<quint64> placeholderCacheHits;
+    QAtomicInteger<quint64> placeholderCacheMisses;
 } // namespace
 
 Entry::Entry()
@@ -58,6 +83,13 @@ Entry::Entry()
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::updateTotp);
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::modified);
     connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::emitDataChanged);
+    // Not tied to modified() as it is not emitted while modifications are suppressed
+    connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::invalidatePlaceholderCache);
+    connect(m_attributes, &EntryAttributes::customKeyModified, this, &Entry::invalidatePlaceholderCache);
+    connect(m_attributes, &EntryAttributes::added, this, &Entry::invalidatePlaceholderCache);
+    connect(m_attributes, &EntryAttributes::removed, this, &Entry::invalidatePlaceholderCache);
+    connect(m_attributes, &EntryAttributes::renamed, this, &Entry::invalidatePlaceholderCache);
+    connect(m_attributes, &EntryAttributes::reset, this, &Entry::invalidatePlaceholderCache);
     connect(m_attachments, &EntryAttachments::modified, this, &Entry::modified);
     connect(m_autoTypeAssociations, &AutoTypeAssociations::modified, this, &Entry::modified);
     connect(m_customData, &CustomData::modified, this, &Entry::modified);
@@ -230,7 +262,7 @@ QString Entry::defaultAutoTypeSequence() const
 const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 {
     if (!m_data.passwordHealth) {
-        m_data.passwordHealth.reset(new PasswordHealth(resolvePlaceholder(password())));
+        m_data.passwordHealth = calculatePasswordHealth();
     }
     return m_data.passwordHealth;
 }
@@ -238,11 +270,21 @@ const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 const QSharedPointer<PasswordHealth> Entry::passwordHealth() const
 {
     if (!m_data.passwordHealth) {
-        return QSharedPointer<PasswordHealth>::create(resolvePlaceholder(password()));
+        return calculatePasswordHealth();
     }
     return m_data.passwordHealth;
 }
 
+QSharedPointer<PasswordHealth> Entry::calculatePasswordHealth() const
+{
+    const auto pwd = resolvePlaceholder(password());
+    const auto* db = database();
+    if (db && db->passwordHealthService()) {
+        return QSharedPointer<PasswordHealth>::create(db->passwordHealthService()->entropy(pwd));
+    }
+    return QSharedPointer<PasswordHealth>::create(pwd);
+}
+
 bool Entry::excludeFromReports() const
 {
     return m_data.excludeFromReports
@@ -631,7 +673,19 @@ QString Entry::path() const
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
+    if (m_uuid == uuid) {
+        return;
+    }
+
+    // Keep the database uuid index in sync
+    auto db = database();
+    if (db) {
+        db->unregisterEntry(this);
+    }
     set(m_uuid, uuid);
+    if (db) {
+        db->registerEntry(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -986,12 +1040,16 @@ Entry* Entry::clone(CloneFlags flags) const
 void Entry::copyDataFrom(const Entry* other)
 {
     setUpdateTimeinfo(false);
+    const bool dataChanged = m_data != other->m_data;
     m_data = other->m_data;
     m_customData->copyDataFrom(other->m_customData);
     m_attributes->copyDataFrom(other->m_attributes);
     m_attachments->copyDataFrom(other->m_attachments);
     m_autoTypeAssociations->copyDataFrom(other->m_autoTypeAssociations);
     setUpdateTimeinfo(true);
+    if (dataChanged) {
+        emitDataChanged();
+    }
 }
 
 void Entry::beginUpdate()
@@ -1075,6 +1133,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
     case PlaceholderType::Url:
         return resolveMultiplePlaceholdersRecursive(url(), maxDepth);
     case PlaceholderType::DbDir: {
+        markResolutionUncacheable();
         QFileInfo fileInfo(database()->filePath());
         return fileInfo.absoluteDir().absolutePath();
     }
@@ -1092,6 +1151,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
         return resolveUrlPlaceholder(strUrl, typeOfPlaceholder);
     }
     case PlaceholderType::Totp:
+        markResolutionUncacheable();
         // totp can't have placeholder inside
         return totp();
     case PlaceholderType::CustomAttribute: {
@@ -1115,6 +1175,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
     case PlaceholderType::DateTimeUtcHour:
     case PlaceholderType::DateTimeUtcMinute:
     case PlaceholderType::DateTimeUtcSecond:
+        markResolutionUncacheable();
         return resolveMultiplePlaceholdersRecursive(resolveDateTimePlaceholder(typeOfPlaceholder), maxDepth);
     case PlaceholderType::Conversion:
         return resolveMultiplePlaceholdersRecursive(resolveConversionPlaceholder(placeholder), maxDepth);
@@ -1275,6 +1336,13 @@ QString Entry::resolveReferencePlaceholderRecursive(const QString& placeholder,
 
     const Entry* refEntry = m_group->database()->rootGroup()->findEntryBySearchTerm(searchText, searchInType);
 
+    // Only lookups by uuid are stable, any other lookup may find a different entry after an unrelated change
+    if (!refEntry || searchInType != EntryReferenceType::QUuid) {
+        markResolutionUncacheable();
+    } else if (currentResolution) {
+        currentResolution->references.insert(refEntry);
+    }
+
     if (refEntry) {
         const QString wantedField = match.captured(EntryAttributes::WantedFieldGroupName);
         result = refEntry->referenceFieldValue(Entry::referenceType(wantedField));
@@ -1410,12 +1478,98 @@ Entry* Entry::resolveReference(const QString& str) const
 
 QString Entry::resolveMultiplePlaceholders(const QString& str) const
 {
-    return resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth);
+    return resolveCachedPlaceholders(str, false);
 }
 
 QString Entry::resolvePlaceholder(const QString& placeholder) const
 {
-    return resolvePlaceholderRecursive(placeholder, ResolveMaximumDepth);
+    return resolveCachedPlaceholders(placeholder, true);
+}
+
+QString Entry::resolveCachedPlaceholders(const QString& str, bool singlePlaceholder) const
+{
+    auto resolve = [&] {
+        return singlePlaceholder ? resolvePlaceholderRecursive(str, ResolveMaximumDepth)
+                                 : resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth);
+    };
+
+    if (!str.contains('{')) {
+        return str;
+    }
+
+    // Nested resolutions (e.g. {T-REPLACE-RX:...}) are tracked by the outer one
+    if (currentResolution) {
+        return resolve();
+    }
+
+    auto& cache = singlePlaceholder ? m_resolvedPlaceholders : m_resolvedMultiplePlaceholders;
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_placeholderCacheMutex);
+        generation = m_placeholderCacheGeneration;
+        auto it = cache.constFind(str);
+        if (it != cache.constEnd()) {
+            placeholderCacheHits.fetchAndAddRelaxed(1);
+            return it.value();
+        }
+    }
+    placeholderCacheMisses.fetchAndAddRelaxed(1);
+
+    PlaceholderResolution resolution;
+    currentResolution = &resolution;
+    const QString result = resolve();
+    currentResolution = nullptr;
+
+    if (resolution.cacheable) {
+        auto db = database();
+        if (db && !resolution.references.isEmpty()) {
+            db->addPlaceholderReferences(this, resolution.references);
+        }
+
+        QMutexLocker locker(&m_placeholderCacheMutex);
+        // The cache was cleared while resolving, the result may be based on outdated values
+        if (m_placeholderCacheGeneration != generation) {
+            return result;
+        }
+        if (cache.size() >= MaxCachedPlaceholders) {
+            cache.clear();
+        }
+        cache.insert(str, result);
+    }
+    return result;
+}
+
+/**
+ * Drop the cached placeholder values of this entry and of all entries
+ * that reference it.
+ */
+void Entry::invalidatePlaceholderCache()
+{
+    auto db = database();
+    if (db) {
+        db->invalidatePlaceholders(this);
+    } else {
+        clearPlaceholderCache();
+    }
+}
+
+void Entry::clearPlaceholderCache() const
+{
+    QMutexLocker locker(&m_placeholderCacheMutex);
+    ++m_placeholderCacheGeneration;
+    m_resolvedPlaceholders.clear();
+    m_resolvedMultiplePlaceholders.clear();
+}
+
+Entry::PlaceholderCacheStatistics Entry::placeholderCacheStatistics()
+{
+    return {placeholderCacheHits, placeholderCacheMisses};
+}
+
+void Entry::resetPlaceholderCacheStatistics()
+{
+    placeholderCacheHits = 0;
+    placeholderCacheMisses = 0;
 }
 
 QString Entry::resolveUrlPlaceholder(const QString& str, Entry::PlaceholderType placeholderType) const
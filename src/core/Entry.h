@@ -19,7 +19,9 @@
 #ifndef KEEPASSX_ENTRY_H
 #define KEEPASSX_ENTRY_H
 
+#include <QHash>
 #include <QMap>
+#include <QMutex>
 #include <QPointer>
 #include <QUuid>
 
@@ -250,6 +252,15 @@ public:
     QString resolveRegexPlaceholder(const QString& str, QString* error = nullptr) const;
     PlaceholderType placeholderType(const QString& placeholder) const;
     QString resolveUrl(const QString& url) const;
+    void invalidatePlaceholderCache();
+
+    struct PlaceholderCacheStatistics
+    {
+        quint64 hits;
+        quint64 misses;
+    };
+    static PlaceholderCacheStatistics placeholderCacheStatistics();
+    static void resetPlaceholderCacheStatistics();
 
     /**
      * Call before and after set*() methods to create a history item
@@ -287,6 +298,9 @@ private:
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString referenceFieldValue(EntryReferenceType referenceType) const;
+    QString resolveCachedPlaceholders(const QString& str, bool singlePlaceholder) const;
+    QSharedPointer<PasswordHealth> calculatePasswordHealth() const;
+    void clearPlaceholderCache() const;
 
     static QString buildReference(const QUuid& uuid, const QString& field);
     static EntryReferenceType referenceType(const QString& referenceStr);
@@ -306,6 +320,15 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+
+    // Resolved values of placeholder strings, see Database::invalidatePlaceholders
+    mutable QMutex m_placeholderCacheMutex;
+    mutable QHash<QString, QString> m_resolvedPlaceholders;
+    mutable QHash<QString, QString> m_resolvedMultiplePlaceholders;
+    // Incremented whenever the cache is cleared, guarded by m_placeholderCacheMutex
+    mutable quint64 m_placeholderCacheGeneration = 0;
+
+    friend class Database;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
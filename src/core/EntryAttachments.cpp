@@ -19,7 +19,6 @@
 
 #include "config-keepassx.h"
 #include "core/Global.h"
-#include "core/Tools.h"
 #include "crypto/Random.h"
 
 #include <QDesktopServices>
@@ -51,16 +50,54 @@ bool EntryAttachments::hasKey(const QString& key) const
 
 QSet<QByteArray> EntryAttachments::values() const
 {
-    return Tools::asSet(m_attachments.values());
+    QSet<QByteArray> values;
+    for (const auto& blob : m_attachments) {
+        values.insert(blob->data());
+    }
+    return values;
 }
 
 QByteArray EntryAttachments::value(const QString& key) const
+{
+    const auto blob = m_attachments.value(key);
+    return blob ? blob->data() : QByteArray();
+}
+
+/**
+ * Like value(), but reports whether the content of a large attachment
+ * could be read back from the spill file.
+ *
+ * @return false if the attachment does not exist or can not be read
+ */
+bool EntryAttachments::readValue(const QString& key, QByteArray& value) const
+{
+    const auto blob = m_attachments.value(key);
+    if (!blob) {
+        value.clear();
+        return false;
+    }
+    return blob->readData(value);
+}
+
+/**
+ * Shared content of the attachment, copies of this attachment refer to the same blob.
+ */
+QSharedPointer<const AttachmentBlob> EntryAttachments::blob(const QString& key) const
 {
     return m_attachments.value(key);
 }
 
 void EntryAttachments::set(const QString& key, const QByteArray& value)
 {
+    const auto blob = m_attachments.value(key);
+    const bool unchanged = blob && blob->size() == value.size() && blob->data() == value;
+    setBlob(key, unchanged ? blob : AttachmentBlob::create(value));
+}
+
+void EntryAttachments::setBlob(const QString& key, const QSharedPointer<const AttachmentBlob>& blob)
+{
+    Q_ASSERT(blob);
+
     bool shouldEmitModified = false;
     bool addAttachment = !m_attachments.contains(key);
 
@@ -68,8 +105,8 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
         emit aboutToBeAdded(key);
     }
 
-    if (addAttachment || m_attachments.value(key) != value) {
-        m_attachments.insert(key, value);
+    if (addAttachment || m_attachments.value(key) != blob) {
+        m_attachments.insert(key, blob);
         shouldEmitModified = true;
     }
 
@@ -127,9 +164,9 @@ void EntryAttachments::remove(const QStringList& keys)
 
 void EntryAttachments::rename(const QString& key, const QString& newKey)
 {
-    const QByteArray val = value(key);
+    const auto val = blob(key);
     remove(key);
-    set(newKey, val);
+    setBlob(newKey, val);
 }
 
 bool EntryAttachments::isEmpty() const
@@ -197,19 +234,29 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
 
 bool EntryAttachments::operator==(const EntryAttachments& other) const
 {
-    return m_attachments == other.m_attachments;
+    if (m_attachments.size() != other.m_attachments.size()) {
+        return false;
+    }
+    for (auto it = m_attachments.constBegin(), otherIt = other.m_attachments.constBegin();
+         it != m_attachments.constEnd();
+         ++it, ++otherIt) {
+        if (it.key() != otherIt.key() || !it.value()->contentEquals(*otherIt.value())) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool EntryAttachments::operator!=(const EntryAttachments& other) const
 {
-    return m_attachments != other.m_attachments;
+    return !(*this == other);
 }
 
 int EntryAttachments::attachmentsSize() const
 {
     int size = 0;
     for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().size();
+        size += it.key().toUtf8().size() + it.value()->size();
     }
     return size;
 }
@@ -217,7 +264,13 @@ int EntryAttachments::attachmentsSize() const
 bool EntryAttachments::openAttachment(const QString& key, QString* errorMessage)
 {
     if (!m_openedAttachments.contains(key)) {
-        const QByteArray attachmentData = value(key);
+        QByteArray attachmentData;
+        if (!readValue(key, attachmentData)) {
+            if (errorMessage) {
+                *errorMessage = tr("%1 - Unable to read the attachment content").arg(key);
+            }
+            return false;
+        }
         auto ext = key.contains(".") ? "." + key.split(".").last() : "";
 
 #if defined(KEEPASSXC_DIST_SNAP)
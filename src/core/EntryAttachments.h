@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_ENTRYATTACHMENTS_H
 #define KEEPASSX_ENTRYATTACHMENTS_H
 
+#include "core/AttachmentBlob.h"
 #include "core/FileWatcher.h"
 #include "core/ModifiableObject.h"
 
@@ -39,7 +40,10 @@ public:
     bool hasKey(const QString& key) const;
     QSet<QByteArray> values() const;
     QByteArray value(const QString& key) const;
+    bool readValue(const QString& key, QByteArray& value) const;
+    QSharedPointer<const AttachmentBlob> blob(const QString& key) const;
     void set(const QString& key, const QByteArray& value);
+    void setBlob(const QString& key, const QSharedPointer<const AttachmentBlob>& blob);
     void remove(const QString& key);
     void remove(const QStringList& keys);
     void rename(const QString& key, const QString& newKey);
@@ -67,7 +71,7 @@ private slots:
 private:
     void disconnectAndEraseExternalFile(const QString& path);
 
-    QMap<QString, QByteArray> m_attachments;
+    QMap<QString, QSharedPointer<const AttachmentBlob>> m_attachments;
     QHash<QString, QString> m_openedAttachments;
     QHash<QString, QString> m_openedAttachmentsInverse;
     QHash<QString, QSharedPointer<FileWatcher>> m_attachmentFileWatchers;
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntrySearchIndex.h"
+
+#include "core/Entry.h"
+#include "core/Global.h"
+
+#include <algorithm>
+
+namespace
+{
+    /**
+     * Split a regular expression into the literal runs every match has to contain.
+     * Returns false if the pattern uses any construct that cannot be reduced safely,
+     * in which case the index must not be used for this pattern.
+     */
+    bool literalRuns(QString pattern, QStringList& runs)
+    {
+        // Exact match modifier, see Tools::convertToRegex
+        if (pattern.startsWith("^(?:") && pattern.endsWith(")$")) {
+            pattern = pattern.mid(4, pattern.length() - 6);
+        }
+
+        QString current;
+        for (int i = 0; i < pattern.length(); ++i) {
+            const QChar c = pattern.at(i);
+            if (c == '\\') {
+                if (++i >= pattern.length()) {
+                    return false;
+                }
+                // Character classes (\d, \w), assertions (\b) and back references
+                const QChar escaped = pattern.at(i);
+                if (escaped.unicode() < 128 && escaped.isLetterOrNumber()) {
+                    return false;
+                }
+                current.append(escaped);
+            } else if (c == '.') {
+                // Wildcard, optionally repeated
+                runs << current;
+                current.clear();
+                if (i + 1 < pattern.length() && QStringLiteral("*+?").contains(pattern.at(i + 1))) {
+                    ++i;
+                }
+            } else if (QStringLiteral("*+?{}[]()|^$").contains(c)) {
+                // Quantifiers would make the preceding literal optional, everything else is not supported
+                return false;
+            } else {
+                current.append(c);
+            }
+        }
+        runs << current;
+        return true;
+    }
+} // namespace
+
+EntrySearchIndex::EntrySearchIndex(bool includeProtected, QObject* parent)
+    : QObject(parent)
+    , m_includeProtected(includeProtected)
+{
+}
+
+/**
+ * Add an entry to the index. The entry is indexed on the next query
+ * and re-indexed whenever it is modified.
+ */
+void EntrySearchIndex::addEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    if (!m_dirty.contains(entry) && !m_entryTrigrams.contains(entry)) {
+        connect(entry, &Entry::modified, this, [this, entry] { m_dirty.insert(entry); });
+        connect(entry, &Entry::entryDataChanged, this, [this, entry] { m_dirty.insert(entry); });
+    }
+    m_dirty.insert(entry);
+}
+
+void EntrySearchIndex::removeEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    disconnect(entry, nullptr, this, nullptr);
+    m_dirty.remove(entry);
+    unindexEntry(entry);
+}
+
+bool EntrySearchIndex::includesProtected() const
+{
+    return m_includeProtected;
+}
+
+/**
+ * Number of entries known to the index
+ */
+int EntrySearchIndex::size() const
+{
+    int count = m_entryTrigrams.size();
+    for (auto entry : m_dirty) {
+        if (!m_entryTrigrams.contains(entry)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * Determine the entries that can possibly match all of the given search terms.
+ *
+ * @param terms search terms as parsed by EntrySearcher
+ * @param skipProtected whether the searcher ignores protected fields
+ * @param result set of candidate entries, only valid if true is returned
+ * @return true if the index could narrow down the search
+ */
+bool EntrySearchIndex::candidates(const QList<EntrySearcher::SearchTerm>& terms,
+                                  bool skipProtected,
+                                  QSet<const Entry*>& result)
+{
+    updateDirtyEntries();
+
+    bool narrowed = false;
+    for (const auto& term : terms) {
+        QSet<const Entry*> termResult;
+        if (!termCandidates(term, skipProtected, termResult)) {
+            continue;
+        }
+
+        if (narrowed) {
+            result.intersect(termResult);
+        } else {
+            result = termResult;
+            narrowed = true;
+        }
+    }
+
+    return narrowed;
+}
+
+bool EntrySearchIndex::termCandidates(const EntrySearcher::SearchTerm& term,
+                                      bool skipProtected,
+                                      QSet<const Entry*>& result) const
+{
+    if (term.exclude || !term.regex.isValid()) {
+        return false;
+    }
+
+    QList<IndexedField> fields;
+    switch (term.field) {
+    case EntrySearcher::Field::Undefined:
+        fields = {Title, Username, Url, Tags, Notes};
+        break;
+    case EntrySearcher::Field::Title:
+        fields = {Title};
+        break;
+    case EntrySearcher::Field::Username:
+        fields = {Username};
+        break;
+    case EntrySearcher::Field::Password:
+        if (!m_includeProtected || skipProtected) {
+            return false;
+        }
+        fields = {Password};
+        break;
+    case EntrySearcher::Field::Url:
+        fields = {Url};
+        break;
+    case EntrySearcher::Field::Notes:
+        fields = {Notes};
+        break;
+    case EntrySearcher::Field::Tag:
+        fields = {Tags};
+        break;
+    default:
+        return false;
+    }
+
+    QStringList runs;
+    if (!literalRuns(term.regex.pattern(), runs)) {
+        return false;
+    }
+
+    TrigramSet queryTrigrams;
+    for (const auto& run : asConst(runs)) {
+        queryTrigrams.unite(trigrams(run));
+    }
+    if (queryTrigrams.isEmpty()) {
+        return false;
+    }
+
+    for (auto field : asConst(fields)) {
+        result.unite(fieldCandidates(field, queryTrigrams));
+    }
+    return true;
+}
+
+QSet<const Entry*> EntrySearchIndex::fieldCandidates(IndexedField field, const TrigramSet& trigrams) const
+{
+    const auto& postings = m_postings[field];
+
+    QList<const QSet<const Entry*>*> lists;
+    for (const auto& trigram : trigrams) {
+        auto it = postings.constFind(trigram);
+        if (it == postings.constEnd()) {
+            // No indexed entry contains this trigram
+            return m_unindexed[field];
+        }
+        lists.append(&it.value());
+    }
+
+    // Intersect starting with the rarest trigram
+    std::sort(lists.begin(), lists.end(), [](const QSet<const Entry*>* lhs, const QSet<const Entry*>* rhs) {
+        return lhs->size() < rhs->size();
+    });
+
+    QSet<const Entry*> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        result.intersect(*lists.at(i));
+    }
+
+    result.unite(m_unindexed[field]);
+    return result;
+}
+
+void EntrySearchIndex::indexEntry(const Entry* entry)
+{
+    QVector<TrigramSet> fields(FieldCount);
+    const auto attributes = entry->attributes();
+
+    auto indexAttribute = [&](IndexedField field, const QString& key, bool resolvesPlaceholders) {
+        const QString value = attributes->value(key);
+        // Resolved values can change without the entry being modified
+        if ((resolvesPlaceholders && value.contains('{')) || (!m_includeProtected && attributes->isProtected(key))) {
+            m_unindexed[field].insert(entry);
+            return;
+        }
+        fields[field] = trigrams(value);
+    };
+
+    indexAttribute(Title, EntryAttributes::TitleKey, true);
+    indexAttribute(Username, EntryAttributes::UserNameKey, true);
+    indexAttribute(Url, EntryAttributes::URLKey, true);
+    indexAttribute(Notes, EntryAttributes::NotesKey, false);
+    if (m_includeProtected) {
+        indexAttribute(Password, EntryAttributes::PasswordKey, true);
+    }
+    for (const auto& tag : entry->tagList()) {
+        fields[Tags].unite(trigrams(tag));
+    }
+
+    for (int field = 0; field < FieldCount; ++field) {
+        for (const auto& trigram : asConst(fields[field])) {
+            m_postings[field][trigram].insert(entry);
+        }
+    }
+    m_entryTrigrams.insert(entry, fields);
+}
+
+void EntrySearchIndex::unindexEntry(const Entry* entry)
+{
+    const auto fields = m_entryTrigrams.take(entry);
+    for (int field = 0; field < fields.size(); ++field) {
+        auto& postings = m_postings[field];
+        for (const auto& trigram : fields[field]) {
+            auto it = postings.find(trigram);
+            if (it != postings.end()) {
+                it->remove(entry);
+                if (it->isEmpty()) {
+                    postings.erase(it);
+                }
+            }
+        }
+    }
+
+    for (auto& unindexed : m_unindexed) {
+        unindexed.remove(entry);
+    }
+}
+
+void EntrySearchIndex::updateDirtyEntries()
+{
+    for (auto entry : asConst(m_dirty)) {
+        unindexEntry(entry);
+        indexEntry(entry);
+    }
+    m_dirty.clear();
+}
+
+EntrySearchIndex::TrigramSet EntrySearchIndex::trigrams(const QString& text)
+{
+    // Case folding keeps the index usable for case-sensitive and insensitive searches
+    const QString folded = text.toCaseFolded();
+
+    TrigramSet result;
+    for (int i = 0; i + 2 < folded.length(); ++i) {
+        result.insert(static_cast<Trigram>(folded.at(i).unicode()) << 32
+                      | static_cast<Trigram>(folded.at(i + 1).unicode()) << 16
+                      | static_cast<Trigram>(folded.at(i + 2).unicode()));
+    }
+    return result;
+}
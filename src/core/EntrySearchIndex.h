@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ENTRYSEARCHINDEX_H
+#define KEEPASSXC_ENTRYSEARCHINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include "core/EntrySearcher.h"
+
+/**
+ * Trigram index over the searchable fields of the entries of a database.
+ *
+ * The index only narrows down the entries a search has to look at, the
+ * EntrySearcher still applies the exact search terms to every candidate.
+ * Fields containing placeholders are not indexed and always reported as
+ * candidates. Modified entries are re-indexed lazily on the next query.
+ */
+class EntrySearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EntrySearchIndex(bool includeProtected = false, QObject* parent = nullptr);
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+    bool includesProtected() const;
+    int size() const;
+
+    bool candidates(const QList<EntrySearcher::SearchTerm>& terms, bool skipProtected, QSet<const Entry*>& result);
+
+private:
+    enum IndexedField
+    {
+        Title,
+        Username,
+        Password,
+        Url,
+        Notes,
+        Tags,
+        FieldCount
+    };
+
+    using Trigram = quint64;
+    using TrigramSet = QSet<Trigram>;
+
+    void indexEntry(const Entry* entry);
+    void unindexEntry(const Entry* entry);
+    void updateDirtyEntries();
+    bool termCandidates(const EntrySearcher::SearchTerm& term, bool skipProtected, QSet<const Entry*>& result) const;
+    QSet<const Entry*> fieldCandidates(IndexedField field, const TrigramSet& trigrams) const;
+
+    static TrigramSet trigrams(const QString& text);
+
+    bool m_includeProtected;
+    QHash<const Entry*, QVector<TrigramSet>> m_entryTrigrams;
+    QHash<Trigram, QSet<const Entry*>> m_postings[FieldCount];
+    QSet<const Entry*> m_unindexed[FieldCount];
+    QSet<const Entry*> m_dirty;
+};
+
+#endif // KEEPASSXC_ENTRYSEARCHINDEX_H
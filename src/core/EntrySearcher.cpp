@@ -19,12 +19,23 @@
 #include "EntrySearcher.h"
 
 #include "PasswordHealth.h"
+#include "core/EntrySearchIndex.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+namespace
+{
+    // Below this amount of entries per thread the overhead outweighs the gain
+    constexpr int MinEntriesPerThread = 1000;
+} // namespace
+
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
+    , m_threadCount(1)
 {
 }
 
@@ -69,17 +80,25 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
 {
     Q_ASSERT(baseGroup);
 
-    QList<Entry*> results;
+    // Narrow down the entries to evaluate if the database maintains a search index
+    QSet<const Entry*> candidates;
+    bool useCandidates = false;
+    auto index = searchIndex(baseGroup);
+    if (index) {
+        useCandidates = index->candidates(m_searchTerms, m_skipProtected, candidates);
+    }
+
+    QList<Entry*> entries;
     for (const auto group : baseGroup->groupsRecursive(true)) {
         if (forceSearch || group->resolveSearchingEnabled()) {
             for (const auto entry : group->entries()) {
-                if (searchEntryImpl(entry)) {
-                    results.append(entry);
+                if (!useCandidates || candidates.contains(entry)) {
+                    entries.append(entry);
                 }
             }
         }
     }
-    return results;
+    return repeatEntries(entries);
 }
 
 /**
@@ -117,12 +136,27 @@ QList<Entry*> EntrySearcher::searchEntries(const QString& searchString, const QL
  */
 QList<Entry*> EntrySearcher::repeatEntries(const QList<Entry*>& entries)
 {
+    const int threads = qMin(threadCount(), entries.size() / MinEntriesPerThread);
+    if (threads <= 1) {
+        return searchRange(entries, 0, entries.size());
+    }
+
+    // Split the entries into one contiguous chunk per thread, the calling thread
+    // searches the last chunk itself. Concatenating the chunks in order keeps the
+    // results in the same order as a sequential search.
+    const int chunkSize = (entries.size() + threads - 1) / threads;
+    QList<QFuture<QList<Entry*>>> futures;
+    for (int begin = 0; begin + chunkSize < entries.size(); begin += chunkSize) {
+        futures.append(QtConcurrent::run(
+            [this, &entries, begin, chunkSize] { return searchRange(entries, begin, begin + chunkSize); }));
+    }
+    const auto lastChunk = searchRange(entries, futures.size() * chunkSize, entries.size());
+
     QList<Entry*> results;
-    for (auto* entry : entries) {
-        if (searchEntryImpl(entry)) {
-            results.append(entry);
-        }
+    for (auto& future : futures) {
+        results.append(future.result());
     }
+    results.append(lastChunk);
     return results;
 }
 
@@ -141,17 +175,61 @@ bool EntrySearcher::isCaseSensitive() const
     return m_caseSensitive;
 }
 
-bool EntrySearcher::searchEntryImpl(const Entry* entry)
+/**
+ * Set the number of threads used to evaluate the search terms.
+ * Small searches always run on the calling thread.
+ *
+ * @param count maximum number of threads, 0 to use one per core
+ */
+void EntrySearcher::setThreadCount(int count)
+{
+    m_threadCount = qMax(0, count);
+}
+
+int EntrySearcher::threadCount() const
 {
-    // Pre-load in case they are needed
-    auto attributes_keys = entry->attributes()->customKeys();
-    auto attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
-    auto attachments = QStringList(entry->attachments()->keys());
-    // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
-    QString hierarchy;
-    if (entry->group()) {
-        hierarchy = entry->group()->hierarchy().join('/').prepend("/");
+    return m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+}
+
+/**
+ * Returns the search index covering the given group or nullptr
+ * if its database does not maintain one.
+ */
+EntrySearchIndex* EntrySearcher::searchIndex(const Group* baseGroup)
+{
+    auto db = baseGroup->database();
+    if (!db || !db->searchIndex()) {
+        return nullptr;
+    }
+
+    // The index only covers groups that are part of the database tree
+    auto group = baseGroup;
+    while (group->parentGroup()) {
+        group = group->parentGroup();
+    }
+    return group == db->rootGroup() ? db->searchIndex() : nullptr;
+}
+
+QList<Entry*> EntrySearcher::searchRange(const QList<Entry*>& entries, int begin, int end) const
+{
+    QList<Entry*> results;
+    for (int i = begin; i < end; ++i) {
+        if (searchEntryImpl(entries.at(i))) {
+            results.append(entries.at(i));
+        }
     }
+    return results;
+}
+
+bool EntrySearcher::searchEntryImpl(const Entry* entry) const
+{
+    // Load lazily, most searches never need these
+    QStringList attributes;
+    QStringList attachments;
+    QString hierarchy;
+    bool attributesLoaded = false;
+    bool attachmentsLoaded = false;
+    bool hierarchyLoaded = false;
 
     // By default, empty term matches every entry.
     // However when skipping protected fields, we will reject everything instead
@@ -177,9 +255,18 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
             found = term.regex.match(entry->notes()).hasMatch();
             break;
         case Field::AttributeKV:
+            if (!attributesLoaded) {
+                auto attributesKeys = entry->attributes()->customKeys();
+                attributes = attributesKeys + entry->attributes()->values(attributesKeys);
+                attributesLoaded = true;
+            }
             found = !attributes.filter(term.regex).empty();
             break;
         case Field::Attachment:
+            if (!attachmentsLoaded) {
+                attachments = entry->attachments()->keys();
+                attachmentsLoaded = true;
+            }
             found = !attachments.filter(term.regex).empty();
             break;
         case Field::AttributeValue:
@@ -192,6 +279,11 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
         case Field::Group:
             // Match against the full hierarchy if the word contains a '/' otherwise just the group name
             if (term.word.contains('/')) {
+                // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
+                if (!hierarchyLoaded && entry->group()) {
+                    hierarchy = entry->group()->hierarchy().join('/').prepend("/");
+                }
+                hierarchyLoaded = true;
                 found = term.regex.match(hierarchy).hasMatch();
             } else if (entry->group()) {
                 found = term.regex.match(entry->group()->name()).hasMatch();
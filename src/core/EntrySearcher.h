@@ -23,6 +23,7 @@
 
 class Group;
 class Entry;
+class EntrySearchIndex;
 
 class EntrySearcher
 {
@@ -65,13 +66,18 @@ public:
 
     void setCaseSensitive(bool state);
     bool isCaseSensitive() const;
+    void setThreadCount(int count);
+    int threadCount() const;
 
 private:
-    bool searchEntryImpl(const Entry* entry);
+    static EntrySearchIndex* searchIndex(const Group* baseGroup);
+    QList<Entry*> searchRange(const QList<Entry*>& entries, int begin, int end) const;
+    bool searchEntryImpl(const Entry* entry) const;
     void parseSearchTerms(const QString& searchString);
 
     bool m_caseSensitive;
     bool m_skipProtected;
+    int m_threadCount;
     QList<SearchTerm> m_searchTerms;
 
     friend class TestEntrySearcher;
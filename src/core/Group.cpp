@@ -74,6 +74,10 @@ Group::~Group()
         m_db->addDeletedObject(delGroup);
     }
 
+    if (m_db) {
+        m_db->unregisterGroup(this);
+    }
+
     cleanupParent();
 }
 
@@ -350,7 +354,18 @@ bool Group::equals(const Group* other, CompareItemOptions options) const
 
 void Group::setUuid(const QUuid& uuid)
 {
+    if (m_uuid == uuid) {
+        return;
+    }
+
+    bool indexed = isUuidIndexed();
+    if (indexed) {
+        m_db->unregisterGroup(this);
+    }
     set(m_uuid, uuid);
+    if (indexed) {
+        m_db->registerGroup(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -626,6 +641,16 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
+    if (isUuidIndexed()) {
+        const auto candidates = m_db->m_entryUuidIndex.values(uuid);
+        for (auto entry : candidates) {
+            if (entry->group() == this || (recursive && isAncestorOf(entry->group()))) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
     auto entries = m_entries;
     if (recursive) {
         entries = entriesRecursive(false);
@@ -661,6 +686,10 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
+    if (referenceType == EntryReferenceType::QUuid) {
+        return findEntryByUuid(QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1())));
+    }
+
     const QList<Group*> groups = groupsRecursive(true);
 
     for (const Group* group : groups) {
@@ -889,6 +918,16 @@ Group* Group::findGroupByUuid(const QUuid& uuid)
         return nullptr;
     }
 
+    if (isUuidIndexed()) {
+        const auto candidates = m_db->m_groupUuidIndex.values(uuid);
+        for (auto group : candidates) {
+            if (group == this || isAncestorOf(group)) {
+                return group;
+            }
+        }
+        return nullptr;
+    }
+
     for (Group* group : groupsRecursive(true)) {
         if (group->uuid() == uuid) {
             return group;
@@ -900,17 +939,28 @@ Group* Group::findGroupByUuid(const QUuid& uuid)
 
 const Group* Group::findGroupByUuid(const QUuid& uuid) const
 {
-    if (uuid.isNull()) {
-        return nullptr;
-    }
+    return const_cast<Group*>(this)->findGroupByUuid(uuid);
+}
 
-    for (const Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
+/**
+ * Returns true if the database uuid index covers this group and its descendants.
+ * Groups that are not attached to the database tree (e.g. a replaced root group)
+ * fall back to walking the tree.
+ */
+bool Group::isUuidIndexed() const
+{
+    return m_db && m_db->m_groupUuidIndex.contains(m_uuid, const_cast<Group*>(this));
+}
+
+bool Group::isAncestorOf(const Group* group) const
+{
+    while (group) {
+        group = group->m_parent;
+        if (group == this) {
+            return true;
         }
     }
-
-    return nullptr;
+    return false;
 }
 
 Group* Group::findChildByName(const QString& name)
@@ -995,6 +1045,7 @@ void Group::addEntry(Entry* entry)
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
         connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        m_db->registerEntry(entry);
     }
 
     emitModified();
@@ -1012,6 +1063,7 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->unregisterEntry(entry);
     }
     m_entries.removeAll(entry);
     emitModified();
@@ -1048,18 +1100,23 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
 {
     if (m_db) {
         disconnect(m_db);
+        m_db->unregisterGroup(this);
     }
 
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            m_db->unregisterEntry(entry);
         }
         if (db) {
             connect(entry, &Entry::modified, db, &Database::markAsModified);
+            db->registerEntry(entry);
         }
     }
 
     if (db) {
+        db->registerGroup(this);
+
         // clang-format off
         connect(this, &Group::groupDataChanged, db, &Database::groupDataChanged);
         connect(this, &Group::groupAboutToRemove, db, &Database::groupAboutToRemove);
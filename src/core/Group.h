@@ -209,6 +209,8 @@ private:
     void setParent(Database* db);
 
     void connectDatabaseSignalsRecursive(Database* db);
+    bool isUuidIndexed() const;
+    bool isAncestorOf(const Group* group) const;
     void cleanupParent();
     void recCreateDelObjects();
 
@@ -20,130 +20,523 @@
 #include "core/Group.h"
 
 #include <QCryptographicHash>
-#include <QProcess>
+#include <QFileDevice>
+#include <QSet>
+#include <QVector>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
 
 namespace HibpOffline
 {
-    const std::size_t SHA1_BYTES = 20;
+    const int SHA1_BYTES = 20;
+    const int SHA1_HEX_CHARS = SHA1_BYTES * 2;
+    const qint64 READ_CHUNK_SIZE = 1024 * 1024;
+    // Number of lines probed to decide whether a mapped file is sorted by hash
+    const int SORT_CHECK_SAMPLES = 256;
+
+    const char INDEX_MAGIC[] = "KPXCHIBP";
+    const int INDEX_MAGIC_SIZE = 8;
+    const quint32 INDEX_VERSION = 1;
+    const int INDEX_HEADER_SIZE = 32;
+    // The first two bytes of each hash are implied by its fan-out bucket
+    const int INDEX_PREFIX_BYTES = 2;
+    const int INDEX_MIN_HASH_BYTES = 6;
+    const int INDEX_FANOUT_ENTRIES = 65536 + 1;
+    const qint64 INDEX_FANOUT_SIZE = INDEX_FANOUT_ENTRIES * 8;
 
     enum class ParseResult
     {
         Ok,
-        Eof,
+        Empty,
         Error
     };
 
-    ParseResult parseHibpLine(QIODevice& input, QByteArray& sha1, int& count)
+    int hexValue(char c)
     {
-        QByteArray hexSha1(SHA1_BYTES * 2, '\0');
-        const qint64 rc = input.read(hexSha1.data(), hexSha1.size());
-        if (rc == 0) {
-            return ParseResult::Eof;
-        } else if (rc != hexSha1.size()) {
-            return ParseResult::Error;
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        } else if ('A' <= c && c <= 'F') {
+            return c - 'A' + 10;
+        } else if ('a' <= c && c <= 'f') {
+            return c - 'a' + 10;
         }
+        return -1;
+    }
 
-        sha1 = QByteArray::fromHex(hexSha1);
-
-        char c;
-        if (!input.getChar(&c) || c != ':') {
+    /**
+     * Parse a single "SHA1:COUNT" line without its line terminator. The hash is
+     * decoded into the SHA1_BYTES sized buffer sha1.
+     */
+    ParseResult parseHibpLine(const char* line, qint64 length, char* sha1, int& count)
+    {
+        while (length > 0 && line[length - 1] == '\r') {
+            --length;
+        }
+        if (length == 0) {
+            return ParseResult::Empty;
+        }
+        if (length <= SHA1_HEX_CHARS || line[SHA1_HEX_CHARS] != ':') {
             return ParseResult::Error;
         }
 
-        count = 0;
-        while (true) {
-            if (!input.getChar(&c)) {
+        for (int i = 0; i < SHA1_BYTES; ++i) {
+            const int high = hexValue(line[2 * i]);
+            const int low = hexValue(line[2 * i + 1]);
+            if (high < 0 || low < 0) {
                 return ParseResult::Error;
             }
+            sha1[i] = static_cast<char>((high << 4) | low);
+        }
 
-            if (c == '\n' || c == '\r') {
-                break;
-            }
-
+        count = 0;
+        for (qint64 i = SHA1_HEX_CHARS + 1; i < length; ++i) {
+            const char c = line[i];
             if (!('0' <= c && c <= '9')) {
                 return ParseResult::Error;
             }
-
             count *= 10;
             count += (c - '0');
         }
 
-        while (1 == input.peek(&c, 1) && (c == '\n' || c == '\r')) {
-            input.getChar(&c);
-        }
-
         return ParseResult::Ok;
     }
 
-    bool
-    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    /**
+     * Scan all complete lines in [data, data + size) and pass each hash and its
+     * count to onLine. Lines are split with memchr, which the C library
+     * implements with vector instructions. Returns the number of bytes
+     * consumed, which is less than size if the last line is not terminated
+     * and atEnd is false, or -1 on a parse error or if onLine returns false.
+     */
+    template <typename LineHandler>
+    qint64 scanHibpData(const char* data, qint64 size, bool atEnd, quint64& lineNum, LineHandler onLine)
     {
-        QMultiHash<QByteArray, const Entry*> entriesBySha1;
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-            if (!entry->isRecycled()) {
-                const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
-                entriesBySha1.insert(sha1, entry);
+        char sha1[SHA1_BYTES];
+
+        qint64 pos = 0;
+        while (pos < size) {
+            const auto* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            if (!newline && !atEnd) {
+                break;
             }
-        }
+            const qint64 end = newline ? newline - data : size;
 
-        QByteArray sha1;
-        for (quint64 lineNum = 1;; ++lineNum) {
+            ++lineNum;
             int count = 0;
-
-            switch (parseHibpLine(hibpInput, sha1, count)) {
-            case ParseResult::Eof:
-                return true;
+            switch (parseHibpLine(data + pos, end - pos, sha1, count)) {
             case ParseResult::Error:
-                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
-                return false;
+                return -1;
+            case ParseResult::Ok:
+                if (!onLine(sha1, count)) {
+                    return -1;
+                }
+                break;
             default:
                 break;
             }
 
-            for (const auto* entry : entriesBySha1.values(sha1)) {
-                findings.append({entry, count});
+            pos = newline ? end + 1 : size;
+        }
+        return pos;
+    }
+
+    /**
+     * Stream the HIBP text file in input through scanHibpData. If onLine fails
+     * it is responsible for setting error.
+     */
+    template <typename LineHandler> bool scanHibpDevice(QIODevice& input, LineHandler onLine, QString* error)
+    {
+        QByteArray buffer;
+        quint64 lineNum = 0;
+        while (true) {
+            const int previous = buffer.size();
+            buffer.resize(previous + READ_CHUNK_SIZE);
+            const qint64 rc = input.read(buffer.data() + previous, READ_CHUNK_SIZE);
+            if (rc < 0) {
+                *error = QObject::tr("Failed to read HIBP file: %1").arg(input.errorString());
+                return false;
+            }
+            buffer.resize(previous + rc);
+
+            const bool atEnd = rc == 0;
+            const qint64 consumed = scanHibpData(buffer.constData(), buffer.size(), atEnd, lineNum, onLine);
+            if (consumed < 0) {
+                if (error->isEmpty()) {
+                    *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                }
+                return false;
+            }
+            if (atEnd) {
+                return true;
             }
+            buffer.remove(0, consumed);
         }
     }
 
-    bool okonReport(QSharedPointer<Database> db,
-                    const QString& okon,
-                    const QString& okonDatabase,
-                    QList<QPair<const Entry*, int>>& findings,
-                    QString* error)
+    /**
+     * Sorted, memory mapped HIBP file as distributed by haveibeenpwned.com.
+     */
+    class SortedHibpData
     {
-        if (!okonDatabase.endsWith(".okon")) {
-            *error = QObject::tr("To use okon, you must provide a post-processed file (e.g. file.okon)");
+    public:
+        SortedHibpData(const char* data, qint64 size)
+            : m_data(data)
+            , m_size(size)
+        {
+        }
+
+        /**
+         * Probe lines spread evenly across the file and check that their hashes
+         * are ascending. Files with a parse error are reported as unsorted so the
+         * line scanner can report the error with its line number.
+         */
+        bool looksSorted() const
+        {
+            QByteArray previous;
+            for (int i = 0; i <= SORT_CHECK_SAMPLES; ++i) {
+                qint64 start, end;
+                lineAt(qMin(m_size - 1, m_size * i / SORT_CHECK_SAMPLES), start, end);
+
+                char sha1[SHA1_BYTES];
+                int count;
+                if (parseHibpLine(m_data + start, end - start, sha1, count) != ParseResult::Ok) {
+                    return false;
+                }
+
+                QByteArray current(sha1, SHA1_BYTES);
+                if (current < previous) {
+                    return false;
+                }
+                previous = current;
+            }
+            return true;
+        }
+
+        /**
+         * Binary search for the hash sha1. Returns Ok and sets count if found,
+         * Empty if the hash is not listed and Error on malformed input.
+         */
+        ParseResult find(const QByteArray& sha1, int& count) const
+        {
+            // lo is always the start of a line
+            qint64 lo = 0;
+            qint64 hi = m_size;
+            while (lo < hi) {
+                qint64 start, end;
+                lineAt(lo + (hi - lo) / 2, start, end);
+
+                char lineSha1[SHA1_BYTES];
+                if (parseHibpLine(m_data + start, end - start, lineSha1, count) != ParseResult::Ok) {
+                    return ParseResult::Error;
+                }
+
+                const int cmp = std::memcmp(lineSha1, sha1.constData(), SHA1_BYTES);
+                if (cmp == 0) {
+                    return ParseResult::Ok;
+                } else if (cmp < 0) {
+                    lo = end + 1;
+                } else {
+                    hi = start;
+                }
+            }
+            return ParseResult::Empty;
+        }
+
+    private:
+        // Find the bounds of the line containing pos, excluding the line terminator
+        void lineAt(qint64 pos, qint64& start, qint64& end) const
+        {
+            start = pos;
+            while (start > 0 && m_data[start - 1] != '\n') {
+                --start;
+            }
+            const auto* newline = static_cast<const char*>(std::memchr(m_data + pos, '\n', m_size - pos));
+            end = newline ? newline - m_data : m_size;
+        }
+
+        const char* m_data;
+        qint64 m_size;
+    };
+
+    /**
+     * Memory mapped binary index written by buildIndex(). Layout, all integers
+     * little endian:
+     *
+     *   header:  "KPXCHIBP", quint32 version, quint32 hash bytes, 16 reserved bytes
+     *   records: hash bytes after the two byte prefix, quint32 count
+     *   fan-out: 65537 quint64 record indices, one per two byte prefix and the record count
+     */
+    class IndexFile
+    {
+    public:
+        bool open(const char* data, qint64 size, QString* error)
+        {
+            const auto* header = reinterpret_cast<const uchar*>(data);
+            const auto version = qFromLittleEndian<quint32>(header + INDEX_MAGIC_SIZE);
+            m_hashBytes = static_cast<int>(qFromLittleEndian<quint32>(header + INDEX_MAGIC_SIZE + 4));
+            if (version != INDEX_VERSION) {
+                *error = QObject::tr("Unsupported HIBP index version: %1").arg(version);
+                return false;
+            }
+            if (m_hashBytes < INDEX_MIN_HASH_BYTES || m_hashBytes > SHA1_BYTES
+                || size < INDEX_HEADER_SIZE + INDEX_FANOUT_SIZE) {
+                *error = QObject::tr("HIBP index is corrupted");
+                return false;
+            }
+
+            m_recordSize = m_hashBytes - INDEX_PREFIX_BYTES + 4;
+            m_records = header + INDEX_HEADER_SIZE;
+            m_fanout = header + size - INDEX_FANOUT_SIZE;
+
+            // Validate the fan-out once so lookups can trust it
+            const auto recordCount = fanout(INDEX_FANOUT_ENTRIES - 1);
+            quint64 previous = 0;
+            for (int i = 0; i < INDEX_FANOUT_ENTRIES; ++i) {
+                const auto current = fanout(i);
+                if (current < previous || current > recordCount) {
+                    *error = QObject::tr("HIBP index is corrupted");
+                    return false;
+                }
+                previous = current;
+            }
+            if (recordCount > static_cast<quint64>(size / m_recordSize)
+                || INDEX_HEADER_SIZE + recordCount * m_recordSize + INDEX_FANOUT_SIZE != static_cast<quint64>(size)) {
+                *error = QObject::tr("HIBP index is corrupted");
+                return false;
+            }
+            return true;
+        }
+
+        bool find(const QByteArray& sha1, int& count) const
+        {
+            const auto* hash = reinterpret_cast<const uchar*>(sha1.constData());
+            const int prefix = (hash[0] << 8) | hash[1];
+            const int keySize = m_hashBytes - INDEX_PREFIX_BYTES;
+
+            quint64 lo = fanout(prefix);
+            quint64 hi = fanout(prefix + 1);
+            while (lo < hi) {
+                const quint64 mid = lo + (hi - lo) / 2;
+                const auto* record = m_records + mid * m_recordSize;
+                const int cmp = std::memcmp(record, hash + INDEX_PREFIX_BYTES, keySize);
+                if (cmp == 0) {
+                    count = static_cast<int>(qFromLittleEndian<quint32>(record + keySize));
+                    return true;
+                } else if (cmp < 0) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
             return false;
         }
 
-        QProcess okonProcess;
+    private:
+        quint64 fanout(int i) const
+        {
+            return qFromLittleEndian<quint64>(m_fanout + i * 8);
+        }
 
+        int m_hashBytes = SHA1_BYTES;
+        int m_recordSize = 0;
+        const uchar* m_records = nullptr;
+        const uchar* m_fanout = nullptr;
+    };
+
+    bool isIndex(const char* data, qint64 size)
+    {
+        return size >= INDEX_HEADER_SIZE && std::memcmp(data, INDEX_MAGIC, INDEX_MAGIC_SIZE) == 0;
+    }
+
+    bool
+    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    {
+        QList<QPair<const Entry*, QByteArray>> entries;
+        QSet<QByteArray> wanted;
         for (const auto* entry : db->rootGroup()->entriesRecursive()) {
             if (!entry->isRecycled()) {
                 const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
-                okonProcess.start(okon, {"--path", okonDatabase, "--hash", QString::fromLatin1(sha1.toHex())});
-                if (!okonProcess.waitForStarted()) {
-                    *error = QObject::tr("Could not start okon process: %1").arg(okon);
+                entries.append({entry, sha1});
+                wanted.insert(sha1);
+            }
+        }
+
+        QHash<QByteArray, int> pwned;
+        bool searched = false;
+        auto collect = [&wanted, &pwned](const char* sha1, int count) {
+            const auto sha1Key = QByteArray::fromRawData(sha1, SHA1_BYTES);
+            if (wanted.contains(sha1Key)) {
+                pwned.insert(QByteArray(sha1, SHA1_BYTES), count);
+            }
+            return true;
+        };
+
+        // Map regular files into memory. Binary indexes and the official dumps
+        // are sorted by hash, which allows a binary search instead of reading
+        // gigabytes of text.
+        auto* file = qobject_cast<QFileDevice*>(&hibpInput);
+        uchar* mapped = nullptr;
+        if (file && file->isReadable() && file->pos() == 0 && file->size() > 0) {
+            mapped = file->map(0, file->size());
+        }
+        if (mapped) {
+            const auto* data = reinterpret_cast<const char*>(mapped);
+            const qint64 size = file->size();
+
+            if (isIndex(data, size)) {
+                IndexFile index;
+                if (!index.open(data, size, error)) {
+                    file->unmap(mapped);
                     return false;
                 }
+                for (const auto& sha1 : wanted) {
+                    int count = 0;
+                    if (index.find(sha1, count)) {
+                        pwned.insert(sha1, count);
+                    }
+                }
+                searched = true;
+            } else {
+                SortedHibpData sorted(data, size);
+                if (sorted.looksSorted()) {
+                    searched = true;
+                    for (auto it = wanted.constBegin(); it != wanted.constEnd() && searched; ++it) {
+                        int count = 0;
+                        switch (sorted.find(*it, count)) {
+                        case ParseResult::Ok:
+                            pwned.insert(*it, count);
+                            break;
+                        case ParseResult::Error:
+                            // Fall back to a full scan, which reports the line number
+                            pwned.clear();
+                            searched = false;
+                            break;
+                        default:
+                            break;
+                        }
+                    }
+                }
+            }
 
-                if (!okonProcess.waitForFinished()) {
-                    *error = QObject::tr("Error: okon process did not finish");
+            if (!searched) {
+                quint64 lineNum = 0;
+                if (scanHibpData(data, size, true, lineNum, collect) < 0) {
+                    *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                    file->unmap(mapped);
                     return false;
                 }
+                searched = true;
+            }
+            file->unmap(mapped);
+        } else {
+            if (hibpInput.peek(INDEX_MAGIC_SIZE) == QByteArray::fromRawData(INDEX_MAGIC, INDEX_MAGIC_SIZE)) {
+                *error = QObject::tr("HIBP index files must be regular files that can be memory mapped");
+                return false;
+            }
+        }
+
+        if (!searched && !scanHibpDevice(hibpInput, collect, error)) {
+            return false;
+        }
+
+        for (const auto& entry : entries) {
+            if (pwned.contains(entry.second)) {
+                findings.append({entry.first, pwned.value(entry.second)});
+            }
+        }
+        return true;
+    }
+
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, int hashBytes, QString* error)
+    {
+        if (hashBytes < INDEX_MIN_HASH_BYTES || hashBytes > SHA1_BYTES) {
+            *error = QObject::tr("Hash length must be between %1 and %2 bytes").arg(INDEX_MIN_HASH_BYTES).arg(SHA1_BYTES);
+            return false;
+        }
+
+        QByteArray header(INDEX_HEADER_SIZE, '\0');
+        auto* headerData = reinterpret_cast<uchar*>(header.data());
+        std::memcpy(headerData, INDEX_MAGIC, INDEX_MAGIC_SIZE);
+        qToLittleEndian<quint32>(INDEX_VERSION, headerData + INDEX_MAGIC_SIZE);
+        qToLittleEndian<quint32>(static_cast<quint32>(hashBytes), headerData + INDEX_MAGIC_SIZE + 4);
+        if (indexOutput.write(header) != header.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
+        }
+
+        // Records are buffered and written in large blocks. Hashes that collide
+        // after truncation are merged into a single record.
+        const int keySize = hashBytes - INDEX_PREFIX_BYTES;
+        const int recordSize = keySize + 4;
+        QVector<quint64> fanout(INDEX_FANOUT_ENTRIES, 0);
+        QByteArray records;
+        QByteArray previous;
+        quint64 previousCount = 0;
 
-                switch (okonProcess.exitCode()) {
-                case 1:
-                    findings.append({entry, -1});
-                    break;
-                case 2:
-                    *error = QObject::tr("Failed to load okon processed database: %1").arg(okonDatabase);
+        auto flushRecords = [&records, &indexOutput, error]() {
+            if (indexOutput.write(records) != records.size()) {
+                *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+                return false;
+            }
+            records.clear();
+            return true;
+        };
+        auto appendRecord = [&]() {
+            uchar count[4];
+            qToLittleEndian<quint32>(static_cast<quint32>(qMin<quint64>(previousCount, std::numeric_limits<int>::max())), count);
+            records.append(previous.constData() + INDEX_PREFIX_BYTES, keySize);
+            records.append(reinterpret_cast<const char*>(count), sizeof(count));
+            const auto* hash = reinterpret_cast<const uchar*>(previous.constData());
+            ++fanout[((hash[0] << 8) | hash[1]) + 1];
+            return records.size() < READ_CHUNK_SIZE || flushRecords();
+        };
+
+        auto addLine = [&](const char* sha1, int count) {
+            const auto current = QByteArray::fromRawData(sha1, hashBytes);
+            if (!previous.isEmpty()) {
+                if (current < previous) {
+                    *error = QObject::tr("HIBP file is not sorted by hash, download the file ordered by hash");
+                    return false;
+                }
+                if (current == previous) {
+                    previousCount += count;
+                    return true;
+                }
+                if (!appendRecord()) {
                     return false;
                 }
             }
+            previous = QByteArray(sha1, hashBytes);
+            previousCount = count;
+            return true;
+        };
+
+        if (!scanHibpDevice(hibpInput, addLine, error)) {
+            return false;
+        }
+        if (!previous.isEmpty() && !appendRecord()) {
+            return false;
+        }
+        if (!flushRecords()) {
+            return false;
+        }
+
+        // Turn the per-prefix record counts into starting indices
+        QByteArray fanoutData(INDEX_FANOUT_SIZE, '\0');
+        auto* fanoutBytes = reinterpret_cast<uchar*>(fanoutData.data());
+        for (int i = 0; i < INDEX_FANOUT_ENTRIES; ++i) {
+            if (i > 0) {
+                fanout[i] += fanout[i - 1];
+            }
+            qToLittleEndian<quint64>(fanout[i], fanoutBytes + i * 8);
         }
 
+        if (indexOutput.write(fanoutData) != fanoutData.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
+        }
         return true;
     }
 } // namespace HibpOffline
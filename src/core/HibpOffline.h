@@ -32,11 +32,7 @@ namespace HibpOffline
                 QList<QPair<const Entry*, int>>& findings,
                 QString* error);
 
-    bool okonReport(QSharedPointer<Database> db,
-                    const QString& okon,
-                    const QString& okonDatabase,
-                    QList<QPair<const Entry*, int>>& findings,
-                    QString* error);
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, int hashBytes, QString* error);
 } // namespace HibpOffline
 
 #endif // KEEPASSXC_HIBPOFFLINE_H
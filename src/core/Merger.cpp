@@ -21,6 +21,75 @@
 #include "core/Metadata.h"
 #include "core/Tools.h"
 
+#include <QMetaEnum>
+
+#include <algorithm>
+
+/**
+ * Planned state of the target database, used to decide on later
+ * changes without modifying the target while planning.
+ */
+struct Merger::PlanState
+{
+    struct Item
+    {
+        QUuid parent;
+        QDateTime lastModified;
+        QString name;
+        // Number of entries and child groups, only used for groups
+        int size = 0;
+    };
+
+    QHash<QUuid, Item> entries;
+    QHash<QUuid, Item> groups;
+
+    void move(QHash<QUuid, Item>& items, const QUuid& uuid, const QUuid& parent)
+    {
+        const auto oldParent = items.value(uuid).parent;
+        if (groups.contains(oldParent)) {
+            --groups[oldParent].size;
+        }
+        ++groups[parent].size;
+        items[uuid].parent = parent;
+    }
+
+    void remove(QHash<QUuid, Item>& items, const QUuid& uuid)
+    {
+        const auto parent = items.take(uuid).parent;
+        if (groups.contains(parent)) {
+            --groups[parent].size;
+        }
+    }
+};
+
+QVariantMap Merger::Change::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert("type", QString::fromLatin1(QMetaEnum::fromType<ChangeType>().valueToKey(static_cast<int>(type))));
+    if (!uuid.isNull()) {
+        map.insert("uuid", Tools::uuidToHex(uuid));
+    }
+    if (!groupUuid.isNull()) {
+        map.insert("group", Tools::uuidToHex(groupUuid));
+    }
+    if (type == ChangeType::RemoveCustomData || type == ChangeType::SetCustomData) {
+        map.insert("key", key);
+    }
+    if (type == ChangeType::SetCustomData) {
+        map.insert("value", value);
+    }
+    if (type == ChangeType::DeletedObjects) {
+        QVariantList objects;
+        for (const auto& object : deletedObjects) {
+            objects.append(QVariantMap{{"uuid", Tools::uuidToHex(object.uuid)},
+                                       {"deletionTime", object.deletionTime.toString(Qt::ISODate)}});
+        }
+        map.insert("deletedObjects", objects);
+    }
+    map.insert("description", description);
+    return map;
+}
+
 Merger::Merger(const Database* sourceDb, Database* targetDb)
     : m_mode(Group::Default)
 {
@@ -66,103 +135,542 @@ void Merger::setSkipDatabaseCustomData(bool state)
 
 QStringList Merger::merge()
 {
+    return apply(plan());
+}
+
+/**
+ * Compute the changes a merge would make without modifying the target database.
+ *
+ * @return changes in the order they have to be applied
+ */
+Merger::ChangeList Merger::plan()
+{
+    indexDatabases();
+
+    PlanState state;
+    for (auto* entry : asConst(m_targetEntries)) {
+        state.entries.insert(entry->uuid(),
+                             {entry->group() ? entry->group()->uuid() : QUuid(),
+                              entry->timeInfo().lastModificationTime(),
+                              entry->title()});
+    }
+    for (auto* group : asConst(m_targetGroups)) {
+        state.groups.insert(group->uuid(),
+                            {group->parentGroup() ? group->parentGroup()->uuid() : QUuid(),
+                             group->timeInfo().lastModificationTime(),
+                             group->name(),
+                             group->entries().size() + group->children().size()});
+    }
+
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
     ChangeList changes;
-    changes << mergeGroup(m_context);
-    changes << mergeDeletions(m_context);
-    changes << mergeMetadata(m_context);
+    planGroup(m_context.m_sourceGroup, m_context.m_targetGroup->uuid(), state, changes);
+    planDeletions(state, changes);
+    planMetadata(changes);
+    return changes;
+}
+
+/**
+ * Apply planned changes to the target database in one batch.
+ * The modified signal of the target database is emitted at most once.
+ *
+ * @return descriptions of the applied changes
+ */
+QStringList Merger::apply(const ChangeList& changes)
+{
+    indexDatabases();
+
+    auto* targetDb = m_context.m_targetDb.data();
+    const bool emitModified = targetDb->modifiedSignalEnabled();
+    targetDb->setEmitModified(false);
+
+    // Entries replaced while merging are erased without a trace in the deleted objects
+    const auto deletedObjects = targetDb->deletedObjects();
+    bool deletedObjectsChanged = false;
+
+    QStringList applied;
+    for (const auto& change : changes) {
+        if (!applyChange(change)) {
+            qWarning("Merger::apply: skipping change that no longer applies: %s", qPrintable(change.description));
+            continue;
+        }
+        deletedObjectsChanged |= change.type == ChangeType::DeletedObjects;
+        applied << change.description;
+    }
+
+    if (!deletedObjectsChanged) {
+        targetDb->setDeletedObjects(deletedObjects);
+    }
+    targetDb->setEmitModified(emitModified);
 
     // At this point we have a list of changes we may want to show the user
-    if (!changes.isEmpty()) {
-        m_context.m_targetDb->markAsModified();
+    if (!applied.isEmpty()) {
+        targetDb->markAsModified();
+    }
+    m_sourceEntries.clear();
+    m_sourceGroups.clear();
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+    return applied;
+}
+
+/**
+ * Build the uuid lookup tables of both databases once, so that
+ * merging is a linear join of the source tree against the target.
+ */
+void Merger::indexDatabases()
+{
+    m_sourceEntries.clear();
+    m_sourceGroups.clear();
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+
+    // Keep the first match like Group::findEntryByUuid() and Group::findGroupByUuid()
+    const auto sourceEntries = m_context.m_sourceGroup->entriesRecursive(false);
+    for (const Entry* entry : sourceEntries) {
+        if (!m_sourceEntries.contains(entry->uuid())) {
+            m_sourceEntries.insert(entry->uuid(), entry);
+        }
+    }
+    const auto sourceGroups = m_context.m_sourceGroup->groupsRecursive(true);
+    for (const Group* group : sourceGroups) {
+        if (!m_sourceGroups.contains(group->uuid())) {
+            m_sourceGroups.insert(group->uuid(), group);
+        }
+    }
+    const auto targetEntries = m_context.m_targetRootGroup->entriesRecursive(false);
+    for (Entry* entry : targetEntries) {
+        if (!m_targetEntries.contains(entry->uuid())) {
+            m_targetEntries.insert(entry->uuid(), entry);
+        }
+    }
+    const auto targetGroups = m_context.m_targetRootGroup->groupsRecursive(true);
+    for (Group* group : targetGroups) {
+        if (!m_targetGroups.contains(group->uuid())) {
+            m_targetGroups.insert(group->uuid(), group);
+        }
     }
-    return changes;
 }
 
-Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
+void Merger::planGroup(const Group* sourceGroup, const QUuid& targetGroupUuid, PlanState& state, ChangeList& changes)
 {
-    ChangeList changes;
     // merge entries
-    const QList<Entry*> sourceEntries = context.m_sourceGroup->entries();
-    for (Entry* sourceEntry : sourceEntries) {
-        Entry* targetEntry = context.m_targetRootGroup->findEntryByUuid(sourceEntry->uuid());
-        if (!targetEntry) {
-            changes << tr("Creating missing %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
+    for (const Entry* sourceEntry : sourceGroup->entries()) {
+        const QUuid uuid = sourceEntry->uuid();
+        if (!state.entries.contains(uuid)) {
             // This entry does not exist at all. Create it.
-            targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
-            moveEntry(targetEntry, context.m_targetGroup);
+            Change change;
+            change.type = ChangeType::CreateEntry;
+            change.uuid = uuid;
+            change.groupUuid = targetGroupUuid;
+            change.description = tr("Creating missing %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
+            changes << change;
+            state.entries.insert(uuid, {{}, sourceEntry->timeInfo().lastModificationTime(), sourceEntry->title()});
+            state.move(state.entries, uuid, targetGroupUuid);
+            continue;
+        }
+
+        const Entry* targetEntry = m_targetEntries.value(uuid);
+        if (!targetEntry) {
+            // Duplicate uuid in the source, the entry has been created already
+            continue;
+        }
+
+        // Entry is already present in the database. Update it.
+        const bool locationChanged =
+            targetEntry->timeInfo().locationChanged() < sourceEntry->timeInfo().locationChanged();
+        if (locationChanged && state.entries.value(uuid).parent != targetGroupUuid) {
+            Change change;
+            change.type = ChangeType::RelocateEntry;
+            change.uuid = uuid;
+            change.groupUuid = targetGroupUuid;
+            change.description = tr("Relocating %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
+            changes << change;
+            state.move(state.entries, uuid, targetGroupUuid);
+        }
+
+        // We need to cut off the milliseconds since the persistent format only supports times down to seconds
+        // so when we import data from a remote source, it may represent the (or even some msec newer) data
+        // which may be discarded due to higher runtime precision
+        const int comparison = compare(targetEntry->timeInfo().lastModificationTime(),
+                                       sourceEntry->timeInfo().lastModificationTime(),
+                                       CompareItemIgnoreMilliseconds);
+        if (comparison < 0) {
+            Change change;
+            change.type = ChangeType::UpdateEntry;
+            change.uuid = uuid;
+            change.description =
+                tr("Synchronizing from newer source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
+            changes << change;
+            state.entries[uuid].lastModified = sourceEntry->timeInfo().lastModificationTime();
+            state.entries[uuid].name = sourceEntry->title();
         } else {
-            // Entry is already present in the database. Update it.
-            const bool locationChanged =
-                targetEntry->timeInfo().locationChanged() < sourceEntry->timeInfo().locationChanged();
-            if (locationChanged && targetEntry->group() != context.m_targetGroup) {
-                changes << tr("Relocating %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
-                moveEntry(targetEntry, context.m_targetGroup);
+            const int maxItems = m_context.m_targetDb->metadata()->historyMaxItems();
+            const auto history = mergedHistory(sourceEntry, targetEntry);
+            if (isHistoryChanged(targetEntry->historyItems(), history, maxItems)) {
+                Change change;
+                change.type = ChangeType::MergeEntryHistory;
+                change.uuid = uuid;
+                change.description =
+                    tr("Synchronizing from older source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
+                changes << change;
             }
-            changes << resolveEntryConflict(context, sourceEntry, targetEntry);
         }
     }
 
     // merge groups recursively
-    const QList<Group*> sourceChildGroups = context.m_sourceGroup->children();
-    for (Group* sourceChildGroup : sourceChildGroups) {
-        Group* targetChildGroup = context.m_targetRootGroup->findGroupByUuid(sourceChildGroup->uuid());
-        if (!targetChildGroup) {
-            changes << tr("Creating missing %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
-            targetChildGroup = sourceChildGroup->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
-            moveGroup(targetChildGroup, context.m_targetGroup);
-            TimeInfo timeinfo = targetChildGroup->timeInfo();
-            timeinfo.setLocationChanged(sourceChildGroup->timeInfo().locationChanged());
-            targetChildGroup->setTimeInfo(timeinfo);
-        } else {
-            bool locationChanged =
+    for (const Group* sourceChildGroup : sourceGroup->children()) {
+        const QUuid uuid = sourceChildGroup->uuid();
+        const Group* targetChildGroup = m_targetGroups.value(uuid);
+        if (!state.groups.contains(uuid)) {
+            Change change;
+            change.type = ChangeType::CreateGroup;
+            change.uuid = uuid;
+            change.groupUuid = targetGroupUuid;
+            change.description =
+                tr("Creating missing %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
+            changes << change;
+            state.groups.insert(uuid,
+                                {{}, sourceChildGroup->timeInfo().lastModificationTime(), sourceChildGroup->name()});
+            state.move(state.groups, uuid, targetGroupUuid);
+        } else if (targetChildGroup) {
+            const bool locationChanged =
                 targetChildGroup->timeInfo().locationChanged() < sourceChildGroup->timeInfo().locationChanged();
-            if (locationChanged && targetChildGroup->parent() != context.m_targetGroup) {
-                changes << tr("Relocating %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
-                moveGroup(targetChildGroup, context.m_targetGroup);
-                TimeInfo timeinfo = targetChildGroup->timeInfo();
-                timeinfo.setLocationChanged(sourceChildGroup->timeInfo().locationChanged());
-                targetChildGroup->setTimeInfo(timeinfo);
+            if (locationChanged && state.groups.value(uuid).parent != targetGroupUuid) {
+                Change change;
+                change.type = ChangeType::RelocateGroup;
+                change.uuid = uuid;
+                change.groupUuid = targetGroupUuid;
+                change.description =
+                    tr("Relocating %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
+                changes << change;
+                state.move(state.groups, uuid, targetGroupUuid);
+            }
+
+            // only if the other group is newer, update the existing one.
+            const QDateTime timeExisting = targetChildGroup->timeInfo().lastModificationTime();
+            const QDateTime timeOther = sourceChildGroup->timeInfo().lastModificationTime();
+            if (timeExisting < timeOther) {
+                Change change;
+                change.type = ChangeType::UpdateGroup;
+                change.uuid = uuid;
+                change.description =
+                    tr("Overwriting %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
+                changes << change;
+                state.groups[uuid].lastModified = timeOther;
+                state.groups[uuid].name = sourceChildGroup->name();
             }
-            changes << resolveGroupConflict(context, sourceChildGroup, targetChildGroup);
         }
-        MergeContext subcontext{context.m_sourceDb,
-                                context.m_targetDb,
-                                context.m_sourceRootGroup,
-                                context.m_targetRootGroup,
-                                sourceChildGroup,
-                                targetChildGroup};
-        changes << mergeGroup(subcontext);
+        planGroup(sourceChildGroup, uuid, state, changes);
     }
-    return changes;
 }
 
-Merger::ChangeList
-Merger::resolveGroupConflict(const MergeContext& context, const Group* sourceChildGroup, Group* targetChildGroup)
+void Merger::planDeletions(PlanState& state, ChangeList& changes)
 {
-    Q_UNUSED(context);
-    ChangeList changes;
+    Group::MergeMode mergeMode = m_mode == Group::Default ? m_context.m_targetGroup->mergeMode() : m_mode;
+    if (mergeMode != Group::Synchronize) {
+        // no deletions are applied for any other strategy!
+        return;
+    }
 
-    const QDateTime timeExisting = targetChildGroup->timeInfo().lastModificationTime();
-    const QDateTime timeOther = sourceChildGroup->timeInfo().lastModificationTime();
+    const auto& targetDeletions = m_context.m_targetDb->deletedObjects();
+    const auto& sourceDeletions = m_context.m_sourceDb->deletedObjects();
 
-    // only if the other group is newer, update the existing one.
-    if (timeExisting < timeOther) {
-        changes << tr("Overwriting %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
-        targetChildGroup->setName(sourceChildGroup->name());
-        targetChildGroup->setNotes(sourceChildGroup->notes());
-        if (sourceChildGroup->iconNumber() == 0) {
-            targetChildGroup->setIcon(sourceChildGroup->iconUuid());
+    QList<DeletedObject> deletions;
+    QHash<QUuid, DeletedObject> mergedDeletions;
+    QList<QUuid> entries;
+    QList<QPair<int, QUuid>> groups;
+
+    for (const auto& object : (targetDeletions + sourceDeletions)) {
+        auto mergedDeletion = mergedDeletions.find(object.uuid);
+        if (mergedDeletion == mergedDeletions.end()) {
+            mergedDeletions.insert(object.uuid, object);
+
+            if (state.entries.contains(object.uuid)) {
+                entries << object.uuid;
+                continue;
+            }
+            if (state.groups.contains(object.uuid)) {
+                int depth = 0;
+                for (auto parent = state.groups.value(object.uuid).parent; state.groups.contains(parent);
+                     parent = state.groups.value(parent).parent) {
+                    ++depth;
+                }
+                groups << qMakePair(depth, object.uuid);
+                continue;
+            }
+            deletions << object;
+            continue;
+        }
+        if (mergedDeletion->deletionTime > object.deletionTime) {
+            *mergedDeletion = object;
+        }
+    }
+
+    for (const auto& uuid : asConst(entries)) {
+        const auto& object = mergedDeletions[uuid];
+        const auto entry = state.entries.value(uuid);
+        if (entry.lastModified > object.deletionTime) {
+            // keep deleted entry since it was changed after deletion date
+            continue;
+        }
+        deletions << object;
+        Change change;
+        change.type = ChangeType::DeleteEntry;
+        change.uuid = uuid;
+        if (!entry.parent.isNull()) {
+            change.description = tr("Deleting child %1 [%2]").arg(entry.name, Tools::uuidToHex(uuid));
+        } else {
+            change.description = tr("Deleting orphan %1 [%2]").arg(entry.name, Tools::uuidToHex(uuid));
+        }
+        changes << change;
+        state.remove(state.entries, uuid);
+    }
+
+    // we need to finish all children before we are able to determine if a group can be removed
+    std::stable_sort(groups.begin(), groups.end(), [](const QPair<int, QUuid>& lhs, const QPair<int, QUuid>& rhs) {
+        return lhs.first > rhs.first;
+    });
+    for (const auto& depthAndUuid : asConst(groups)) {
+        const auto& uuid = depthAndUuid.second;
+        const auto& object = mergedDeletions[uuid];
+        const auto group = state.groups.value(uuid);
+        if (group.lastModified > object.deletionTime) {
+            // keep deleted group since it was changed after deletion date
+            continue;
+        }
+        if (group.size > 0) {
+            // keep deleted group since it contains undeleted content
+            continue;
+        }
+        deletions << object;
+        Change change;
+        change.type = ChangeType::DeleteGroup;
+        change.uuid = uuid;
+        if (!group.parent.isNull()) {
+            change.description = tr("Deleting child %1 [%2]").arg(group.name, Tools::uuidToHex(uuid));
         } else {
-            targetChildGroup->setIcon(sourceChildGroup->iconNumber());
+            change.description = tr("Deleting orphan %1 [%2]").arg(group.name, Tools::uuidToHex(uuid));
+        }
+        changes << change;
+        state.remove(state.groups, uuid);
+    }
+
+    // Put every deletion to the earliest date of deletion
+    if (deletions != targetDeletions) {
+        Change change;
+        change.type = ChangeType::DeletedObjects;
+        change.deletedObjects = deletions;
+        change.description = tr("Changed deleted objects");
+        changes << change;
+    }
+}
+
+void Merger::planMetadata(ChangeList& changes)
+{
+    // TODO HNH: missing handling of recycle bin, names, templates for groups and entries,
+    //           public data (entries of newer dict override keys of older dict - ignoring
+    //           their own age - it is enough if one entry of the whole dict is newer) => possible lost update
+    auto* sourceMetadata = m_context.m_sourceDb->metadata();
+    auto* targetMetadata = m_context.m_targetDb->metadata();
+
+    for (const auto& iconUuid : sourceMetadata->customIconsOrder()) {
+        if (!targetMetadata->hasCustomIcon(iconUuid)) {
+            Change change;
+            change.type = ChangeType::AddCustomIcon;
+            change.uuid = iconUuid;
+            change.description = tr("Adding missing icon %1").arg(QString::fromLatin1(iconUuid.toRfc4122().toHex()));
+            changes << change;
+        }
+    }
+
+    // Some merges shouldn't modify the database custom data
+    if (m_skipCustomData) {
+        return;
+    }
+
+    // Merge Custom Data if source is newer
+    const auto targetCustomDataModificationTime = targetMetadata->customData()->lastModified();
+    const auto sourceCustomDataModificationTime = sourceMetadata->customData()->lastModified();
+    if (!targetMetadata->customData()->contains(CustomData::LastModified)
+        || (targetCustomDataModificationTime.isValid() && sourceCustomDataModificationTime.isValid()
+            && targetCustomDataModificationTime < sourceCustomDataModificationTime)) {
+        const auto sourceCustomDataKeys = sourceMetadata->customData()->keys();
+        const auto targetCustomDataKeys = targetMetadata->customData()->keys();
+
+        // Check missing keys from source. Remove those from target
+        for (const auto& key : targetCustomDataKeys) {
+            // Do not remove protected custom data
+            if (!sourceMetadata->customData()->contains(key) && !sourceMetadata->customData()->isProtected(key)) {
+                auto value = targetMetadata->customData()->value(key);
+                Change change;
+                change.type = ChangeType::RemoveCustomData;
+                change.key = key;
+                change.description = tr("Removed custom data %1 [%2]").arg(key, value);
+                changes << change;
+            }
+        }
+
+        // Transfer new/existing keys
+        for (const auto& key : sourceCustomDataKeys) {
+            // Don't merge auto-generated keys
+            if (sourceMetadata->customData()->isAutoGenerated(key)) {
+                continue;
+            }
+
+            auto sourceValue = sourceMetadata->customData()->value(key);
+            auto targetValue = targetMetadata->customData()->value(key);
+            // Merge only if the values are not the same.
+            if (sourceValue != targetValue) {
+                Change change;
+                change.type = ChangeType::SetCustomData;
+                change.key = key;
+                change.value = sourceValue;
+                change.description = tr("Adding custom data %1 [%2]").arg(key, sourceValue);
+                changes << change;
+            }
         }
-        targetChildGroup->setExpiryTime(sourceChildGroup->timeInfo().expiryTime());
-        TimeInfo timeInfo = targetChildGroup->timeInfo();
-        timeInfo.setLastModificationTime(timeOther);
-        targetChildGroup->setTimeInfo(timeInfo);
     }
-    return changes;
+}
+
+bool Merger::applyChange(const Change& change)
+{
+    switch (change.type) {
+    case ChangeType::CreateEntry: {
+        const Entry* sourceEntry = m_sourceEntries.value(change.uuid);
+        Group* targetGroup = m_targetGroups.value(change.groupUuid);
+        if (!sourceEntry || !targetGroup || m_targetEntries.contains(change.uuid)) {
+            return false;
+        }
+        Entry* targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+        moveEntry(targetEntry, targetGroup);
+        m_targetEntries.insert(change.uuid, targetEntry);
+        return true;
+    }
+    case ChangeType::RelocateEntry: {
+        Entry* targetEntry = m_targetEntries.value(change.uuid);
+        Group* targetGroup = m_targetGroups.value(change.groupUuid);
+        if (!targetEntry || !targetGroup) {
+            return false;
+        }
+        moveEntry(targetEntry, targetGroup);
+        return true;
+    }
+    case ChangeType::UpdateEntry: {
+        const Entry* sourceEntry = m_sourceEntries.value(change.uuid);
+        Entry* targetEntry = m_targetEntries.value(change.uuid);
+        if (!sourceEntry || !targetEntry) {
+            return false;
+        }
+        Group* currentGroup = targetEntry->group();
+        Entry* clonedEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+        qDebug("Merge %s/%s with alien on top under %s",
+               qPrintable(targetEntry->title()),
+               qPrintable(sourceEntry->title()),
+               qPrintable(currentGroup->name()));
+        mergeHistory(targetEntry, clonedEntry, targetEntry->database()->metadata()->historyMaxItems());
+        eraseEntry(targetEntry);
+        moveEntry(clonedEntry, currentGroup);
+        m_targetEntries.insert(change.uuid, clonedEntry);
+        return true;
+    }
+    case ChangeType::MergeEntryHistory: {
+        const Entry* sourceEntry = m_sourceEntries.value(change.uuid);
+        Entry* targetEntry = m_targetEntries.value(change.uuid);
+        if (!sourceEntry || !targetEntry) {
+            return false;
+        }
+        qDebug("Merge %s/%s with local on top/under %s",
+               qPrintable(targetEntry->title()),
+               qPrintable(sourceEntry->title()),
+               qPrintable(targetEntry->group()->name()));
+        mergeHistory(sourceEntry, targetEntry, targetEntry->database()->metadata()->historyMaxItems());
+        return true;
+    }
+    case ChangeType::CreateGroup: {
+        const Group* sourceGroup = m_sourceGroups.value(change.uuid);
+        Group* parentGroup = m_targetGroups.value(change.groupUuid);
+        if (!sourceGroup || !parentGroup || m_targetGroups.contains(change.uuid)) {
+            return false;
+        }
+        Group* targetGroup = sourceGroup->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+        moveGroup(targetGroup, parentGroup);
+        TimeInfo timeinfo = targetGroup->timeInfo();
+        timeinfo.setLocationChanged(sourceGroup->timeInfo().locationChanged());
+        targetGroup->setTimeInfo(timeinfo);
+        m_targetGroups.insert(change.uuid, targetGroup);
+        return true;
+    }
+    case ChangeType::RelocateGroup: {
+        const Group* sourceGroup = m_sourceGroups.value(change.uuid);
+        Group* targetGroup = m_targetGroups.value(change.uuid);
+        Group* parentGroup = m_targetGroups.value(change.groupUuid);
+        if (!sourceGroup || !targetGroup || !parentGroup) {
+            return false;
+        }
+        moveGroup(targetGroup, parentGroup);
+        TimeInfo timeinfo = targetGroup->timeInfo();
+        timeinfo.setLocationChanged(sourceGroup->timeInfo().locationChanged());
+        targetGroup->setTimeInfo(timeinfo);
+        return true;
+    }
+    case ChangeType::UpdateGroup: {
+        const Group* sourceGroup = m_sourceGroups.value(change.uuid);
+        Group* targetGroup = m_targetGroups.value(change.uuid);
+        if (!sourceGroup || !targetGroup) {
+            return false;
+        }
+        targetGroup->setName(sourceGroup->name());
+        targetGroup->setNotes(sourceGroup->notes());
+        if (sourceGroup->iconNumber() == 0) {
+            targetGroup->setIcon(sourceGroup->iconUuid());
+        } else {
+            targetGroup->setIcon(sourceGroup->iconNumber());
+        }
+        targetGroup->setExpiryTime(sourceGroup->timeInfo().expiryTime());
+        TimeInfo timeInfo = targetGroup->timeInfo();
+        timeInfo.setLastModificationTime(sourceGroup->timeInfo().lastModificationTime());
+        targetGroup->setTimeInfo(timeInfo);
+        return true;
+    }
+    case ChangeType::DeleteEntry: {
+        Entry* targetEntry = m_targetEntries.value(change.uuid);
+        if (!targetEntry) {
+            return false;
+        }
+        // Entry is inserted into deletedObjects after deletions are processed
+        eraseEntry(targetEntry);
+        return true;
+    }
+    case ChangeType::DeleteGroup: {
+        Group* targetGroup = m_targetGroups.value(change.uuid);
+        if (!targetGroup) {
+            return false;
+        }
+        eraseGroup(targetGroup);
+        return true;
+    }
+    case ChangeType::DeletedObjects:
+        m_context.m_targetDb->setDeletedObjects(change.deletedObjects);
+        return true;
+    case ChangeType::AddCustomIcon: {
+        auto* sourceMetadata = m_context.m_sourceDb->metadata();
+        auto* targetMetadata = m_context.m_targetDb->metadata();
+        if (!sourceMetadata->hasCustomIcon(change.uuid) || targetMetadata->hasCustomIcon(change.uuid)) {
+            return false;
+        }
+        targetMetadata->addCustomIcon(change.uuid, sourceMetadata->customIcon(change.uuid));
+        return true;
+    }
+    case ChangeType::RemoveCustomData:
+        m_context.m_targetDb->metadata()->customData()->remove(change.key);
+        return true;
+    case ChangeType::SetCustomData:
+        m_context.m_targetDb->metadata()->customData()->set(change.key, change.value);
+        return true;
+    }
+    return false;
 }
 
 void Merger::moveEntry(Entry* entry, Group* targetGroup)
@@ -225,9 +733,9 @@ void Merger::moveGroup(Group* group, Group* targetGroup)
 
 void Merger::eraseEntry(Entry* entry)
 {
-    Database* database = entry->database();
-    // most simple method to remove an item from DeletedObjects :(
-    const QList<DeletedObject> deletions = database->deletedObjects();
+    if (m_targetEntries.value(entry->uuid()) == entry) {
+        m_targetEntries.remove(entry->uuid());
+    }
     Group* parentGroup = entry->group();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -237,14 +745,13 @@ void Merger::eraseEntry(Entry* entry)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
 }
 
 void Merger::eraseGroup(Group* group)
 {
-    Database* database = group->database();
-    // most simple method to remove an item from DeletedObjects :(
-    const QList<DeletedObject> deletions = database->deletedObjects();
+    if (m_targetGroups.value(group->uuid()) == group) {
+        m_targetGroups.remove(group->uuid());
+    }
     Group* parentGroup = group->parentGroup();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -254,64 +761,15 @@ void Merger::eraseGroup(Group* group)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
-}
-
-Merger::ChangeList Merger::resolveEntryConflict_MergeHistories(const MergeContext& context,
-                                                               const Entry* sourceEntry,
-                                                               Entry* targetEntry,
-                                                               Group::MergeMode mergeMethod)
-{
-    Q_UNUSED(context);
-
-    ChangeList changes;
-    const int comparison = compare(targetEntry->timeInfo().lastModificationTime(),
-                                   sourceEntry->timeInfo().lastModificationTime(),
-                                   CompareItemIgnoreMilliseconds);
-    const int maxItems = targetEntry->database()->metadata()->historyMaxItems();
-    if (comparison < 0) {
-        Group* currentGroup = targetEntry->group();
-        Entry* clonedEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
-        qDebug("Merge %s/%s with alien on top under %s",
-               qPrintable(targetEntry->title()),
-               qPrintable(sourceEntry->title()),
-               qPrintable(currentGroup->name()));
-        changes << tr("Synchronizing from newer source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
-        mergeHistory(targetEntry, clonedEntry, mergeMethod, maxItems);
-        eraseEntry(targetEntry);
-        moveEntry(clonedEntry, currentGroup);
-    } else {
-        qDebug("Merge %s/%s with local on top/under %s",
-               qPrintable(targetEntry->title()),
-               qPrintable(sourceEntry->title()),
-               qPrintable(targetEntry->group()->name()));
-        const bool changed = mergeHistory(sourceEntry, targetEntry, mergeMethod, maxItems);
-        if (changed) {
-            changes
-                << tr("Synchronizing from older source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
-        }
-    }
-    return changes;
 }
 
-Merger::ChangeList
-Merger::resolveEntryConflict(const MergeContext& context, const Entry* sourceEntry, Entry* targetEntry)
-{
-    // We need to cut off the milliseconds since the persistent format only supports times down to seconds
-    // so when we import data from a remote source, it may represent the (or even some msec newer) data
-    // which may be discarded due to higher runtime precision
-
-    Group::MergeMode mergeMode = m_mode == Group::Default ? context.m_targetGroup->mergeMode() : m_mode;
-    return resolveEntryConflict_MergeHistories(context, sourceEntry, targetEntry, mergeMode);
-}
-
-bool Merger::mergeHistory(const Entry* sourceEntry,
-                          Entry* targetEntry,
-                          Group::MergeMode mergeMethod,
-                          const int maxItems)
+/**
+ * Merge the history items of both entries. The returned items still belong to the
+ * given entries, they are only cloned once the history is actually replaced.
+ */
+QList<const Entry*> Merger::mergedHistory(const Entry* sourceEntry, const Entry* targetEntry) const
 {
-    Q_UNUSED(mergeMethod);
-    const auto targetHistoryItems = targetEntry->historyItems();
+    const auto& targetHistoryItems = targetEntry->historyItems();
     const auto sourceHistoryItems = sourceEntry->historyItems();
     const int comparison = compare(sourceEntry->timeInfo().lastModificationTime(),
                                    targetEntry->timeInfo().lastModificationTime(),
@@ -319,7 +777,7 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     const bool preferLocal = comparison < 0;
     const bool preferRemote = comparison > 0;
 
-    QMap<QDateTime, Entry*> merged;
+    QMap<QDateTime, const Entry*> merged;
     for (Entry* historyItem : targetHistoryItems) {
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
         if (merged.contains(modificationTime)
@@ -330,9 +788,9 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
                        qPrintable(sourceEntry->uuidToHex()),
                        qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
         }
-        merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+        merged[modificationTime] = historyItem;
     }
-    for (Entry* historyItem : sourceHistoryItems) {
+    for (const Entry* historyItem : sourceHistoryItems) {
         // Items with same modification-time changes will be regarded as same (like KeePass2)
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
         if (merged.contains(modificationTime)
@@ -345,10 +803,10 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
         }
         if (preferRemote && merged.contains(modificationTime)) {
             // forcefully apply the remote history item
-            delete merged.take(modificationTime);
+            merged.remove(modificationTime);
         }
         if (!merged.contains(modificationTime)) {
-            merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+            merged[modificationTime] = historyItem;
         }
     }
 
@@ -365,39 +823,55 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     if (targetModificationTime < sourceModificationTime) {
         if (preferLocal && merged.contains(targetModificationTime)) {
             // forcefully apply the local history item
-            delete merged.take(targetModificationTime);
+            merged.remove(targetModificationTime);
         }
         if (!merged.contains(targetModificationTime)) {
-            merged[targetModificationTime] = targetEntry->clone(Entry::CloneNoFlags);
+            merged[targetModificationTime] = targetEntry;
         }
     } else if (targetModificationTime > sourceModificationTime) {
         if (preferRemote && !merged.contains(sourceModificationTime)) {
             // forcefully apply the remote history item
-            delete merged.take(sourceModificationTime);
+            merged.remove(sourceModificationTime);
         }
         if (!merged.contains(sourceModificationTime)) {
-            merged[sourceModificationTime] = sourceEntry->clone(Entry::CloneNoFlags);
+            merged[sourceModificationTime] = sourceEntry;
         }
     }
 
-    bool changed = false;
-    const auto updatedHistoryItems = merged.values();
+    return merged.values();
+}
+
+bool Merger::isHistoryChanged(const QList<Entry*>& history, const QList<const Entry*>& mergedHistory, int maxItems)
+{
     for (int i = 0; i < maxItems; ++i) {
-        const Entry* oldEntry = targetHistoryItems.value(targetHistoryItems.count() - i);
-        const Entry* newEntry = updatedHistoryItems.value(updatedHistoryItems.count() - i);
+        const Entry* oldEntry = history.value(history.count() - i);
+        const Entry* newEntry = mergedHistory.value(mergedHistory.count() - i);
         if (!oldEntry && !newEntry) {
             continue;
         }
-        if (oldEntry && newEntry && oldEntry->equals(newEntry, CompareItemIgnoreMilliseconds)) {
+        // The merged history may refer to the entries themselves, only their own data counts
+        if (oldEntry && newEntry
+            && oldEntry->equals(newEntry, CompareItemIgnoreMilliseconds | CompareItemIgnoreHistory)) {
             continue;
         }
-        changed = true;
-        break;
+        return true;
     }
-    if (!changed) {
-        qDeleteAll(updatedHistoryItems);
+    return false;
+}
+
+bool Merger::mergeHistory(const Entry* sourceEntry, Entry* targetEntry, const int maxItems)
+{
+    const auto targetHistoryItems = targetEntry->historyItems();
+    const auto updatedHistoryItems = mergedHistory(sourceEntry, targetEntry);
+    if (!isHistoryChanged(targetHistoryItems, updatedHistoryItems, maxItems)) {
         return false;
     }
+    // Clone the items before the old history items are deleted, they may be part of the new history
+    QList<Entry*> historyItems;
+    historyItems.reserve(updatedHistoryItems.size());
+    for (const Entry* historyItem : updatedHistoryItems) {
+        historyItems << historyItem->clone(Entry::CloneNoFlags);
+    }
     // We need to prevent any modification to the database since every change should be tracked either
     // in a clone history item or in the Entry itself
     const TimeInfo timeInfo = targetEntry->timeInfo();
@@ -405,7 +879,7 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     bool updateTimeInfo = targetEntry->canUpdateTimeinfo();
     targetEntry->setUpdateTimeinfo(false);
     targetEntry->removeHistoryItems(targetHistoryItems);
-    for (Entry* historyItem : merged) {
+    for (Entry* historyItem : asConst(historyItems)) {
         Q_ASSERT(!historyItem->parent());
         targetEntry->addHistoryItem(historyItem);
     }
@@ -417,150 +891,3 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     return true;
 }
 
-Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
-{
-    ChangeList changes;
-    Group::MergeMode mergeMode = m_mode == Group::Default ? context.m_targetGroup->mergeMode() : m_mode;
-    if (mergeMode != Group::Synchronize) {
-        // no deletions are applied for any other strategy!
-        return changes;
-    }
-
-    const auto targetDeletions = context.m_targetDb->deletedObjects();
-    const auto sourceDeletions = context.m_sourceDb->deletedObjects();
-
-    QList<DeletedObject> deletions;
-    QMap<QUuid, DeletedObject> mergedDeletions;
-    QList<Entry*> entries;
-    QList<Group*> groups;
-
-    for (const auto& object : (targetDeletions + sourceDeletions)) {
-        if (!mergedDeletions.contains(object.uuid)) {
-            mergedDeletions[object.uuid] = object;
-
-            auto* entry = context.m_targetRootGroup->findEntryByUuid(object.uuid);
-            if (entry) {
-                entries << entry;
-                continue;
-            }
-            auto* group = context.m_targetRootGroup->findGroupByUuid(object.uuid);
-            if (group) {
-                groups << group;
-                continue;
-            }
-            deletions << object;
-            continue;
-        }
-        if (mergedDeletions[object.uuid].deletionTime > object.deletionTime) {
-            mergedDeletions[object.uuid] = object;
-        }
-    }
-
-    while (!entries.isEmpty()) {
-        auto* entry = entries.takeFirst();
-        const auto& object = mergedDeletions[entry->uuid()];
-        if (entry->timeInfo().lastModificationTime() > object.deletionTime) {
-            // keep deleted entry since it was changed after deletion date
-            continue;
-        }
-        deletions << object;
-        if (entry->group()) {
-            changes << tr("Deleting child %1 [%2]").arg(entry->title(), entry->uuidToHex());
-        } else {
-            changes << tr("Deleting orphan %1 [%2]").arg(entry->title(), entry->uuidToHex());
-        }
-        // Entry is inserted into deletedObjects after deletions are processed
-        eraseEntry(entry);
-    }
-
-    while (!groups.isEmpty()) {
-        auto* group = groups.takeFirst();
-        if (Tools::asSet(group->children()).intersects(Tools::asSet(groups))) {
-            // we need to finish all children before we are able to determine if the group can be removed
-            groups << group;
-            continue;
-        }
-        const auto& object = mergedDeletions[group->uuid()];
-        if (group->timeInfo().lastModificationTime() > object.deletionTime) {
-            // keep deleted group since it was changed after deletion date
-            continue;
-        }
-        if (!group->entriesRecursive(false).isEmpty() || !group->groupsRecursive(false).isEmpty()) {
-            // keep deleted group since it contains undeleted content
-            continue;
-        }
-        deletions << object;
-        if (group->parentGroup()) {
-            changes << tr("Deleting child %1 [%2]").arg(group->name(), group->uuidToHex());
-        } else {
-            changes << tr("Deleting orphan %1 [%2]").arg(group->name(), group->uuidToHex());
-        }
-        eraseGroup(group);
-    }
-    // Put every deletion to the earliest date of deletion
-    if (deletions != context.m_targetDb->deletedObjects()) {
-        changes << tr("Changed deleted objects");
-    }
-    context.m_targetDb->setDeletedObjects(deletions);
-    return changes;
-}
-
-Merger::ChangeList Merger::mergeMetadata(const MergeContext& context)
-{
-    // TODO HNH: missing handling of recycle bin, names, templates for groups and entries,
-    //           public data (entries of newer dict override keys of older dict - ignoring
-    //           their own age - it is enough if one entry of the whole dict is newer) => possible lost update
-    ChangeList changes;
-    auto* sourceMetadata = context.m_sourceDb->metadata();
-    auto* targetMetadata = context.m_targetDb->metadata();
-
-    for (const auto& iconUuid : sourceMetadata->customIconsOrder()) {
-        if (!targetMetadata->hasCustomIcon(iconUuid)) {
-            targetMetadata->addCustomIcon(iconUuid, sourceMetadata->customIcon(iconUuid));
-            changes << tr("Adding missing icon %1").arg(QString::fromLatin1(iconUuid.toRfc4122().toHex()));
-        }
-    }
-
-    // Some merges shouldn't modify the database custom data
-    if (m_skipCustomData) {
-        return changes;
-    }
-
-    // Merge Custom Data if source is newer
-    const auto targetCustomDataModificationTime = targetMetadata->customData()->lastModified();
-    const auto sourceCustomDataModificationTime = sourceMetadata->customData()->lastModified();
-    if (!targetMetadata->customData()->contains(CustomData::LastModified)
-        || (targetCustomDataModificationTime.isValid() && sourceCustomDataModificationTime.isValid()
-            && targetCustomDataModificationTime < sourceCustomDataModificationTime)) {
-        const auto sourceCustomDataKeys = sourceMetadata->customData()->keys();
-        const auto targetCustomDataKeys = targetMetadata->customData()->keys();
-
-        // Check missing keys from source. Remove those from target
-        for (const auto& key : targetCustomDataKeys) {
-            // Do not remove protected custom data
-            if (!sourceMetadata->customData()->contains(key) && !sourceMetadata->customData()->isProtected(key)) {
-                auto value = targetMetadata->customData()->value(key);
-                targetMetadata->customData()->remove(key);
-                changes << tr("Removed custom data %1 [%2]").arg(key, value);
-            }
-        }
-
-        // Transfer new/existing keys
-        for (const auto& key : sourceCustomDataKeys) {
-            // Don't merge auto-generated keys
-            if (sourceMetadata->customData()->isAutoGenerated(key)) {
-                continue;
-            }
-
-            auto sourceValue = sourceMetadata->customData()->value(key);
-            auto targetValue = targetMetadata->customData()->value(key);
-            // Merge only if the values are not the same.
-            if (sourceValue != targetValue) {
-                targetMetadata->customData()->set(key, sourceValue);
-                changes << tr("Adding custom data %1 [%2]").arg(key, sourceValue);
-            }
-        }
-    }
-
-    return changes;
-}
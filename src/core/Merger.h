@@ -18,26 +18,64 @@
 #ifndef KEEPASSXC_MERGER_H
 #define KEEPASSXC_MERGER_H
 
+#include "core/Database.h"
 #include "core/Group.h"
 
-class Database;
 class Entry;
 
 class Merger : public QObject
 {
     Q_OBJECT
 public:
+    enum class ChangeType
+    {
+        CreateEntry,
+        CreateGroup,
+        RelocateEntry,
+        RelocateGroup,
+        UpdateEntry,
+        UpdateGroup,
+        MergeEntryHistory,
+        DeleteEntry,
+        DeleteGroup,
+        DeletedObjects,
+        AddCustomIcon,
+        RemoveCustomData,
+        SetCustomData
+    };
+    Q_ENUM(ChangeType)
+
+    /**
+     * A single step of a merge plan.
+     *
+     * Entries, groups and custom icons are referenced by uuid, groupUuid is the
+     * target group of created and relocated items. Custom data changes use key
+     * and value, DeletedObjects carries the resulting deleted objects list.
+     */
+    struct Change
+    {
+        ChangeType type = ChangeType::CreateEntry;
+        QUuid uuid;
+        QUuid groupUuid;
+        QString key;
+        QString value;
+        QList<DeletedObject> deletedObjects;
+        QString description;
+
+        QVariantMap toVariantMap() const;
+    };
+    typedef QList<Change> ChangeList;
+
     Merger(const Database* sourceDb, Database* targetDb);
     Merger(const Group* sourceGroup, Group* targetGroup);
     void setForcedMergeMode(Group::MergeMode mode);
     void resetForcedMergeMode();
     void setSkipDatabaseCustomData(bool state);
     QStringList merge();
+    ChangeList plan();
+    QStringList apply(const ChangeList& changes);
 
 private:
-    typedef QString Change;
-    typedef QStringList ChangeList;
-
     struct MergeContext
     {
         QPointer<const Database> m_sourceDb;
@@ -47,25 +85,29 @@ private:
         QPointer<const Group> m_sourceGroup;
         QPointer<Group> m_targetGroup;
     };
-    ChangeList mergeGroup(const MergeContext& context);
-    ChangeList mergeDeletions(const MergeContext& context);
-    ChangeList mergeMetadata(const MergeContext& context);
-    bool mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::MergeMode mergeMethod, const int maxItems);
+    struct PlanState;
+
+    void indexDatabases();
+    void planGroup(const Group* sourceGroup, const QUuid& targetGroupUuid, PlanState& state, ChangeList& changes);
+    void planDeletions(PlanState& state, ChangeList& changes);
+    void planMetadata(ChangeList& changes);
+    bool applyChange(const Change& change);
+    QList<const Entry*> mergedHistory(const Entry* sourceEntry, const Entry* targetEntry) const;
+    static bool isHistoryChanged(const QList<Entry*>& history, const QList<const Entry*>& mergedHistory, int maxItems);
+    bool mergeHistory(const Entry* sourceEntry, Entry* targetEntry, const int maxItems);
     void moveEntry(Entry* entry, Group* targetGroup);
     void moveGroup(Group* group, Group* targetGroup);
-    // remove an entry without a trace in the deletedObjects - needed for elimination of cloned entries
+    // remove an entry, the caller restores the deletedObjects afterwards - needed for elimination of cloned entries
     void eraseEntry(Entry* entry);
-    // remove an entry without a trace in the deletedObjects - needed for elimination of cloned entries
+    // remove a group, the caller restores the deletedObjects afterwards - needed for elimination of cloned entries
     void eraseGroup(Group* group);
-    ChangeList resolveEntryConflict(const MergeContext& context, const Entry* existingEntry, Entry* otherEntry);
-    ChangeList resolveGroupConflict(const MergeContext& context, const Group* existingGroup, Group* otherGroup);
-    Merger::ChangeList resolveEntryConflict_MergeHistories(const MergeContext& context,
-                                                           const Entry* sourceEntry,
-                                                           Entry* targetEntry,
-                                                           Group::MergeMode mergeMethod);
 
 private:
     MergeContext m_context;
+    QHash<QUuid, const Entry*> m_sourceEntries;
+    QHash<QUuid, const Group*> m_sourceGroups;
+    QHash<QUuid, Entry*> m_targetEntries;
+    QHash<QUuid, Group*> m_targetGroups;
     Group::MergeMode m_mode;
     bool m_skipCustomData = false;
 };
@@ -29,6 +29,7 @@
 const int Metadata::DefaultHistoryMaxItems = 10;
 const int Metadata::DefaultHistoryMaxSize = 6 * 1024 * 1024;
 const int Metadata::DefaultAutosaveDelayMin = 0;
+const int Metadata::DefaultDeletedObjectsMaxAgeDays = 0;
 
 // Fallback icon for return by reference
 static const Metadata::CustomIconData NULL_ICON{};
@@ -37,6 +38,7 @@ namespace customDataKeys
 {
     static const QString savedSearch = QStringLiteral("KPXC_SavedSearch");
     static const QString autosaveDelay = QStringLiteral("KPXC_autosaveDelayMin");
+    static const QString deletedObjectsMaxAge = QStringLiteral("KPXC_deletedObjectsMaxAgeDays");
 }; // namespace customDataKeys
 
 Metadata::Metadata(QObject* parent)
@@ -115,6 +117,7 @@ void Metadata::setUpdateDatetime(bool value)
 void Metadata::copyAttributesFrom(const Metadata* other)
 {
     m_data = other->m_data;
+    emitModified();
 }
 
 QString Metadata::generator() const
@@ -285,6 +288,17 @@ int Metadata::autosaveDelayMin() const
     return autosaveDelayMin;
 }
 
+int Metadata::deletedObjectsMaxAgeDays() const
+{
+    QString maxAgeStr = m_customData->value(customDataKeys::deletedObjectsMaxAge);
+    if (maxAgeStr.isNull()) {
+        return Metadata::DefaultDeletedObjectsMaxAgeDays;
+    }
+    bool ok;
+    int maxAge = maxAgeStr.toInt(&ok);
+    return ok ? maxAge : Metadata::DefaultDeletedObjectsMaxAgeDays;
+}
+
 CustomData* Metadata::customData()
 {
     return m_customData;
@@ -504,6 +518,21 @@ void Metadata::setAutosaveDelayMin(int value)
     m_customData->set(customDataKeys::autosaveDelay, QString::number(value));
 }
 
+/**
+ * Set the number of days deleted object records are kept before they are
+ * dropped on save. A value of 0 keeps them forever.
+ */
+void Metadata::setDeletedObjectsMaxAgeDays(int value)
+{
+    if (value <= 0) {
+        if (m_customData->contains(customDataKeys::deletedObjectsMaxAge)) {
+            m_customData->remove(customDataKeys::deletedObjectsMaxAge);
+        }
+        return;
+    }
+    m_customData->set(customDataKeys::deletedObjectsMaxAge, QString::number(value));
+}
+
 QDateTime Metadata::settingsChanged() const
 {
     return m_settingsChanged;
@@ -110,12 +110,14 @@ public:
     int historyMaxItems() const;
     int historyMaxSize() const;
     int autosaveDelayMin() const;
+    int deletedObjectsMaxAgeDays() const;
     CustomData* customData();
     const CustomData* customData() const;
 
     static const int DefaultHistoryMaxItems;
     static const int DefaultHistoryMaxSize;
     static const int DefaultAutosaveDelayMin;
+    static const int DefaultDeletedObjectsMaxAgeDays;
 
     void setGenerator(const QString& value);
     void setName(const QString& value);
@@ -153,6 +155,7 @@ public:
     void setHistoryMaxItems(int value);
     void setHistoryMaxSize(int value);
     void setAutosaveDelayMin(int value);
+    void setDeletedObjectsMaxAgeDays(int value);
     void setUpdateDatetime(bool value);
     void addSavedSearch(const QString& name, const QString& searchtext);
     void deleteSavedSearch(const QString& name);
@@ -20,6 +20,7 @@
 #include "Clock.h"
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "PasswordHealthService.h"
 #include "zxcvbn.h"
 
 namespace
@@ -33,6 +34,14 @@ PasswordHealth::PasswordHealth(double entropy)
 }
 
 PasswordHealth::PasswordHealth(const QString& pwd)
+{
+    init(calculateEntropy(pwd));
+}
+
+/**
+ * Estimate the entropy of a password in bits using zxcvbn.
+ */
+double PasswordHealth::calculateEntropy(const QString& pwd)
 {
     auto entropy = 0.0;
     entropy += ZxcvbnMatch(pwd.left(ZXCVBN_ESTIMATE_THRESHOLD).toUtf8(), nullptr, nullptr);
@@ -41,7 +50,7 @@ PasswordHealth::PasswordHealth(const QString& pwd)
         auto average = entropy / ZXCVBN_ESTIMATE_THRESHOLD;
         entropy += average * (pwd.length() - ZXCVBN_ESTIMATE_THRESHOLD);
     }
-    init(entropy);
+    return entropy;
 }
 
 void PasswordHealth::init(double entropy)
@@ -113,18 +122,30 @@ PasswordHealth::Quality PasswordHealth::quality() const
 /**
  * This class provides additional information about password health
  * than can be derived from the password itself (re-use, expiry).
+ *
+ * If the database has a PasswordHealthService, its cached entropies and
+ * re-use map are used. Otherwise the re-use map is built here.
  */
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
+    : m_db(db)
 {
+    if (db->passwordHealthService()) {
+        return;
+    }
+
     // Build the cache of re-used passwords
     for (const auto* entry : db->rootGroup()->entriesRecursive()) {
         if (!entry->isRecycled() && !entry->isAttributeReference("Password")) {
-            m_reuse[entry->password()]
-                << QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
+            m_reuse[entry->password()] << usedIn(entry);
         }
     }
 }
 
+QString HealthChecker::usedIn(const Entry* entry)
+{
+    return QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
+}
+
 /**
  * Call operator of the Health Checker class.
  *
@@ -140,11 +161,22 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto* service = m_db->passwordHealthService();
+    auto health = service ? QSharedPointer<PasswordHealth>::create(service->entropy(pwd))
+                          : QSharedPointer<PasswordHealth>::create(pwd);
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
-    const auto& used = m_reuse[pwd];
+    QStringList used;
+    if (service) {
+        for (const auto* other : service->entriesUsingPassword(pwd)) {
+            if (other->group() && !other->isRecycled() && !other->isAttributeReference("Password")) {
+                used << usedIn(other);
+            }
+        }
+    } else {
+        used = m_reuse.value(pwd);
+    }
     const auto count = used.size();
     if (count > 1) {
         constexpr auto penalty = 15;
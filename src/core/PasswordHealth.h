@@ -37,6 +37,8 @@ public:
 
     void init(double entropy);
 
+    static double calculateEntropy(const QString& pwd);
+
     /*
      * The password score is defined to be the greater the better
      * (more secure) the password is. It doesn't have a dimension,
@@ -111,6 +113,9 @@ public:
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
 
 private:
+    static QString usedIn(const Entry* entry);
+
+    QSharedPointer<Database> m_db;
     // To determine password re-use: first = password, second = entries that use it
     QHash<QString, QStringList> m_reuse;
 };
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordHealthService.h"
+
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/PasswordHealth.h"
+
+#include <QCryptographicHash>
+#include <QtConcurrent>
+
+PasswordHealthService::PasswordHealthService(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<void>::progressValueChanged, this, [this](int value) {
+        emit progressChanged(value, m_watcher.progressMaximum());
+    });
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, [this] {
+        m_pending.clear();
+        emit evaluationFinished();
+    });
+}
+
+PasswordHealthService::~PasswordHealthService()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+/**
+ * Track the password of an entry for the re-use map. The map
+ * is updated lazily whenever the entry changes.
+ */
+void PasswordHealthService::addEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    QMutexLocker locker(&m_mutex);
+    if (!m_entries.contains(entry)) {
+        auto markDirty = [this, entry] {
+            QMutexLocker locker(&m_mutex);
+            m_dirty.insert(entry);
+        };
+        connect(entry, &Entry::modified, this, markDirty);
+        connect(entry, &Entry::entryDataChanged, this, markDirty);
+        m_entries.insert(entry);
+    }
+    m_dirty.insert(entry);
+}
+
+void PasswordHealthService::removeEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+    disconnect(entry, nullptr, this, nullptr);
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.remove(entry);
+    m_dirty.remove(entry);
+    const auto key = m_passwordKeys.take(entry);
+    auto it = m_entriesByPassword.find(key);
+    if (it != m_entriesByPassword.end()) {
+        it->removeOne(entry);
+        if (it->isEmpty()) {
+            m_entriesByPassword.erase(it);
+        }
+    }
+}
+
+/**
+ * Entropy of a password as estimated by PasswordHealth. Computed once
+ * per distinct password, later calls are answered from the cache.
+ */
+double PasswordHealthService::entropy(const QString& password)
+{
+    const auto key = passwordKey(password);
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entropies.constFind(key);
+        if (it != m_entropies.constEnd()) {
+            return it.value();
+        }
+    }
+
+    const auto entropy = PasswordHealth::calculateEntropy(password);
+    insertEntropy(key, entropy);
+    return entropy;
+}
+
+/**
+ * All tracked entries whose (unresolved) password equals the given one.
+ */
+QList<const Entry*> PasswordHealthService::entriesUsingPassword(const QString& password)
+{
+    QMutexLocker locker(&m_mutex);
+    updateDirtyEntries();
+    return m_entriesByPassword.value(passwordKey(password));
+}
+
+/**
+ * Calculate the entropy of every password not evaluated yet on the global
+ * thread pool. Both the raw and the resolved password of each entry are
+ * evaluated, as used by HealthChecker and Entry::passwordHealth respectively.
+ * Emits evaluationFinished() once done, even if there was nothing to do.
+ */
+void PasswordHealthService::evaluate()
+{
+    if (isEvaluating()) {
+        return;
+    }
+
+    QList<Entry*> entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries = m_entries.values();
+    }
+
+    // Entries are only read on the owning thread, the workers get a snapshot of the passwords
+    QSet<QByteArray> seen;
+    QVector<QString> pending;
+    auto addPending = [this, &seen, &pending](const QString& password) {
+        if (password.isEmpty()) {
+            return;
+        }
+        const auto key = passwordKey(password);
+        if (seen.contains(key)) {
+            return;
+        }
+        seen.insert(key);
+        QMutexLocker locker(&m_mutex);
+        if (!m_entropies.contains(key)) {
+            pending.append(password);
+        }
+    };
+    for (const auto* entry : entries) {
+        const auto password = entry->password();
+        addPending(password);
+        addPending(entry->resolvePlaceholder(password));
+    }
+
+    if (pending.isEmpty()) {
+        emit progressChanged(0, 0);
+        emit evaluationFinished();
+        return;
+    }
+
+    m_pending = std::move(pending);
+    m_watcher.setFuture(QtConcurrent::map(m_pending, [this](QString& password) {
+        insertEntropy(passwordKey(password), PasswordHealth::calculateEntropy(password));
+        // Do not keep the plain text copy around until the whole evaluation is done
+        password.clear();
+    }));
+}
+
+void PasswordHealthService::cancel()
+{
+    m_watcher.cancel();
+}
+
+bool PasswordHealthService::isEvaluating() const
+{
+    return m_watcher.isRunning();
+}
+
+int PasswordHealthService::progressValue() const
+{
+    return m_watcher.progressValue();
+}
+
+int PasswordHealthService::progressMaximum() const
+{
+    return m_watcher.progressMaximum();
+}
+
+/**
+ * Passwords are cached by their hash so the cache does not hold
+ * another plain text copy of every password.
+ */
+QByteArray PasswordHealthService::passwordKey(const QString& password)
+{
+    return QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256);
+}
+
+void PasswordHealthService::insertEntropy(const QByteArray& key, double entropy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entropies.insert(key, entropy);
+}
+
+// Must be called with m_mutex locked
+void PasswordHealthService::updateDirtyEntries()
+{
+    for (auto* entry : asConst(m_dirty)) {
+        const auto oldKey = m_passwordKeys.value(entry);
+        const auto newKey = passwordKey(entry->password());
+        if (m_passwordKeys.contains(entry)) {
+            if (oldKey == newKey) {
+                continue;
+            }
+            auto it = m_entriesByPassword.find(oldKey);
+            if (it != m_entriesByPassword.end()) {
+                it->removeOne(entry);
+                if (it->isEmpty()) {
+                    m_entriesByPassword.erase(it);
+                }
+            }
+        }
+        m_entriesByPassword[newKey].append(entry);
+        m_passwordKeys.insert(entry, newKey);
+    }
+    m_dirty.clear();
+}
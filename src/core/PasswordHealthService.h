@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PASSWORDHEALTHSERVICE_H
+#define KEEPASSXC_PASSWORDHEALTHSERVICE_H
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class Entry;
+
+/**
+ * Password health data shared by all health checks of a database.
+ *
+ * Password entropies are cached by password hash, so zxcvbn runs at most once
+ * per distinct password. evaluate() computes the entropies of all passwords
+ * on the global thread pool and reports its progress. The map of re-used
+ * passwords is updated incrementally whenever an entry changes.
+ *
+ * All methods are thread safe, signals are emitted on the owning thread.
+ */
+class PasswordHealthService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PasswordHealthService(QObject* parent = nullptr);
+    ~PasswordHealthService() override;
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+    double entropy(const QString& password);
+    QList<const Entry*> entriesUsingPassword(const QString& password);
+
+    void evaluate();
+    void cancel();
+    bool isEvaluating() const;
+    int progressValue() const;
+    int progressMaximum() const;
+
+signals:
+    void progressChanged(int value, int maximum);
+    void evaluationFinished();
+
+private:
+    static QByteArray passwordKey(const QString& password);
+    void insertEntropy(const QByteArray& key, double entropy);
+    void updateDirtyEntries();
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, double> m_entropies;
+    QHash<QByteArray, QList<const Entry*>> m_entriesByPassword;
+    QHash<const Entry*, QByteArray> m_passwordKeys;
+    QSet<Entry*> m_entries;
+    QSet<Entry*> m_dirty;
+
+    // Snapshot of the passwords to evaluate, each one is cleared once evaluated
+    QVector<QString> m_pending;
+    QFutureWatcher<void> m_watcher;
+};
+
+#endif // KEEPASSXC_PASSWORDHEALTHSERVICE_H
@@ -239,7 +239,10 @@ namespace FdoSecrets
                                  const RequestedMethod& req,
                                  const QDBusMessage& msg)
     {
-        auto obj = m_objects.value(path, nullptr);
+        DBusObject* obj = m_objects.value(path, nullptr);
+        if (!obj) {
+            obj = loadItem(path);
+        }
         if (!obj) {
             qDebug() << "DBusMgr::handleMessage with unknown path" << msg;
             return false;
@@ -355,7 +355,18 @@ namespace FdoSecrets
         switch (parsed.type) {
         case PathType::Service:
             return IntrospectionService;
-        case PathType::Collection:
+        case PathType::Collection: {
+            // items are not registered as child objects, so list them here
+            QString xml = IntrospectionCollection;
+            auto coll = qobject_cast<Collection*>(m_objects.value(path, nullptr));
+            if (coll) {
+                const auto ids = coll->itemIds();
+                for (const auto& id : ids) {
+                    xml += QStringLiteral("<node name=\"%1\"/>\n").arg(id);
+                }
+            }
+            return xml;
+        }
         case PathType::Aliases:
             return IntrospectionCollection;
         case PathType::Prompt:
@@ -405,9 +416,12 @@ namespace FdoSecrets
             .arg(otherService);
     }
 
-    bool DBusMgr::registerObject(const QString& path, DBusObject* obj, bool primary)
+    bool DBusMgr::registerObject(const QString& path,
+                                 DBusObject* obj,
+                                 bool primary,
+                                 QDBusConnection::VirtualObjectRegisterOption options)
     {
-        if (!m_conn.registerVirtualObject(path, this)) {
+        if (!m_conn.registerVirtualObject(path, this, options)) {
             qDebug() << "failed to register" << obj << "at" << path;
             return false;
         }
@@ -445,14 +459,16 @@ namespace FdoSecrets
 
     bool DBusMgr::registerObject(Collection* coll)
     {
+        // messages to the items below the collection are delivered to us as well,
+        // so items can be created when they are first accessed, see loadItem
         auto name = encodePath(coll->name());
         auto path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
-        if (!registerObject(path, coll)) {
+        if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
             // try again with a suffix
             name.append(QString("_%1").arg(Tools::uuidToHex(QUuid::createUuid()).left(4)));
             path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
 
-            if (!registerObject(path, coll)) {
+            if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
                 qDebug() << "Failed to register database on DBus under name" << name;
                 emit error(tr("Failed to register database on DBus under the name '%1'").arg(name));
                 return false;
@@ -479,13 +495,30 @@ namespace FdoSecrets
     bool DBusMgr::registerObject(Item* item)
     {
         auto path = DBUS_PATH_TEMPLATE_ITEM.arg(item->collection()->objectPath().path(), item->backend()->uuidToHex());
-        if (!registerObject(path, item)) {
+        // the collection is registered with its sub-paths, so there is nothing to register on the connection
+        if (m_objects.contains(path)) {
             emit error(tr("Failed to register item on DBus at path '%1'").arg(path));
             return false;
         }
+        connect(item, &DBusObject::destroyed, this, &DBusMgr::unregisterObject);
+        m_objects.insert(path, item);
+        item->setObjectPath(path);
         return true;
     }
 
+    DBusObject* DBusMgr::loadItem(const QString& path) const
+    {
+        auto parsed = parsePath(path);
+        if (parsed.type != PathType::Item) {
+            return nullptr;
+        }
+        auto coll = qobject_cast<Collection*>(m_objects.value(path.section('/', 0, -2), nullptr));
+        if (!coll) {
+            return nullptr;
+        }
+        return coll->itemById(parsed.id);
+    }
+
     bool DBusMgr::registerObject(PromptBase* prompt)
     {
         auto path = DBUS_PATH_TEMPLATE_PROMPT.arg(DBUS_PATH_SECRETS, Tools::uuidToHex(QUuid::createUuid()));
@@ -501,9 +534,12 @@ namespace FdoSecrets
 
     void DBusMgr::unregisterObject(DBusObject* obj)
     {
-        auto count = m_objects.remove(obj->objectPath().path());
+        auto path = obj->objectPath().path();
+        auto count = m_objects.remove(path);
         if (count > 0) {
-            m_conn.unregisterObject(obj->objectPath().path());
+            if (parsePath(path).type != PathType::Item) {
+                m_conn.unregisterObject(path);
+            }
             obj->setObjectPath("/");
         }
     }
@@ -551,48 +587,36 @@ namespace FdoSecrets
         sendDBusSignal(DBUS_PATH_SECRETS, DBUS_INTERFACE_SECRET_SERVICE, QStringLiteral("CollectionDeleted"), args);
     }
 
-    void DBusMgr::emitItemCreated(Item* item)
+    void DBusMgr::emitItemCreated(const QDBusObjectPath& itemPath)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
-        // also send on all alias path
-        for (const auto& alias : coll->aliases()) {
-            auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
-        }
+        sendItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemCreated"), itemPath);
     }
 
-    void DBusMgr::emitItemChanged(Item* item)
+    void DBusMgr::emitItemChanged(const QDBusObjectPath& itemPath)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
-        // also send on all alias path
-        for (const auto& alias : coll->aliases()) {
-            auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
-        }
+        sendItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemChanged"), itemPath);
+    }
+
+    void DBusMgr::emitItemDeleted(const QDBusObjectPath& itemPath)
+    {
+        sendItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemDeleted"), itemPath);
     }
 
-    void DBusMgr::emitItemDeleted(Item* item)
+    void DBusMgr::sendItemSignal(Collection* coll, const QString& name, const QDBusObjectPath& itemPath)
     {
-        auto coll = item->collection();
+        if (!coll) {
+            qDebug() << "Wrong sender in" << name;
+            return;
+        }
+
         QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
+        args += QVariant::fromValue(itemPath);
         // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
+        sendDBusSignal(coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         // also send on all alias path
         for (const auto& alias : coll->aliases()) {
             auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
+            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         }
     }
 
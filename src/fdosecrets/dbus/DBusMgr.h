@@ -170,6 +170,9 @@ namespace FdoSecrets
                 return nullptr;
             }
             auto obj = qobject_cast<T*>(m_objects.value(path.path(), nullptr));
+            if (!obj) {
+                obj = qobject_cast<T*>(loadItem(path.path()));
+            }
             if (!obj) {
                 qDebug() << "object not found at path" << path.path();
                 qDebug() << m_objects;
@@ -209,9 +212,9 @@ namespace FdoSecrets
         void emitCollectionCreated(Collection* coll);
         void emitCollectionChanged(Collection* coll);
         void emitCollectionDeleted(Collection* coll);
-        void emitItemCreated(Item* item);
-        void emitItemChanged(Item* item);
-        void emitItemDeleted(Item* item);
+        void emitItemCreated(const QDBusObjectPath& itemPath);
+        void emitItemChanged(const QDBusObjectPath& itemPath);
+        void emitItemDeleted(const QDBusObjectPath& itemPath);
         void emitPromptCompleted(bool dismissed, QVariant result);
 
         void dbusServiceUnregistered(const QString& service);
@@ -226,6 +229,7 @@ namespace FdoSecrets
                             const QString& name,
                             const QVariantList& arguments);
         bool sendDBus(const QDBusMessage& reply);
+        void sendItemSignal(Collection* coll, const QString& name, const QDBusObjectPath& itemPath);
 
         // object path registration
         QHash<QString, QPointer<DBusObject>> m_objects{};
@@ -253,7 +257,15 @@ namespace FdoSecrets
             }
         };
         static ParsedPath parsePath(const QString& path);
-        bool registerObject(const QString& path, DBusObject* obj, bool primary = true);
+        bool registerObject(const QString& path,
+                            DBusObject* obj,
+                            bool primary = true,
+                            QDBusConnection::VirtualObjectRegisterOption options = QDBusConnection::SingleNode);
+        /**
+         * Items are not registered until they are accessed, so create the item at path through its collection
+         * @return the item, or nullptr if path is not the path of an exposed entry
+         */
+        DBusObject* loadItem(const QString& path) const;
 
         // method dispatching
         struct MethodData
@@ -19,6 +19,7 @@
 
 #include "fdosecrets/FdoSecretsSettings.h"
 #include "fdosecrets/objects/Item.h"
+#include "fdosecrets/objects/ItemAttributeIndex.h"
 #include "fdosecrets/objects/Prompt.h"
 #include "fdosecrets/objects/Service.h"
 
@@ -28,9 +29,39 @@
 
 #include <QEventLoop>
 #include <QFileInfo>
+#include <QTimer>
+
+#include <algorithm>
 
 namespace FdoSecrets
 {
+    namespace
+    {
+        QPair<QVector<int>, int> treePosition(const Entry* entry)
+        {
+            QVector<int> groupPath;
+            for (auto group = entry->group(); group->parentGroup(); group = group->parentGroup()) {
+                groupPath.prepend(group->parentGroup()->children().indexOf(const_cast<Group*>(group)));
+            }
+            return qMakePair(groupPath, entry->group()->entries().indexOf(const_cast<Entry*>(entry)));
+        }
+
+        /**
+         * Sort entries in the order they appear in the database
+         */
+        void sortByTreePosition(QList<Entry*>& entries)
+        {
+            QHash<const Entry*, QPair<QVector<int>, int>> positions;
+            positions.reserve(entries.size());
+            for (const auto* entry : asConst(entries)) {
+                positions.insert(entry, treePosition(entry));
+            }
+            std::sort(entries.begin(), entries.end(), [&positions](const Entry* lhs, const Entry* rhs) {
+                return positions.value(lhs) < positions.value(rhs);
+            });
+        }
+    } // namespace
+
     Collection* Collection::Create(Service* parent, DatabaseWidget* backend)
     {
         return new Collection(parent, backend);
@@ -40,6 +71,7 @@ namespace FdoSecrets
         : DBusObject(parent)
         , m_backend(backend)
         , m_exposedGroup(nullptr)
+        , m_attributeIndex(new ItemAttributeIndex(this))
     {
         // whenever the file path or the database object itself change, we do a full reload.
         connect(backend, &DatabaseWidget::databaseFilePathChanged, this, &Collection::reloadBackendOrDelete);
@@ -64,10 +96,7 @@ namespace FdoSecrets
 
         // delete all items
         // this has to be done because the backend is actually still there, just we don't expose them
-        // NOTE: Do NOT use a for loop, because Item::removeFromDBus will remove itself from m_items.
-        while (!m_items.isEmpty()) {
-            m_items.first()->removeFromDBus();
-        }
+        removeAllItems();
         cleanupConnections();
         dbus()->unregisterObject(this);
 
@@ -113,13 +142,31 @@ namespace FdoSecrets
         return {};
     }
 
-    DBusResult Collection::items(QList<Item*>& items) const
+    DBusResult Collection::items(QList<QDBusObjectPath>& items) const
     {
         auto ret = ensureBackend();
         if (ret.err()) {
             return ret;
         }
-        items = m_items;
+        // only list the paths, items are created when they are actually accessed
+        items.clear();
+        if (backendLocked()) {
+            return {};
+        }
+        // report the items in tree order, the exposed entries are kept in a hash
+        QList<Entry*> entries;
+        entries.reserve(m_exposedEntries.size());
+        for (const auto& entry : asConst(m_exposedEntries)) {
+            if (entry) {
+                entries << entry;
+            }
+        }
+        sortByTreePosition(entries);
+
+        items.reserve(entries.size());
+        for (const auto* entry : asConst(entries)) {
+            items << itemPath(entry->uuidToHex());
+        }
         return {};
     }
 
@@ -229,22 +276,38 @@ namespace FdoSecrets
         // shortcut logic for Uuid/Path attributes, as they can uniquely identify an item.
         if (attributes.contains(ItemAttributes::UuidKey)) {
             auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(attributes.value(ItemAttributes::UuidKey).toLatin1()));
-            auto entry = m_exposedGroup->findEntryByUuid(uuid);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemById(Tools::uuidToHex(uuid));
+            if (item) {
+                items += item;
             }
             return {};
         }
 
         if (attributes.contains(ItemAttributes::PathKey)) {
             auto path = attributes.value(ItemAttributes::PathKey);
-            auto entry = m_exposedGroup->findEntryByPath(path);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemForEntry(m_exposedGroup->findEntryByPath(path));
+            if (item) {
+                items += item;
             }
             return {};
         }
 
+        // searching using empty terms returns nothing
+        if (attributes.isEmpty()) {
+            return {};
+        }
+
+        // look up the entries having the exact attribute values, only those
+        // with unindexed values still have to be matched one by one
+        const auto candidateSet = m_attributeIndex->candidates(attributes);
+        if (candidateSet.isEmpty()) {
+            return {};
+        }
+
+        // report the items in tree order, like a plain search of the exposed group would
+        auto candidates = candidateSet.values();
+        sortByTreePosition(candidates);
+
         QList<EntrySearcher::SearchTerm> terms;
         for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
             terms << attributeToTerm(it.key(), it.value());
@@ -252,12 +315,10 @@ namespace FdoSecrets
 
         constexpr auto caseSensitive = false;
         constexpr auto skipProtected = true;
-        constexpr auto forceSearch = true;
-        const auto foundEntries =
-            EntrySearcher(caseSensitive, skipProtected).search(terms, m_exposedGroup, forceSearch);
+        const auto foundEntries = EntrySearcher(caseSensitive, skipProtected).searchEntries(terms, candidates);
         items.reserve(foundEntries.size());
         for (const auto& entry : foundEntries) {
-            const auto item = m_entryToItem.value(entry);
+            const auto item = itemForEntry(entry);
             // it's possible that we don't have a corresponding item for the entry
             // this can happen when the recycle bin is below the exposed group.
             if (item) {
@@ -478,9 +539,7 @@ namespace FdoSecrets
         // delete all items
         // this has to be done because the backend is actually still there
         // just we don't expose them
-        for (const auto& item : asConst(m_items)) {
-            item->removeFromDBus();
-        }
+        removeAllItems();
 
         // repopulate
         if (!backendLocked()) {
@@ -494,32 +553,135 @@ namespace FdoSecrets
             return;
         }
 
+        // the item itself is only created once it is accessed, see itemById
+        const auto id = entry->uuidToHex();
+        m_exposedEntries.insert(id, entry);
+        m_attributeIndex->addEntry(entry);
+
+        // forward delete signals
+        connect(entry->group(),
+                &Group::entryAboutToRemove,
+                this,
+                &Collection::onEntryAboutToRemove,
+                Qt::UniqueConnection);
+
+        // relay signals
+        connect(entry, &Entry::modified, this, [this, id]() { emit itemChanged(itemPath(id)); });
+
+        if (emitSignal) {
+            emit itemCreated(itemPath(id));
+        }
+    }
+
+    void Collection::onEntryAboutToRemove(Entry* entry)
+    {
+        const auto id = entry->uuidToHex();
+        if (m_exposedEntries.value(id) != entry) {
+            return;
+        }
+        m_exposedEntries.remove(id);
+        m_attributeIndex->removeEntry(entry);
+        entry->disconnect(this);
+
+        const auto loaded = m_loadedItems.take(id);
+        if (loaded.item) {
+            loaded.item->removeFromDBus();
+        }
+        emit itemDeleted(itemPath(id));
+    }
+
+    Item* Collection::itemById(const QString& id)
+    {
+        auto it = m_loadedItems.find(id);
+        if (it != m_loadedItems.end()) {
+            it->lastUsed = ++m_itemUseCounter;
+            return it->item;
+        }
+
+        auto entry = m_exposedEntries.value(id);
+        if (!entry) {
+            return nullptr;
+        }
         auto item = Item::Create(this, entry);
         if (!item) {
+            return nullptr;
+        }
+        m_loadedItems.insert(id, {item, ++m_itemUseCounter});
+
+        // unload from the event loop, so the items returned by the current call keep their object paths
+        if (m_loadedItems.size() > MaxLoadedItems && !m_unloadPending) {
+            m_unloadPending = true;
+            QTimer::singleShot(0, this, &Collection::unloadLeastRecentlyUsedItems);
+        }
+        return item;
+    }
+
+    Item* Collection::itemForEntry(const Entry* entry)
+    {
+        if (!entry) {
+            return nullptr;
+        }
+        return itemById(entry->uuidToHex());
+    }
+
+    QStringList Collection::itemIds() const
+    {
+        return m_exposedEntries.keys();
+    }
+
+    QDBusObjectPath Collection::itemPath(const QString& id) const
+    {
+        return QDBusObjectPath(DBUS_PATH_TEMPLATE_ITEM.arg(objectPath().path(), id));
+    }
+
+    void Collection::unloadLeastRecentlyUsedItems()
+    {
+        m_unloadPending = false;
+        if (m_loadedItems.size() <= MaxLoadedItems) {
             return;
         }
 
-        m_items << item;
-        m_entryToItem[entry] = item;
+        QVector<quint64> lastUsed;
+        lastUsed.reserve(m_loadedItems.size());
+        for (const auto& loaded : asConst(m_loadedItems)) {
+            lastUsed << loaded.lastUsed;
+        }
+        auto threshold = lastUsed.begin() + (m_loadedItems.size() - MaxLoadedItems);
+        std::nth_element(lastUsed.begin(), threshold, lastUsed.end());
 
-        // forward delete signals
-        connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
-            if (item->backend() == toBeRemoved) {
-                item->removeFromDBus();
+        for (auto it = m_loadedItems.begin(); it != m_loadedItems.end();) {
+            if (it->lastUsed >= *threshold || it->item->isPinned()) {
+                ++it;
+                continue;
             }
-        });
+            // the entry is still exposed, so no ItemDeleted signal here,
+            // the item will be created again at the same path when accessed
+            it->item->removeFromDBus();
+            it = m_loadedItems.erase(it);
+        }
+    }
 
-        // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
-        connect(item, &Item::itemAboutToDelete, this, [this, item]() {
-            m_items.removeAll(item);
-            m_entryToItem.remove(item->backend());
-            emit itemDeleted(item);
-        });
+    void Collection::removeAllItems()
+    {
+        for (auto it = m_exposedEntries.constBegin(); it != m_exposedEntries.constEnd(); ++it) {
+            emit itemDeleted(itemPath(it.key()));
+        }
+        unloadItems();
+    }
 
-        if (emitSignal) {
-            emit itemCreated(item);
+    void Collection::unloadItems()
+    {
+        for (const auto& entry : asConst(m_exposedEntries)) {
+            if (entry) {
+                entry->disconnect(this);
+            }
+        }
+        m_exposedEntries.clear();
+        for (const auto& loaded : asConst(m_loadedItems)) {
+            loaded.item->removeFromDBus();
         }
+        m_loadedItems.clear();
+        m_attributeIndex->clear();
     }
 
     void Collection::connectGroupSignalRecursive(Group* group)
@@ -606,7 +768,7 @@ namespace FdoSecrets
             }
         }
 
-        m_items.clear();
+        unloadItems();
     }
 
     QString Collection::backendFilePath() const
@@ -691,7 +853,7 @@ namespace FdoSecrets
         client->setItemAuthorized(entry->uuid(), AuthDecision::Allowed);
 
         // when creation finishes in backend, we will already have item
-        auto created = m_entryToItem.value(entry, nullptr);
+        auto created = itemForEntry(entry);
 
         return created;
     }
@@ -31,6 +31,7 @@ class Group;
 namespace FdoSecrets
 {
     class Item;
+    class ItemAttributeIndex;
     class PromptBase;
     class Service;
     class Collection : public DBusObject
@@ -52,7 +53,7 @@ namespace FdoSecrets
          */
         static Collection* Create(Service* parent, DatabaseWidget* backend);
 
-        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<Item*>& items) const;
+        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<QDBusObjectPath>& items) const;
 
         Q_INVOKABLE DBUS_PROPERTY DBusResult label(QString& label) const;
         Q_INVOKABLE DBusResult setLabel(const QString& label);
@@ -71,9 +72,10 @@ namespace FdoSecrets
         createItem(const QVariantMap& properties, const Secret& secret, bool replace, Item*& item, PromptBase*& prompt);
 
     signals:
-        void itemCreated(Item* item);
-        void itemDeleted(Item* item);
-        void itemChanged(Item* item);
+        // items are only created on demand, so the signals carry the object path of the exposed entry
+        void itemCreated(const QDBusObjectPath& itemPath);
+        void itemDeleted(const QDBusObjectPath& itemPath);
+        void itemChanged(const QDBusObjectPath& itemPath);
 
         void collectionChanged();
         void collectionAboutToDelete();
@@ -108,6 +110,16 @@ namespace FdoSecrets
         QString backendFilePath() const;
         Service* service() const;
 
+        /**
+         * Get the item of an exposed entry, creating and registering it on DBus on first use.
+         * Only a bounded number of items are kept, the least recently used ones are unloaded again.
+         * @param id the last component of the item's object path, i.e. the hex uuid of the entry
+         * @return the item, or nullptr if no such entry is exposed
+         */
+        Item* itemById(const QString& id);
+        Item* itemForEntry(const Entry* entry);
+        QStringList itemIds() const;
+
         static EntrySearcher::SearchTerm attributeToTerm(const QString& key, const QString& value);
 
     public slots:
@@ -135,11 +147,16 @@ namespace FdoSecrets
         // calls reloadBackend, delete self when error
         void reloadBackendOrDelete();
 
+        void onEntryAboutToRemove(Entry* entry);
+        void unloadLeastRecentlyUsedItems();
+
     private:
         friend class DeleteCollectionPrompt;
         friend class CreateCollectionPrompt;
 
         void onEntryAdded(Entry* entry, bool emitSignal);
+        void removeAllItems();
+        void unloadItems();
         void populateContents();
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
@@ -158,6 +175,8 @@ namespace FdoSecrets
          */
         DBusResult ensureUnlocked() const;
 
+        QDBusObjectPath itemPath(const QString& id) const;
+
         /**
          * Like mkdir -p, find or create the group by path, under m_exposedGroup
          * @param groupPath
@@ -171,8 +190,20 @@ namespace FdoSecrets
         QPointer<Group> m_exposedGroup;
 
         QSet<QString> m_aliases;
-        QList<Item*> m_items;
-        QMap<const Entry*, Item*> m_entryToItem;
+        // all entries exposed as items, keyed by item id
+        QHash<QString, QPointer<Entry>> m_exposedEntries;
+
+        struct LoadedItem
+        {
+            Item* item{nullptr};
+            quint64 lastUsed{0};
+        };
+        static constexpr int MaxLoadedItems = 1024;
+        QHash<QString, LoadedItem> m_loadedItems;
+        quint64 m_itemUseCounter{0};
+        bool m_unloadPending{false};
+
+        ItemAttributeIndex* m_attributeIndex;
     };
 
 } // namespace FdoSecrets
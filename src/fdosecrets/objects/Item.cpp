@@ -357,6 +357,22 @@ namespace FdoSecrets
         return {};
     }
 
+    void Item::pin()
+    {
+        ++m_pinCount;
+    }
+
+    void Item::unpin()
+    {
+        Q_ASSERT(m_pinCount > 0);
+        --m_pinCount;
+    }
+
+    bool Item::isPinned() const
+    {
+        return m_pinCount > 0;
+    }
+
     Entry* Item::backend() const
     {
         return m_backend;
@@ -91,6 +91,13 @@ namespace FdoSecrets
          */
         QString path() const;
 
+        /**
+         * Pinned items are not unloaded by their collection, e.g. while a prompt refers to them
+         */
+        void pin();
+        void unpin();
+        bool isPinned() const;
+
     public slots:
         // will actually delete the entry in KPXC
         bool doDelete();
@@ -113,6 +120,7 @@ namespace FdoSecrets
 
     private:
         QPointer<Entry> m_backend;
+        int m_pinCount = 0;
     };
 
 } // namespace FdoSecrets
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ItemAttributeIndex.h"
+
+#include "core/Entry.h"
+#include "core/Global.h"
+
+namespace FdoSecrets
+{
+    ItemAttributeIndex::ItemAttributeIndex(QObject* parent)
+        : QObject(parent)
+    {
+    }
+
+    /**
+     * Add an entry to the index. The entry is indexed on the next query
+     * and re-indexed whenever it is modified.
+     */
+    void ItemAttributeIndex::addEntry(Entry* entry)
+    {
+        Q_ASSERT(entry);
+        if (!m_dirty.contains(entry) && !m_entryValues.contains(entry)) {
+            connect(entry, &Entry::modified, this, [this, entry] { m_dirty.insert(entry); });
+        }
+        m_dirty.insert(entry);
+    }
+
+    void ItemAttributeIndex::removeEntry(Entry* entry)
+    {
+        Q_ASSERT(entry);
+        disconnect(entry, nullptr, this, nullptr);
+        m_dirty.remove(entry);
+        unindexEntry(entry);
+    }
+
+    void ItemAttributeIndex::clear()
+    {
+        for (auto entry : asConst(m_dirty)) {
+            disconnect(entry, nullptr, this, nullptr);
+        }
+        for (auto it = m_entryValues.constBegin(); it != m_entryValues.constEnd(); ++it) {
+            disconnect(it.key(), nullptr, this, nullptr);
+        }
+
+        m_values.clear();
+        m_unindexed.clear();
+        m_entryValues.clear();
+        m_entryUnindexed.clear();
+        m_dirty.clear();
+    }
+
+    /**
+     * Determine the entries that can possibly match all of the given attributes
+     * exactly, as searched by Collection::searchItems. The result is unordered.
+     */
+    QSet<Entry*> ItemAttributeIndex::candidates(const StringStringMap& attributes)
+    {
+        updateDirtyEntries();
+
+        QSet<Entry*> result;
+        bool first = true;
+        for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+            auto entries = m_values.value({it.key(), indexedValue(it.value())});
+            entries.unite(m_unindexed.value(it.key()));
+            if (first) {
+                result = entries;
+                first = false;
+            } else {
+                result.intersect(entries);
+            }
+
+            if (result.isEmpty()) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    void ItemAttributeIndex::indexEntry(Entry* entry)
+    {
+        // Fields searched with their placeholders resolved, see EntrySearcher
+        static const QStringList resolvedKeys{
+            EntryAttributes::TitleKey, EntryAttributes::UserNameKey, EntryAttributes::URLKey};
+
+        const auto attributes = entry->attributes();
+        QList<Attribute> values;
+        QStringList unindexed;
+        for (const auto& key : attributes->keys()) {
+            const auto value = attributes->value(key);
+            if (attributes->isProtected(key) || (resolvedKeys.contains(key) && value.contains('{'))) {
+                m_unindexed[key].insert(entry);
+                unindexed << key;
+                continue;
+            }
+
+            Attribute attribute{key, indexedValue(value)};
+            m_values[attribute].insert(entry);
+            values << attribute;
+        }
+        m_entryValues.insert(entry, values);
+        m_entryUnindexed.insert(entry, unindexed);
+    }
+
+    void ItemAttributeIndex::unindexEntry(Entry* entry)
+    {
+        const auto values = m_entryValues.take(entry);
+        for (const auto& attribute : values) {
+            auto it = m_values.find(attribute);
+            if (it != m_values.end()) {
+                it->remove(entry);
+                if (it->isEmpty()) {
+                    m_values.erase(it);
+                }
+            }
+        }
+
+        const auto unindexed = m_entryUnindexed.take(entry);
+        for (const auto& key : unindexed) {
+            auto it = m_unindexed.find(key);
+            if (it != m_unindexed.end()) {
+                it->remove(entry);
+                if (it->isEmpty()) {
+                    m_unindexed.erase(it);
+                }
+            }
+        }
+    }
+
+    void ItemAttributeIndex::updateDirtyEntries()
+    {
+        for (auto entry : asConst(m_dirty)) {
+            unindexEntry(entry);
+            indexEntry(entry);
+        }
+        m_dirty.clear();
+    }
+
+    /**
+     * Exact-match search terms anchor with $, which also matches before trailing
+     * line breaks. Index values without them so such values remain candidates.
+     */
+    QString ItemAttributeIndex::indexedValue(const QString& value)
+    {
+        int length = value.length();
+        while (length > 0 && value.at(length - 1) == '\n') {
+            --length;
+        }
+        return value.left(length);
+    }
+} // namespace FdoSecrets
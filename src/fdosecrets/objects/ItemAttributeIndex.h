@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_FDOSECRETS_ITEMATTRIBUTEINDEX_H
+#define KEEPASSXC_FDOSECRETS_ITEMATTRIBUTEINDEX_H
+
+#include "fdosecrets/dbus/DBusTypes.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+class Entry;
+
+namespace FdoSecrets
+{
+    /**
+     * Exact value index of the attributes of the entries exposed by a collection.
+     *
+     * The index only narrows down the entries a SearchItems call has to look at,
+     * the exact-match search terms are still applied to every candidate.
+     * Protected attributes and fields containing placeholders are not indexed
+     * and their entries are always reported as candidates.
+     * Modified entries are re-indexed lazily on the next query.
+     */
+    class ItemAttributeIndex : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit ItemAttributeIndex(QObject* parent = nullptr);
+
+        void addEntry(Entry* entry);
+        void removeEntry(Entry* entry);
+        void clear();
+
+        QSet<Entry*> candidates(const StringStringMap& attributes);
+
+    private:
+        using Attribute = QPair<QString, QString>;
+
+        void indexEntry(Entry* entry);
+        void unindexEntry(Entry* entry);
+        void updateDirtyEntries();
+
+        static QString indexedValue(const QString& value);
+
+        QHash<Attribute, QSet<Entry*>> m_values;
+        // Entries whose value of an attribute is not indexed, by attribute key
+        QHash<QString, QSet<Entry*>> m_unindexed;
+        QHash<Entry*, QList<Attribute>> m_entryValues;
+        QHash<Entry*, QStringList> m_entryUnindexed;
+        QSet<Entry*> m_dirty;
+    };
+} // namespace FdoSecrets
+
+#endif // KEEPASSXC_FDOSECRETS_ITEMATTRIBUTEINDEX_H
@@ -41,6 +41,27 @@ namespace FdoSecrets
         connect(this, &PromptBase::completed, this, &PromptBase::deleteLater);
     }
 
+    PromptBase::~PromptBase()
+    {
+        for (const auto& item : asConst(m_pinnedItems)) {
+            if (item) {
+                item->unpin();
+            }
+        }
+    }
+
+    /**
+     * Keep the item loaded while this prompt exists, so it is not unloaded by its
+     * collection and the prompt does not mistake it for a deleted item.
+     */
+    void PromptBase::pinItem(Item* item)
+    {
+        if (item) {
+            item->pin();
+            m_pinnedItems << item;
+        }
+    }
+
     QWindow* PromptBase::findWindow(const QString& windowId)
     {
         // find parent window, or nullptr if not found
@@ -214,6 +235,7 @@ namespace FdoSecrets
         }
         for (const auto& item : asConst(items)) {
             m_items[item->collection()] << item;
+            pinItem(item);
         }
     }
 
@@ -306,7 +328,7 @@ namespace FdoSecrets
                     // Already saw this entry
                     continue;
                 }
-                m_entryToItems[uuid] = item.data();
+                m_entryToItems[uuid] = item->objectPath();
                 entries << entry;
             }
         }
@@ -334,8 +356,7 @@ namespace FdoSecrets
             auto entry = it.key();
             auto uuid = entry->uuid();
             // get back the corresponding item
-            auto item = m_entryToItems.value(uuid);
-            if (!item) {
+            if (!m_entryToItems.contains(uuid)) {
                 continue;
             }
 
@@ -343,7 +364,7 @@ namespace FdoSecrets
             client->setItemAuthorized(uuid, it.value());
 
             if (client->itemAuthorized(uuid)) {
-                m_unlocked += item->objectPath();
+                m_unlocked += m_entryToItems.value(uuid);
             } else {
                 m_numRejected += 1;
             }
@@ -360,6 +381,7 @@ namespace FdoSecrets
         : PromptBase(parent)
         , m_item(item)
     {
+        pinItem(item);
     }
 
     PromptResult DeleteItemPrompt::promptSync(const DBusClientPtr&, const QString& windowId)
@@ -474,6 +496,7 @@ namespace FdoSecrets
                 return DBusResult{DBUS_ERROR_SECRET_NO_SUCH_OBJECT};
             }
         }
+        pinItem(m_item);
 
         // the item may be locked due to authorization
         // give the user a chance to unlock the item
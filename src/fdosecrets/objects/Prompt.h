@@ -30,6 +30,7 @@ class Entry;
 namespace FdoSecrets
 {
 
+    class Item;
     class Service;
 
     // a simple helper class to auto convert
@@ -102,6 +103,7 @@ namespace FdoSecrets
 
     protected:
         explicit PromptBase(Service* parent);
+        ~PromptBase() override;
 
         virtual PromptResult promptSync(const DBusClientPtr& client, const QString& windowId) = 0;
         virtual QVariant currentResult() const;
@@ -109,9 +111,12 @@ namespace FdoSecrets
         QWindow* findWindow(const QString& windowId);
         Service* service() const;
         void finishPrompt(bool dismissed);
+        void pinItem(Item* item);
 
     private:
         bool m_signalSent = false;
+        // items the prompt refers to, kept loaded until the prompt is gone
+        QList<QPointer<Item>> m_pinnedItems;
     };
 
     class Collection;
@@ -174,7 +179,8 @@ namespace FdoSecrets
 
         QList<QPointer<Collection>> m_collections;
         QHash<Collection*, QList<QPointer<Item>>> m_items;
-        QHash<QUuid, Item*> m_entryToItems;
+        // items may be unloaded while the dialog is open, so only remember their paths
+        QHash<QUuid, QDBusObjectPath> m_entryToItems;
 
         QList<QDBusObjectPath> m_unlocked;
         int m_numRejected = 0;
@@ -184,7 +190,6 @@ namespace FdoSecrets
         QString m_windowId;
     };
 
-    class Item;
     class DeleteItemPrompt : public PromptBase
     {
         Q_OBJECT
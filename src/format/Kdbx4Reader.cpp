@@ -27,6 +27,7 @@
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/ReadAheadStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
@@ -85,12 +86,20 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
 
+    // Verify the HMAC blocks and decrypt them on separate threads ahead of
+    // decompression and parsing, so the stages overlap instead of adding up
+    ReadAheadStream hmacReadAhead(&hmacStream);
+    if (!hmacReadAhead.open(QIODevice::ReadOnly)) {
+        raiseError(hmacReadAhead.errorString());
+        return false;
+    }
+
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
         raiseError(tr("Unknown cipher"));
         return false;
     }
-    SymmetricCipherStream cipherStream(&hmacStream);
+    SymmetricCipherStream cipherStream(&hmacReadAhead);
     if (!cipherStream.init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
         raiseError(cipherStream.errorString());
         return false;
@@ -99,15 +108,21 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         raiseError(cipherStream.errorString());
         return false;
     }
+
+    ReadAheadStream cipherReadAhead(&cipherStream);
+    if (!cipherReadAhead.open(QIODevice::ReadOnly)) {
+        raiseError(cipherReadAhead.errorString());
+        return false;
+    }
     // clang-format on
 
     QIODevice* xmlDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
+        xmlDevice = &cipherReadAhead;
     } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+        ioCompressor.reset(new QtIOCompressor(&cipherReadAhead));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
@@ -144,6 +159,7 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
     Q_ASSERT(xmlDevice);
 
     KdbxXmlReader xmlReader(KeePass2::FILE_VERSION_4, binaryPool());
+    xmlReader.setReadOptions(m_readOptions);
     xmlReader.readDatabase(xmlDevice, db, &randomStream);
 
     if (xmlReader.hasError()) {
@@ -294,8 +310,11 @@ bool Kdbx4Reader::readInnerHeaderField(QIODevice* device)
             raiseError(tr("Invalid inner header binary size"));
             return false;
         }
-        auto data = fieldData.mid(1);
-        m_binaryPool.insert(QString::number(m_binaryPool.size()), data);
+        if (m_readOptions.testFlag(KeePass2::SkipAttachments)) {
+            break;
+        }
+        // Large binaries are spilled to disk right away instead of piling up in memory
+        m_binaryPool.insert(QString::number(m_binaryPool.size()), AttachmentBlob::create(fieldData.mid(1)));
         break;
     }
     }
@@ -438,7 +457,7 @@ QVariantMap Kdbx4Reader::readVariantMap(QIODevice* device)
 /**
  * @return mapping from attachment keys to binary data
  */
-QHash<QString, QByteArray> Kdbx4Reader::binaryPool() const
+QHash<QString, QSharedPointer<const AttachmentBlob>> Kdbx4Reader::binaryPool() const
 {
     return m_binaryPool;
 }
@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_KDBX4READER_H
 #define KEEPASSX_KDBX4READER_H
 
+#include "core/AttachmentBlob.h"
 #include "format/KdbxReader.h"
 
 /**
@@ -32,7 +33,7 @@ public:
                           const QByteArray& headerData,
                           QSharedPointer<const CompositeKey> key,
                           Database* db) override;
-    QHash<QString, QByteArray> binaryPool() const;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool() const;
 
 protected:
     bool readHeaderField(StoreDataStream& headerStream, Database* db) override;
@@ -41,7 +42,7 @@ private:
     bool readInnerHeaderField(QIODevice* device);
     QVariantMap readVariantMap(QIODevice* device);
 
-    QHash<QString, QByteArray> m_binaryPool;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> m_binaryPool;
 };
 
 #endif // KEEPASSX_KDBX4READER_H
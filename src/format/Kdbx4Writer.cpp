@@ -18,6 +18,7 @@
 #include "Kdbx4Writer.h"
 
 #include <QBuffer>
+#include <QThread>
 
 #include "config-keepassx.h"
 #include "crypto/CryptoHash.h"
@@ -25,6 +26,7 @@
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
 #include "streams/SymmetricCipherStream.h"
+#include "streams/WriteBehindStream.h"
 #include "streams/qtiocompressor.h"
 
 bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
@@ -48,7 +50,7 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
     QByteArray protectedStreamKey = randomGen()->randomArray(64);
     QByteArray endOfHeader = "\r\n\r\n";
 
-    if (!db->setKey(db->key(), false, true)) {
+    if (!transformKey(db)) {
         raiseError(tr("Unable to calculate database key: %1").arg(db->keyError()));
         return false;
     }
@@ -111,16 +113,28 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
     CHECK_RETURN_FALSE(writeData(device, headerHash));
     CHECK_RETURN_FALSE(writeData(device, headerHmac));
 
+    // Serialization, compression, encryption and HMAC computation run as a pipeline:
+    // each write behind stream hands its data to the next stage on its own thread
+    // and the HMAC of consecutive blocks is computed concurrently.
     QScopedPointer<HmacBlockStream> hmacBlockStream;
+    QScopedPointer<WriteBehindStream> hmacWriteBehind;
     QScopedPointer<SymmetricCipherStream> cipherStream;
+    QScopedPointer<WriteBehindStream> cipherWriteBehind;
 
     hmacBlockStream.reset(new HmacBlockStream(device, hmacKey));
+    hmacBlockStream->setMaxPendingBlocks(QThread::idealThreadCount());
     if (!hmacBlockStream->open(QIODevice::WriteOnly)) {
         raiseError(hmacBlockStream->errorString());
         return false;
     }
 
-    cipherStream.reset(new SymmetricCipherStream(hmacBlockStream.data()));
+    hmacWriteBehind.reset(new WriteBehindStream(hmacBlockStream.data()));
+    if (!hmacWriteBehind->open(QIODevice::WriteOnly)) {
+        raiseError(hmacWriteBehind->errorString());
+        return false;
+    }
+
+    cipherStream.reset(new SymmetricCipherStream(hmacWriteBehind.data()));
 
     if (!cipherStream->init(mode, SymmetricCipher::Encrypt, finalKey, encryptionIV)) {
         raiseError(cipherStream->errorString());
@@ -131,13 +145,19 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
+    cipherWriteBehind.reset(new WriteBehindStream(cipherStream.data()));
+    if (!cipherWriteBehind->open(QIODevice::WriteOnly)) {
+        raiseError(cipherWriteBehind->errorString());
+        return false;
+    }
+
     QIODevice* outputDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        outputDevice = cipherStream.data();
+        outputDevice = cipherWriteBehind.data();
     } else {
-        ioCompressor.reset(new QtIOCompressor(cipherStream.data()));
+        ioCompressor.reset(new QtIOCompressor(cipherWriteBehind.data()));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::WriteOnly)) {
             raiseError(ioCompressor->errorString());
@@ -156,7 +176,10 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         writeInnerHeaderField(outputDevice, KeePass2::InnerHeaderFieldID::InnerRandomStreamKey, protectedStreamKey));
 
     // Write attachments to the inner header
-    auto idxMap = writeAttachments(outputDevice, db);
+    KdbxXmlWriter::BinaryIdxMap idxMap;
+    if (!writeAttachments(outputDevice, db, idxMap)) {
+        return false;
+    }
 
     CHECK_RETURN_FALSE(writeInnerHeaderField(outputDevice, KeePass2::InnerHeaderFieldID::End, QByteArray()));
 
@@ -174,10 +197,18 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
     if (ioCompressor) {
         ioCompressor->close();
     }
+    if (!cipherWriteBehind->reset()) {
+        raiseError(cipherWriteBehind->errorString());
+        return false;
+    }
     if (!cipherStream->reset()) {
         raiseError(cipherStream->errorString());
         return false;
     }
+    if (!hmacWriteBehind->reset()) {
+        raiseError(hmacWriteBehind->errorString());
+        return false;
+    }
     if (!hmacBlockStream->reset()) {
         raiseError(hmacBlockStream->errorString());
         return false;
@@ -211,20 +242,18 @@ bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeader
     return true;
 }
 
-KdbxXmlWriter::BinaryIdxMap Kdbx4Writer::writeAttachments(QIODevice* device, Database* db)
+bool Kdbx4Writer::writeAttachments(QIODevice* device, Database* db, KdbxXmlWriter::BinaryIdxMap& idxMap)
 {
     const QList<Entry*> allEntries = db->rootGroup()->entriesRecursive(true);
     QHash<QByteArray, qint64> writtenAttachments;
-    KdbxXmlWriter::BinaryIdxMap idxMap;
     qint64 nextIdx = 0;
 
     for (const Entry* entry : allEntries) {
         const QList<QString> attachmentKeys = entry->attachments()->keys();
         for (const QString& key : attachmentKeys) {
-            QByteArray data("\x01");
-            data.append(entry->attachments()->value(key));
-
-            CryptoHash hash(CryptoHash::Sha256);
+            // The blob digest is cached, so unchanged attachments are not hashed again
+            const auto blob = entry->attachments()->blob(key);
+            QByteArray hashResult = blob->digest();
 #ifdef WITH_XC_KEESHARE
             // Namespace KeeShare attachments so they don't get deduplicated together with attachments
             // from other databases. Prevents potential filesize side channels.
@@ -233,16 +262,21 @@ KdbxXmlWriter::BinaryIdxMap Kdbx4Writer::writeAttachments(QIODevice* device, Dat
                 group = entry->historyOwner()->group();
             }
             if (group && group->isShared()) {
-                hash.addData(group->uuid().toByteArray());
+                hashResult.prepend(group->uuid().toByteArray());
             } else {
-                hash.addData(db->uuid().toByteArray());
+                hashResult.prepend(db->uuid().toByteArray());
             }
 #endif
-            hash.addData(data);
 
             // Deduplicate attachments with the same hash
-            const auto hashResult = hash.result();
             if (!writtenAttachments.contains(hashResult)) {
+                QByteArray content;
+                if (!blob->readData(content)) {
+                    raiseError(tr("Unable to read the content of attachment \"%1\"").arg(key));
+                    return false;
+                }
+                QByteArray data("\x01");
+                data.append(content);
                 writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
                 writtenAttachments.insert(hashResult, nextIdx++);
             }
@@ -250,7 +284,7 @@ KdbxXmlWriter::BinaryIdxMap Kdbx4Writer::writeAttachments(QIODevice* device, Dat
         }
     }
 
-    return idxMap;
+    return true;
 }
 
 /**
@@ -33,7 +33,7 @@ public:
 
 private:
     bool writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeaderFieldID fieldId, const QByteArray& data);
-    KdbxXmlWriter::BinaryIdxMap writeAttachments(QIODevice* device, Database* db);
+    bool writeAttachments(QIODevice* device, Database* db, KdbxXmlWriter::BinaryIdxMap& idxMap);
     static bool serializeVariantMap(const QVariantMap& map, QByteArray& outputBytes);
 };
 
@@ -119,6 +119,19 @@ KeePass2::ProtectedStreamAlgo KdbxReader::protectedStreamAlgo() const
     return m_irsAlgo;
 }
 
+/**
+ * @return parts of the database that are left out when reading
+ */
+KeePass2::ReadOptions KdbxReader::readOptions() const
+{
+    return m_readOptions;
+}
+
+void KdbxReader::setReadOptions(KeePass2::ReadOptions options)
+{
+    m_readOptions = options;
+}
+
 /**
  * @param data stream cipher UUID as bytes
  */
@@ -47,6 +47,9 @@ public:
 
     KeePass2::ProtectedStreamAlgo protectedStreamAlgo() const;
 
+    KeePass2::ReadOptions readOptions() const;
+    void setReadOptions(KeePass2::ReadOptions options);
+
 protected:
     /**
      * Concrete reader implementation for reading database from device.
@@ -88,6 +91,7 @@ protected:
     QByteArray m_streamStartBytes;
     QByteArray m_protectedStreamKey;
     KeePass2::ProtectedStreamAlgo m_irsAlgo = KeePass2::ProtectedStreamAlgo::InvalidProtectedStreamAlgo;
+    KeePass2::ReadOptions m_readOptions = KeePass2::ReadAll;
 
 private:
     QPair<quint32, quint32> m_kdbxSignature;
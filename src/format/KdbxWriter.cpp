@@ -19,6 +19,7 @@
 
 #include <QBuffer>
 
+#include "core/Database.h"
 #include "format/KdbxXmlWriter.h"
 
 bool KdbxWriter::hasError() const
@@ -66,6 +67,35 @@ bool KdbxWriter::writeData(QIODevice* device, const QByteArray& data)
     return true;
 }
 
+/**
+ * Keep the KDF seed and transformed key of the database instead of
+ * re-deriving the key with a fresh seed on every write.
+ *
+ * The key is still transformed if it has not been transformed yet or
+ * includes a challenge-response component.
+ *
+ * @param reuse true to reuse the current transformed key
+ */
+void KdbxWriter::setReuseTransformedKey(bool reuse)
+{
+    m_reuseTransformedKey = reuse;
+}
+
+/**
+ * Transform the database key for writing.
+ *
+ * @param db database to write
+ * @return true on success
+ */
+bool KdbxWriter::transformKey(Database* db)
+{
+    if (m_reuseTransformedKey && !db->transformedDatabaseKey().isEmpty()
+        && db->key()->challengeResponseKeys().isEmpty()) {
+        return true;
+    }
+    return db->setKey(db->key(), false, true);
+}
+
 void KdbxWriter::extractDatabase(QByteArray& xmlOutput, Database* db)
 {
     QBuffer buffer;
@@ -53,6 +53,7 @@ public:
     virtual bool writeDatabase(QIODevice* device, Database* db) = 0;
 
     void extractDatabase(QByteArray& xmlOutput, Database* db);
+    void setReuseTransformedKey(bool reuse);
 
     bool hasError() const;
     QString errorString() const;
@@ -82,10 +83,12 @@ protected:
     }
 
     bool writeData(QIODevice* device, const QByteArray& data);
+    bool transformKey(Database* db);
     void raiseError(const QString& errorMessage);
 
     bool m_error = false;
     QString m_errorStr = "";
+    bool m_reuseTransformedKey = false;
 };
 
 #endif // KEEPASSXC_KDBXWRITER_H
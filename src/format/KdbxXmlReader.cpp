@@ -29,6 +29,90 @@
 
 #define UUID_LENGTH 16
 
+namespace
+{
+    int base64Value(ushort c)
+    {
+        if (c >= 'A' && c <= 'Z') {
+            return c - 'A';
+        }
+        if (c >= 'a' && c <= 'z') {
+            return c - 'a' + 26;
+        }
+        if (c >= '0' && c <= '9') {
+            return c - '0' + 52;
+        }
+        if (c == '+') {
+            return 62;
+        }
+        if (c == '/') {
+            return 63;
+        }
+        return -1;
+    }
+
+    /**
+     * Decode Base64 text directly into a buffer of the given capacity.
+     * Like QByteArray::fromBase64(), characters outside of the alphabet are skipped.
+     *
+     * @return number of decoded bytes, which may exceed the capacity
+     */
+    int decodeBase64(const QString& text, char* out, int capacity)
+    {
+        quint32 buffer = 0;
+        int bits = 0;
+        int length = 0;
+        for (const QChar c : text) {
+            const int value = base64Value(c.unicode());
+            if (value < 0) {
+                continue;
+            }
+            buffer = (buffer << 6) | static_cast<quint32>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                if (length < capacity) {
+                    out[length] = static_cast<char>(buffer >> bits);
+                }
+                ++length;
+                buffer &= (1u << bits) - 1;
+            }
+        }
+        return length;
+    }
+
+    QByteArray decodeBase64(const QString& text)
+    {
+        QByteArray data;
+        data.resize(text.size() * 3 / 4);
+        data.resize(decodeBase64(text, data.data(), data.size()));
+        return data;
+    }
+
+    /**
+     * Allocation free equivalent of Tools::isBase64().
+     */
+    bool isBase64(const QString& text)
+    {
+        if (text.size() % 4 != 0) {
+            return false;
+        }
+        int padding = 0;
+        for (int i = 0; i < text.size(); ++i) {
+            const QChar c = text.at(i);
+            if (c == '=') {
+                ++padding;
+                if (i < text.size() - 2) {
+                    return false;
+                }
+            } else if (padding > 0 || base64Value(c.unicode()) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
 /**
  * @param version KDBX version
  */
@@ -41,7 +125,7 @@ KdbxXmlReader::KdbxXmlReader(quint32 version)
  * @param version KDBX version
  * @param binaryPool binary pool
  */
-KdbxXmlReader::KdbxXmlReader(quint32 version, QHash<QString, QByteArray> binaryPool)
+KdbxXmlReader::KdbxXmlReader(quint32 version, QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool)
     : m_kdbxVersion(version)
     , m_binaryPool(std::move(binaryPool))
 {
@@ -97,6 +181,9 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
 
     m_tmpParent.reset(new Group());
 
+    // Element text is collected into this buffer, keep its capacity across elements
+    m_textBuffer.reserve(1024);
+
     bool rootGroupParsed = false;
 
     if (m_xml.hasError()) {
@@ -134,10 +221,12 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
         qWarning("KdbxXmlReader::readDatabase: found unused key \"%s\"", qPrintable(key));
     }
 
+    // All references to a binary share its blob, so its digest is computed at most once
     QMultiHash<QString, QPair<Entry*, QString>>::const_iterator i;
     for (i = m_binaryMap.constBegin(); i != m_binaryMap.constEnd(); ++i) {
         const QPair<Entry*, QString>& target = i.value();
-        target.first->attachments()->set(target.second, m_binaryPool[i.key()]);
+        const auto blob = m_binaryPool.value(i.key());
+        target.first->attachments()->setBlob(target.second, blob ? blob : AttachmentBlob::create({}));
     }
 
     m_meta->setUpdateDatetime(true);
@@ -168,6 +257,19 @@ void KdbxXmlReader::setStrictMode(bool strictMode)
     m_strictMode = strictMode;
 }
 
+/**
+ * @return parts of the database that are left out when reading
+ */
+KeePass2::ReadOptions KdbxXmlReader::readOptions() const
+{
+    return m_readOptions;
+}
+
+void KdbxXmlReader::setReadOptions(KeePass2::ReadOptions options)
+{
+    m_readOptions = options;
+}
+
 bool KdbxXmlReader::hasError() const
 {
     return m_error || m_xml.hasError();
@@ -267,7 +369,11 @@ void KdbxXmlReader::parseMeta()
         } else if (m_xml.name() == "MemoryProtection") {
             parseMemoryProtection();
         } else if (m_xml.name() == "CustomIcons") {
-            parseCustomIcons();
+            if (m_readOptions.testFlag(KeePass2::SkipCustomIcons)) {
+                m_xml.skipCurrentElement();
+            } else {
+                parseCustomIcons();
+            }
         } else if (m_xml.name() == "RecycleBinEnabled") {
             m_meta->setRecycleBinEnabled(readBool());
         } else if (m_xml.name() == "RecycleBinUUID") {
@@ -297,7 +403,11 @@ void KdbxXmlReader::parseMeta()
                 qWarning("HistoryMaxSize invalid number");
             }
         } else if (m_xml.name() == "Binaries") {
-            parseBinaries();
+            if (m_readOptions.testFlag(KeePass2::SkipAttachments)) {
+                skipCurrentElementKeepStream();
+            } else {
+                parseBinaries();
+            }
         } else if (m_xml.name() == "CustomData") {
             parseCustomData(m_meta->customData());
         } else if (m_xml.name() == "SettingsChanged") {
@@ -399,7 +509,7 @@ void KdbxXmlReader::parseBinaries()
             qWarning("KdbxXmlReader::parseBinaries: overwriting binary item \"%s\"", qPrintable(id));
         }
 
-        m_binaryPool.insert(id, data);
+        m_binaryPool.insert(id, AttachmentBlob::create(data));
     }
 }
 
@@ -747,6 +857,10 @@ Entry* KdbxXmlReader::parseEntry(bool history)
             continue;
         }
         if (m_xml.name() == "Binary") {
+            if (m_readOptions.testFlag(KeePass2::SkipAttachments)) {
+                skipCurrentElementKeepStream();
+                continue;
+            }
             QPair<QString, QString> ref = parseEntryBinary(entry);
             if (!ref.first.isEmpty() && !ref.second.isEmpty()) {
                 binaryRefs.append(ref);
@@ -760,6 +874,8 @@ Entry* KdbxXmlReader::parseEntry(bool history)
         if (m_xml.name() == "History") {
             if (history) {
                 raiseError(tr("History element in history entry"));
+            } else if (m_readOptions.testFlag(KeePass2::SkipHistory)) {
+                skipCurrentElementKeepStream();
             } else {
                 historyItems = parseEntryHistory();
             }
@@ -1017,27 +1133,25 @@ QString KdbxXmlReader::readString(bool& isProtected, bool& protectInMemory)
     QXmlStreamAttributes attr = m_xml.attributes();
     isProtected = isTrueValue(attr.value("Protected"));
     protectInMemory = isTrueValue(attr.value("ProtectInMemory"));
-    QString value = m_xml.readElementText();
+    const QString& text = readElementText();
 
-    if (isProtected && !value.isEmpty()) {
-        QByteArray ciphertext = QByteArray::fromBase64(value.toLatin1());
-        bool ok;
-        QByteArray plaintext = m_randomStream->process(ciphertext, &ok);
-        if (!ok) {
-            value.clear();
+    if (isProtected && !text.isEmpty()) {
+        QByteArray data = decodeBase64(text);
+        if (!m_randomStream->processInPlace(data)) {
             raiseError(m_randomStream->errorString());
-            return value;
+            return {};
         }
 
-        value = QString::fromUtf8(plaintext);
+        return QString::fromUtf8(data);
     }
 
-    return value;
+    // Deep copy, sharing the buffer would discard its reserved capacity
+    return QString(text.constData(), text.size());
 }
 
 bool KdbxXmlReader::readBool()
 {
-    QString str = readString();
+    const QString& str = readElementText();
 
     if (str.compare("true", Qt::CaseInsensitive) == 0) {
         return true;
@@ -1054,10 +1168,11 @@ bool KdbxXmlReader::readBool()
 
 QDateTime KdbxXmlReader::readDateTime()
 {
-    QString str = readString();
-    if (Tools::isBase64(str.toLatin1())) {
-        QByteArray secsBytes = QByteArray::fromBase64(str.toUtf8()).leftJustified(8, '\0', true).left(8);
-        qint64 secs = Endian::bytesToSizedInt<quint64>(secsBytes, KeePass2::BYTEORDER);
+    const QString& str = readElementText();
+    if (isBase64(str)) {
+        char secsBytes[8] = {};
+        decodeBase64(str, secsBytes, sizeof(secsBytes));
+        qint64 secs = Endian::bytesToSizedInt<quint64>(QByteArray::fromRawData(secsBytes, 8), KeePass2::BYTEORDER);
         return QDateTime(QDate(1, 1, 1), QTime(0, 0, 0, 0), Qt::UTC).addSecs(secs);
     }
 
@@ -1089,9 +1204,8 @@ QString KdbxXmlReader::readColor()
     }
 
     for (int i = 0; i <= 2; ++i) {
-        QString rgbPartStr = colorStr.mid(1 + 2 * i, 2);
         bool ok;
-        int rgbPart = rgbPartStr.toInt(&ok, 16);
+        int rgbPart = colorStr.midRef(1 + 2 * i, 2).toInt(&ok, 16);
         if (!ok || rgbPart > 255) {
             if (m_strictMode) {
                 raiseError(tr("Invalid color rgb part"));
@@ -1106,7 +1220,7 @@ QString KdbxXmlReader::readColor()
 int KdbxXmlReader::readNumber()
 {
     bool ok;
-    int result = readString().toInt(&ok);
+    int result = readElementText().toInt(&ok);
     if (!ok) {
         raiseError(tr("Invalid number value"));
     }
@@ -1115,7 +1229,20 @@ int KdbxXmlReader::readNumber()
 
 QUuid KdbxXmlReader::readUuid()
 {
-    QByteArray uuidBin = readBinary();
+    QXmlStreamAttributes attr = m_xml.attributes();
+    bool isProtected = isTrueValue(attr.value("Protected"));
+    if (isProtected) {
+        return uuidFromBinary(readBinary());
+    }
+
+    // One spare byte so that overlong values are detected
+    char uuidBin[UUID_LENGTH + 1];
+    int length = decodeBase64(readElementText(), uuidBin, UUID_LENGTH + 1);
+    return uuidFromBinary(QByteArray::fromRawData(uuidBin, qMin(length, UUID_LENGTH + 1)));
+}
+
+QUuid KdbxXmlReader::uuidFromBinary(const QByteArray& uuidBin)
+{
     if (uuidBin.isEmpty()) {
         return {};
     }
@@ -1132,24 +1259,46 @@ QByteArray KdbxXmlReader::readBinary()
 {
     QXmlStreamAttributes attr = m_xml.attributes();
     bool isProtected = isTrueValue(attr.value("Protected"));
-    QString value = m_xml.readElementText();
-    QByteArray data = QByteArray::fromBase64(value.toLatin1());
-
-    if (isProtected && !data.isEmpty()) {
-        bool ok;
-        QByteArray plaintext = m_randomStream->process(data, &ok);
-        if (!ok) {
-            data.clear();
-            raiseError(m_randomStream->errorString());
-            return data;
-        }
+    QByteArray data = decodeBase64(readElementText());
 
-        data = plaintext;
+    if (isProtected && !data.isEmpty() && !m_randomStream->processInPlace(data)) {
+        data.clear();
+        raiseError(m_randomStream->errorString());
     }
 
     return data;
 }
 
+/**
+ * Read the text of the current element into a buffer that is reused for every element.
+ * The returned reference is only valid until the next element is read.
+ */
+const QString& KdbxXmlReader::readElementText()
+{
+    Q_ASSERT(m_xml.isStartElement());
+
+    m_textBuffer.resize(0);
+    while (!m_xml.atEnd()) {
+        switch (m_xml.readNext()) {
+        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::EntityReference:
+            m_textBuffer.append(m_xml.text());
+            break;
+        case QXmlStreamReader::EndElement:
+            return m_textBuffer;
+        case QXmlStreamReader::Comment:
+        case QXmlStreamReader::ProcessingInstruction:
+            break;
+        case QXmlStreamReader::StartElement:
+            m_xml.raiseError(QXmlStreamReader::tr("Expected character data."));
+            return m_textBuffer;
+        default:
+            return m_textBuffer;
+        }
+    }
+    return m_textBuffer;
+}
+
 QByteArray KdbxXmlReader::readCompressedBinary()
 {
     QByteArray rawData = readBinary();
@@ -1210,3 +1359,31 @@ void KdbxXmlReader::skipCurrentElement()
     qWarning("KdbxXmlReader::skipCurrentElement: skip element \"%s\"", qPrintable(m_xml.name().toString()));
     m_xml.skipCurrentElement();
 }
+
+/**
+ * Skip the current element on purpose, e.g. because of the read options.
+ *
+ * Protected values inside the element still advance the inner random stream,
+ * otherwise all protected values after the element would be decrypted wrongly.
+ */
+void KdbxXmlReader::skipCurrentElementKeepStream()
+{
+    Q_ASSERT(m_xml.isStartElement());
+
+    while (!m_xml.hasError() && m_xml.readNextStartElement()) {
+        if (!isTrueValue(m_xml.attributes().value("Protected"))) {
+            skipCurrentElementKeepStream();
+            continue;
+        }
+
+        const QByteArray data = decodeBase64(readElementText());
+        if (data.isEmpty() || !m_randomStream) {
+            continue;
+        }
+        bool ok;
+        m_randomStream->randomBytes(data.size(), &ok);
+        if (!ok) {
+            raiseError(m_randomStream->errorString());
+        }
+    }
+}
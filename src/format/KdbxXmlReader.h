@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_KDBXXMLREADER_H
 #define KEEPASSXC_KDBXXMLREADER_H
 
+#include "core/AttachmentBlob.h"
 #include "core/Database.h"
 #include "core/Metadata.h"
 
@@ -40,7 +41,7 @@ class KdbxXmlReader
 
 public:
     explicit KdbxXmlReader(quint32 version);
-    explicit KdbxXmlReader(quint32 version, QHash<QString, QByteArray> binaryPool);
+    explicit KdbxXmlReader(quint32 version, QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool);
     virtual ~KdbxXmlReader() = default;
 
     virtual QSharedPointer<Database> readDatabase(const QString& filename);
@@ -55,6 +56,9 @@ public:
     bool strictMode() const;
     void setStrictMode(bool strictMode);
 
+    KeePass2::ReadOptions readOptions() const;
+    void setReadOptions(KeePass2::ReadOptions options);
+
 protected:
     typedef QPair<QString, QString> StringPair;
 
@@ -88,7 +92,11 @@ protected:
     virtual QByteArray readBinary();
     virtual QByteArray readCompressedBinary();
 
+    const QString& readElementText();
+    QUuid uuidFromBinary(const QByteArray& uuidBin);
+
     virtual void skipCurrentElement();
+    void skipCurrentElementKeepStream();
 
     virtual Group* getGroup(const QUuid& uuid);
     virtual Entry* getEntry(const QUuid& uuid);
@@ -99,17 +107,19 @@ protected:
     const quint32 m_kdbxVersion;
 
     bool m_strictMode = false;
+    KeePass2::ReadOptions m_readOptions = KeePass2::ReadAll;
 
     QPointer<Database> m_db;
     QPointer<Metadata> m_meta;
     KeePass2RandomStream* m_randomStream = nullptr;
     QXmlStreamReader m_xml;
+    QString m_textBuffer;
 
     QScopedPointer<Group> m_tmpParent;
     QHash<QUuid, Group*> m_groups;
     QHash<QUuid, Entry*> m_entries;
 
-    QHash<QString, QByteArray> m_binaryPool;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> m_binaryPool;
     QMultiHash<QString, QPair<Entry*, QString>> m_binaryMap;
     QByteArray m_headerHash;
 
@@ -22,7 +22,6 @@
 #include <QMap>
 
 #include "core/Endian.h"
-#include "crypto/CryptoHash.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/qtiocompressor.h"
 
@@ -107,8 +106,8 @@ void KdbxXmlWriter::fillBinaryIdxMap()
     for (Entry* entry : allEntries) {
         const QList<QString> attachmentKeys = entry->attachments()->keys();
         for (const QString& key : attachmentKeys) {
-            QByteArray data = entry->attachments()->value(key);
-            CryptoHash hash(CryptoHash::Sha256);
+            // The blob digest is cached, so unchanged attachments are not hashed again
+            QByteArray hashResult = entry->attachments()->blob(key)->digest();
 #ifdef WITH_XC_KEESHARE
             // Namespace KeeShare attachments so they don't get deduplicated together with attachments
             // from other databases. Prevents potential filesize side channels.
@@ -117,14 +116,12 @@ void KdbxXmlWriter::fillBinaryIdxMap()
                 group = entry->historyOwner()->group();
             }
             if (group && group->isShared()) {
-                hash.addData(group->uuid().toByteArray());
+                hashResult.prepend(group->uuid().toByteArray());
             } else {
-                hash.addData(m_db->uuid().toByteArray());
+                hashResult.prepend(m_db->uuid().toByteArray());
             }
 #endif
-            hash.addData(data);
 
-            const auto hashResult = hash.result();
             if (!writtenAttachments.contains(hashResult)) {
                 writtenAttachments.insert(hashResult, nextIdx++);
             }
@@ -222,7 +219,11 @@ void KdbxXmlWriter::writeBinaries()
     QMap<qint64, QByteArray> binaries;
     for (auto i = m_binaryIdxMap.constBegin(); i != m_binaryIdxMap.constEnd(); ++i) {
         if (!binaries.contains(i.value())) {
-            binaries.insert(i.value(), i.key().first->attachments()->value(i.key().second));
+            QByteArray data;
+            if (!i.key().first->attachments()->readValue(i.key().second, data)) {
+                raiseError(tr("Unable to read the content of attachment \"%1\"").arg(i.key().second));
+            }
+            binaries.insert(i.value(), data);
         }
     }
 
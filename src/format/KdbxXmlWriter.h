@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_KDBXXMLWRITER_H
 #define KEEPASSX_KDBXXMLWRITER_H
 
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QXmlStreamWriter>
 
@@ -29,6 +30,8 @@ class KeePass2RandomStream;
 
 class KdbxXmlWriter
 {
+    Q_DECLARE_TR_FUNCTIONS(KdbxXmlWriter)
+
 public:
     /**
      * Map of entry + attachment key to KDBX 4 inner header binary index.
@@ -103,6 +103,20 @@ namespace KeePass2
         InvalidProtectedStreamAlgo = -1
     };
 
+    /**
+     * Parts of a database that can be left out when reading it, e.g. for read-only
+     * listing. A database read without all parts must never be saved.
+     */
+    enum ReadOption
+    {
+        ReadAll = 0,
+        SkipHistory = 1, // do not read history items of entries
+        SkipAttachments = 2, // do not read attachments and their binaries
+        SkipCustomIcons = 4, // do not read custom icon data
+        SkipAll = SkipHistory | SkipAttachments | SkipCustomIcons
+    };
+    Q_DECLARE_FLAGS(ReadOptions, ReadOption)
+
     enum class VariantMapFieldType : quint8
     {
         End = 0,
@@ -134,4 +148,6 @@ namespace KeePass2
     QString kdfToString(QUuid kdfUuid);
 } // namespace KeePass2
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(KeePass2::ReadOptions)
+
 #endif // KEEPASSX_KEEPASS2_H
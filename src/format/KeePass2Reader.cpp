@@ -93,6 +93,7 @@ bool KeePass2Reader::readDatabase(QIODevice* device, QSharedPointer<const Compos
     } else {
         m_reader.reset(new Kdbx4Reader());
     }
+    m_reader->setReadOptions(m_readOptions);
 
     return m_reader->readDatabase(device, std::move(key), db);
 }
@@ -107,6 +108,19 @@ QString KeePass2Reader::errorString() const
     return !m_reader.isNull() ? m_reader->errorString() : m_errorStr;
 }
 
+/**
+ * @return parts of the database that are left out when reading
+ */
+KeePass2::ReadOptions KeePass2Reader::readOptions() const
+{
+    return m_readOptions;
+}
+
+void KeePass2Reader::setReadOptions(KeePass2::ReadOptions options)
+{
+    m_readOptions = options;
+}
+
 /**
  * @return detected KDBX version
  */
@@ -33,6 +33,9 @@ public:
     bool hasError() const;
     QString errorString() const;
 
+    KeePass2::ReadOptions readOptions() const;
+    void setReadOptions(KeePass2::ReadOptions options);
+
     QSharedPointer<KdbxReader> reader() const;
     quint32 version() const;
 
@@ -44,6 +47,7 @@ private:
 
     QSharedPointer<KdbxReader> m_reader;
     quint32 m_version = 0;
+    KeePass2::ReadOptions m_readOptions = KeePass2::ReadAll;
 };
 
 #endif // KEEPASSX_KEEPASS2READER_H
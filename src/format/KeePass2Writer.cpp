@@ -137,6 +137,7 @@ bool KeePass2Writer::writeDatabase(QIODevice* device, Database* db)
         m_writer.reset(new Kdbx4Writer());
     }
 
+    m_writer->setReuseTransformedKey(m_reuseTransformedKey);
     return m_writer->writeDatabase(device, db);
 }
 
@@ -158,6 +159,17 @@ void KeePass2Writer::extractDatabase(Database* db, QByteArray& xmlOutput)
     m_writer->extractDatabase(xmlOutput, db);
 }
 
+/**
+ * Reuse the transformed key of the database instead of deriving it again
+ * with a new KDF seed, see KdbxWriter::setReuseTransformedKey().
+ *
+ * @param reuse true to reuse the current transformed key
+ */
+void KeePass2Writer::setReuseTransformedKey(bool reuse)
+{
+    m_reuseTransformedKey = reuse;
+}
+
 bool KeePass2Writer::hasError() const
 {
     return m_error || (m_writer && m_writer->hasError());
@@ -33,6 +33,7 @@ public:
     bool writeDatabase(const QString& filename, Database* db);
     bool writeDatabase(QIODevice* device, Database* db);
     void extractDatabase(Database* db, QByteArray& xmlOutput);
+    void setReuseTransformedKey(bool reuse);
     static quint32 kdbxVersionRequired(Database const* db, bool ignoreCurrent = false, bool ignoreKdf = false);
 
     QSharedPointer<KdbxWriter> writer() const;
@@ -49,6 +50,7 @@ private:
 
     QScopedPointer<KdbxWriter> m_writer;
     quint32 m_version = 0;
+    bool m_reuseTransformedKey = false;
 };
 
 #endif // KEEPASSX_KEEPASS2READER_H
@@ -35,6 +35,7 @@
 #include "core/AsyncTask.h"
 #include "core/EntrySearcher.h"
 #include "core/Merger.h"
+#include "core/PasswordHealthService.h"
 #include "core/Tools.h"
 #include "gui/Clipboard.h"
 #include "gui/CloneDialog.h"
@@ -1285,6 +1286,15 @@ void DatabaseWidget::connectDatabaseSignals()
     connect(m_db.data(), &Database::databaseFileChanged, this, &DatabaseWidget::reloadDatabaseFile);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::databaseNonDataChanged);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::onDatabaseNonDataChanged);
+
+    m_db->setSearchIndexEnabled(config()->get(Config::SearchIndex).toBool(),
+                                config()->get(Config::SearchIndexProtected).toBool());
+
+    // Evaluate the password health in the background for the reports, searches and entry view
+    if (config()->get(Config::PasswordHealthService).toBool()) {
+        m_db->setPasswordHealthServiceEnabled(true);
+        m_db->passwordHealthService()->evaluate();
+    }
 }
 
 void DatabaseWidget::loadDatabase(bool accepted)
@@ -1692,6 +1702,7 @@ void DatabaseWidget::search(const QString& searchtext)
         searchGroup = currentGroup();
     }
 
+    m_entrySearcher->setThreadCount(config()->get(Config::SearchThreadCount).toInt());
     auto results = m_entrySearcher->search(searchtext, searchGroup);
 
     // Display a label detailing our search results
@@ -2132,7 +2143,10 @@ void DatabaseWidget::reloadDatabaseFile()
             entryBeforeReload = m_entryView->currentEntry()->uuid();
         }
 
-        replaceDatabase(db);
+        // Patch the open database in place, so unchanged items and their views are kept
+        if (!m_db->reloadFrom(db.data())) {
+            replaceDatabase(db);
+        }
         processAutoOpen();
         restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
         m_blockAutoSave = false;
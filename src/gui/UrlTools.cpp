@@ -26,11 +26,60 @@
 
 Q_GLOBAL_STATIC(UrlTools, s_urlTools)
 
+namespace
+{
+    // Upper bound of cached URLs and domains
+    constexpr int MaxCachedUrls = 10000;
+} // namespace
+
+UrlTools::UrlTools()
+    : m_normalizedUrls(MaxCachedUrls)
+    , m_topLevelDomains(MaxCachedUrls)
+{
+}
+
 UrlTools* UrlTools::instance()
 {
     return s_urlTools;
 }
 
+/**
+ * Parse an entry URL once and cache the result.
+ *
+ * URLs with a scheme are parsed as is, URLs without one are parsed as user
+ * input, e.g. example.com/login -> http://example.com/login.
+ */
+NormalizedUrl UrlTools::normalizeUrl(const QString& url) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    if (const auto cached = m_normalizedUrls.object(url)) {
+        return *cached;
+    }
+    locker.unlock();
+
+    static const QRegularExpression illegalCharacters("[<>\\^`{|}]");
+
+    NormalizedUrl normalized;
+    normalized.hasScheme = url.contains("://");
+    normalized.url = normalized.hasScheme ? QUrl(url.trimmed()) : QUrl::fromUserInput(url);
+    normalized.scheme = normalized.url.scheme();
+    normalized.host = normalized.url.host();
+    normalized.port = normalized.url.port();
+    normalized.path = normalized.url.path();
+    normalized.hasIllegalCharacters = illegalCharacters.match(url).hasMatch();
+    if (!normalized.host.isEmpty()) {
+#if defined(WITH_XC_NETWORKING) || defined(WITH_XC_BROWSER)
+        normalized.baseDomain = getBaseDomainFromUrl(normalized.host);
+#else
+        normalized.baseDomain = normalized.host;
+#endif
+    }
+
+    locker.relock();
+    m_normalizedUrls.insert(url, new NormalizedUrl(normalized));
+    return normalized;
+}
+
 QUrl UrlTools::convertVariantToUrl(const QVariant& var) const
 {
     QUrl url;
@@ -90,6 +139,20 @@ QString UrlTools::getTopLevelDomainFromUrl(const QString& url) const
         return host;
     }
 
+    // The public suffix only depends on the host
+    QMutexLocker locker(&m_cacheMutex);
+    if (const auto cached = m_topLevelDomains.object(host)) {
+        return *cached;
+    }
+    locker.unlock();
+
+    const auto originalHost = host;
+    auto cacheResult = [&](const QString& tld) {
+        QMutexLocker cacheLocker(&m_cacheMutex);
+        m_topLevelDomains.insert(originalHost, new QString(tld));
+        return tld;
+    };
+
     const auto numberOfDomainParts = host.split('.').length();
     static const auto dummy = QByteArrayLiteral("");
 
@@ -103,11 +166,11 @@ QString UrlTools::getTopLevelDomainFromUrl(const QString& url) const
 
         // Check if dummy cookie's domain/TLD matches with public suffix list
         if (!QNetworkCookieJar{}.setCookiesFromUrl(QList{cookie}, QUrl::fromUserInput(url))) {
-            return host;
+            return cacheResult(host);
         }
     }
 
-    return host;
+    return cacheResult(host);
 }
 
 bool UrlTools::isIpAddress(const QString& host) const
@@ -176,6 +239,6 @@ bool UrlTools::isUrlValid(const QString& urlField) const
 
 bool UrlTools::domainHasIllegalCharacters(const QString& domain) const
 {
-    QRegularExpression re(R"([\s\^#|/:<>\?@\[\]\\])");
+    static const QRegularExpression re(R"([\s\^#|/:<>\?@\[\]\\])");
     return re.match(domain).hasMatch();
 }
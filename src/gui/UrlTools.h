@@ -19,6 +19,8 @@
 #define KEEPASSXC_URLTOOLS_H
 
 #include "config-keepassx.h"
+#include <QCache>
+#include <QMutex>
 #include <QObject>
 #include <QUrl>
 #include <QVariant>
@@ -26,14 +28,33 @@
 #include <QNetworkReply>
 #endif
 
+/**
+ * Entry URL split into the parts used for matching, see UrlTools::normalizeUrl().
+ */
+struct NormalizedUrl
+{
+    QUrl url;
+    QString scheme;
+    QString host;
+    int port = -1;
+    QString path;
+    // Public suffix aware base domain of the host, the host itself without networking support
+    QString baseDomain;
+    // The URL was given with an explicit scheme
+    bool hasScheme = false;
+    bool hasIllegalCharacters = false;
+};
+
 class UrlTools : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit UrlTools() = default;
+    explicit UrlTools();
     static UrlTools* instance();
 
+    NormalizedUrl normalizeUrl(const QString& url) const;
+
 #if defined(WITH_XC_NETWORKING) || defined(WITH_XC_BROWSER)
     QUrl getRedirectTarget(QNetworkReply* reply) const;
     QString getBaseDomainFromUrl(const QString& url) const;
@@ -48,6 +69,11 @@ private:
     QUrl convertVariantToUrl(const QVariant& var) const;
 
 private:
+    // Parsed URLs are keyed by the URL text, a changed entry URL simply misses the cache
+    mutable QCache<QString, NormalizedUrl> m_normalizedUrls;
+    mutable QCache<QString, QString> m_topLevelDomains;
+    mutable QMutex m_cacheMutex;
+
     Q_DISABLE_COPY(UrlTools);
 };
 
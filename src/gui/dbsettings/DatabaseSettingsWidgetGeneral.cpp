@@ -44,6 +44,10 @@ DatabaseSettingsWidgetGeneral::DatabaseSettingsWidgetGeneral(QWidget* parent)
     connect(m_ui->historyMaxItemsCheckBox, SIGNAL(toggled(bool)), m_ui->historyMaxItemsSpinBox, SLOT(setEnabled(bool)));
     connect(m_ui->historyMaxSizeCheckBox, SIGNAL(toggled(bool)), m_ui->historyMaxSizeSpinBox, SLOT(setEnabled(bool)));
     connect(m_ui->autosaveDelayCheckBox, SIGNAL(toggled(bool)), m_ui->autosaveDelaySpinBox, SLOT(setEnabled(bool)));
+    connect(m_ui->deletedObjectsMaxAgeCheckBox,
+            SIGNAL(toggled(bool)),
+            m_ui->deletedObjectsMaxAgeSpinBox,
+            SLOT(setEnabled(bool)));
 }
 
 DatabaseSettingsWidgetGeneral::~DatabaseSettingsWidgetGeneral() = default;
@@ -86,6 +90,13 @@ void DatabaseSettingsWidgetGeneral::initialize()
         m_ui->autosaveDelayCheckBox->setChecked(false);
         m_ui->autosaveDelaySpinBox->setEnabled(false);
     }
+    if (meta->deletedObjectsMaxAgeDays() > 0) {
+        m_ui->deletedObjectsMaxAgeSpinBox->setValue(meta->deletedObjectsMaxAgeDays());
+        m_ui->deletedObjectsMaxAgeCheckBox->setChecked(true);
+    } else {
+        m_ui->deletedObjectsMaxAgeCheckBox->setChecked(false);
+        m_ui->deletedObjectsMaxAgeSpinBox->setEnabled(false);
+    }
 }
 
 void DatabaseSettingsWidgetGeneral::uninitialize()
@@ -166,6 +177,12 @@ bool DatabaseSettingsWidgetGeneral::saveSettings()
     }
     meta->setAutosaveDelayMin(autosaveDelayMin);
 
+    int deletedObjectsMaxAgeDays = 0;
+    if (m_ui->deletedObjectsMaxAgeCheckBox->isChecked()) {
+        deletedObjectsMaxAgeDays = m_ui->deletedObjectsMaxAgeSpinBox->value();
+    }
+    meta->setDeletedObjectsMaxAgeDays(deletedObjectsMaxAgeDays);
+
     if (truncate) {
         const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(false);
         for (Entry* entry : allEntries) {
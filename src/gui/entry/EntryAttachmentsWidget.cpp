@@ -247,8 +247,12 @@ void EntryAttachmentsWidget::saveSelectedAttachments()
             }
         }
 
+        QByteArray attachmentData;
+        if (!m_entryAttachments->readValue(filename, attachmentData)) {
+            errors.append(tr("%1 - Unable to read the attachment content").arg(filename));
+            continue;
+        }
         QFile file(attachmentPath);
-        const QByteArray attachmentData = m_entryAttachments->value(filename);
         const bool saveOk = file.open(QIODevice::WriteOnly) && file.setPermissions(QFile::ReadUser | QFile::WriteUser)
                             && file.write(attachmentData) == attachmentData.size();
         if (!saveOk) {
@@ -22,6 +22,7 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/PasswordHealthService.h"
 #include "gui/GuiTools.h"
 #include "gui/Icons.h"
 #include "gui/styles/StateColorPalette.h"
@@ -230,6 +231,9 @@ void ReportsWidgetHealthcheck::addHealthRow(QSharedPointer<PasswordHealth> healt
 
 void ReportsWidgetHealthcheck::loadSettings(QSharedPointer<Database> db)
 {
+    if (m_db && m_db->passwordHealthService()) {
+        m_db->passwordHealthService()->disconnect(this);
+    }
     m_db = std::move(db);
     m_healthCalculated = false;
     m_referencesModel->clear();
@@ -240,6 +244,14 @@ void ReportsWidgetHealthcheck::loadSettings(QSharedPointer<Database> db)
     m_referencesModel->appendRow(row);
 }
 
+void ReportsWidgetHealthcheck::showProgress(int value, int maximum)
+{
+    m_referencesModel->clear();
+    auto row = QList<QStandardItem*>();
+    row << new QStandardItem(tr("Please wait, health data is being calculated… (%1 of %2)").arg(value).arg(maximum));
+    m_referencesModel->appendRow(row);
+}
+
 void ReportsWidgetHealthcheck::showEvent(QShowEvent* event)
 {
     QWidget::showEvent(event);
@@ -253,6 +265,25 @@ void ReportsWidgetHealthcheck::showEvent(QShowEvent* event)
 
 void ReportsWidgetHealthcheck::calculateHealth()
 {
+    // The service is disabled in the settings, evaluate the passwords for this report anyway
+    if (!m_db->passwordHealthService()) {
+        m_db->setPasswordHealthServiceEnabled(true);
+        m_db->passwordHealthService()->evaluate();
+    }
+
+    // Wait for the background evaluation rather than running zxcvbn for every entry here
+    auto* service = m_db->passwordHealthService();
+    if (service) {
+        service->disconnect(this);
+        if (service->isEvaluating()) {
+            connect(service, &PasswordHealthService::progressChanged, this, &ReportsWidgetHealthcheck::showProgress);
+            connect(
+                service, &PasswordHealthService::evaluationFinished, this, &ReportsWidgetHealthcheck::calculateHealth);
+            showProgress(service->progressValue(), service->progressMaximum());
+            return;
+        }
+    }
+
     m_referencesModel->clear();
 
     // Perform the health check
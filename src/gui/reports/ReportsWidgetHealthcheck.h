@@ -55,6 +55,9 @@ public slots:
     void customMenuRequested(QPoint);
     void deleteSelectedEntries();
 
+private slots:
+    void showProgress(int value, int maximum);
+
 private:
     void addHealthRow(QSharedPointer<PasswordHealth>, Group*, Entry*, bool excluded);
 
@@ -26,6 +26,7 @@
 #include "keys/PasswordKey.h"
 
 #include <QBuffer>
+#include <QSaveFile>
 #include <botan/pubkey.h>
 #include <minizip/zip.h>
 
@@ -62,10 +63,14 @@ namespace
         }
     }
 
-    Database* extractIntoDatabase(const KeeShareSettings::Reference& reference, const Group* sourceRoot)
+    Database* extractIntoDatabase(const KeeShareSettings::Reference& reference,
+                                  const Group* sourceRoot,
+                                  const Database* keySource)
     {
         const auto* sourceDb = sourceRoot->database();
         auto* targetDb = new Database();
+        // The export database is written on a worker thread, keep its modified timer out of it
+        targetDb->setEmitModified(false);
         auto* targetMetadata = targetDb->metadata();
         targetMetadata->setRecycleBinEnabled(false);
 
@@ -88,9 +93,14 @@ namespace
             }
         }
 
-        auto key = QSharedPointer<CompositeKey>::create();
-        key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
-        targetDb->setKey(key);
+        if (keySource) {
+            targetDb->adoptKey(keySource);
+        } else {
+            // The key is transformed when the container is written
+            auto key = QSharedPointer<CompositeKey>::create();
+            key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
+            targetDb->setKey(key, true, false, false);
+        }
 
         auto obsoleteRoot = targetDb->setRootGroup(targetRoot);
         delete obsoleteRoot;
@@ -101,9 +111,7 @@ namespace
         // simple moving out of a share group will not trigger a deletion in the
         // target - a more elaborate mechanism may need the use of another custom
         // attribute to share unshared entries from the target db
-        for (const auto& object : sourceDb->deletedObjects()) {
-            targetDb->addDeletedObject(object);
-        }
+        targetDb->addDeletedObjects(sourceDb->deletedObjects());
         for (auto* targetEntry : targetRoot->entriesRecursive(false)) {
             if (targetEntry->hasReferences()) {
                 resolveReferenceAttributes(targetEntry, sourceDb);
@@ -157,11 +165,49 @@ namespace
     }
 } // namespace
 
-ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
-                                                 const KeeShareSettings::Reference& reference,
-                                                 const Group* group)
+/**
+ * Extract a share into a standalone database ready to be written.
+ *
+ * @param resolvedPath path of the container file
+ * @param reference share settings of the group
+ * @param group root group of the share
+ * @param keySource database whose derived key is reused, it must have been
+ *        keyed with the password of the reference. Without one, the key is
+ *        derived when writing.
+ * @return container to pass to write()
+ */
+ShareExport::Container ShareExport::prepare(const QString& resolvedPath,
+                                            const KeeShareSettings::Reference& reference,
+                                            const Group* group,
+                                            const Database* keySource)
+{
+    Container container;
+    container.resolvedPath = resolvedPath;
+    container.reference = reference;
+    container.database.reset(extractIntoDatabase(reference, group, keySource));
+    if (resolvedPath.endsWith(".kdbx.share")) {
+        // Get Own Certificate for signing
+        container.own = KeeShare::own();
+        Q_ASSERT(!container.own.isNull());
+    }
+    return container;
+}
+
+/**
+ * Write a prepared container to its file. The container database is not
+ * shared with the GUI, so this is safe to call from a worker thread.
+ *
+ * @param container container returned by prepare()
+ * @return export result
+ */
+ShareObserver::Result ShareExport::write(const Container& container)
 {
-    QScopedPointer<Database> targetDb(extractIntoDatabase(reference, group));
+    const auto& resolvedPath = container.resolvedPath;
+    const auto& reference = container.reference;
+    auto* targetDb = container.database.data();
+
+    KeePass2Writer writer;
+    writer.setReuseTransformedKey(true);
     if (resolvedPath.endsWith(".kdbx.share")) {
         // Write database to memory and sign it
         QByteArray dbData, signatureData;
@@ -170,22 +216,17 @@ ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
         buffer.setBuffer(&dbData);
         buffer.open(QIODevice::WriteOnly);
 
-        KeePass2Writer writer;
-        if (!writer.writeDatabase(&buffer, targetDb.data())) {
+        if (!writer.writeDatabase(&buffer, targetDb)) {
             qWarning("Serializing export database failed: %s.", writer.errorString().toLatin1().data());
             return {reference.path, ShareObserver::Result::Error, writer.errorString()};
         }
 
         buffer.close();
 
-        // Get Own Certificate for signing
-        const auto own = KeeShare::own();
-        Q_ASSERT(!own.isNull());
-
         // Sign the database data
         KeeShareSettings::Sign sign;
-        sign.certificate = own.certificate;
-        signData(dbData, own.key, sign.signature);
+        sign.certificate = container.own.certificate;
+        signData(dbData, container.own.key, sign.signature);
 
         signatureData = KeeShareSettings::Sign::serialize(sign).toLatin1();
 
@@ -199,12 +240,27 @@ ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
 
         zipClose(zf, nullptr);
     } else {
-        QString error;
-        if (!targetDb->saveAs(resolvedPath, Database::Atomic, {}, &error)) {
-            qWarning("Exporting database failed: %s.", error.toLatin1().data());
-            return {resolvedPath, ShareObserver::Result::Error, error};
+        QSaveFile saveFile(resolvedPath);
+        if (!saveFile.open(QIODevice::WriteOnly)) {
+            qWarning("Exporting database failed: %s.", saveFile.errorString().toLatin1().data());
+            return {resolvedPath, ShareObserver::Result::Error, saveFile.errorString()};
+        }
+        if (!writer.writeDatabase(&saveFile, targetDb)) {
+            qWarning("Exporting database failed: %s.", writer.errorString().toLatin1().data());
+            return {resolvedPath, ShareObserver::Result::Error, writer.errorString()};
+        }
+        if (!saveFile.commit()) {
+            qWarning("Exporting database failed: %s.", saveFile.errorString().toLatin1().data());
+            return {resolvedPath, ShareObserver::Result::Error, saveFile.errorString()};
         }
     }
 
     return {resolvedPath};
 }
+
+ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
+                                                 const KeeShareSettings::Reference& reference,
+                                                 const Group* group)
+{
+    return write(prepare(resolvedPath, reference, group));
+}
@@ -27,6 +27,22 @@ class ShareExport
 {
     Q_DECLARE_TR_FUNCTIONS(ShareExport)
 public:
+    /**
+     * Snapshot of a share taken on the GUI thread, written by write() on any thread.
+     */
+    struct Container
+    {
+        QString resolvedPath;
+        KeeShareSettings::Reference reference;
+        QSharedPointer<Database> database;
+        KeeShareSettings::Own own;
+    };
+
+    static Container prepare(const QString& resolvedPath,
+                             const KeeShareSettings::Reference& reference,
+                             const Group* group,
+                             const Database* keySource = nullptr);
+    static ShareObserver::Result write(const Container& container);
     static ShareObserver::Result
     intoContainer(const QString& resolvedPath, const KeeShareSettings::Reference& reference, const Group* group);
 
@@ -20,47 +20,134 @@
 #include "keeshare/KeeShare.h"
 #include "keys/PasswordKey.h"
 
-#include <QBuffer>
+#include <QFile>
 #include <minizip/unzip.h>
 
 namespace
 {
-    QByteArray readZipFile(void* uf)
+    /**
+     * Read-only device over the current file of an open zip archive, decompressing
+     * on demand. Seeking backwards reopens the file and inflates up to the target.
+     */
+    class ZipFileDevice : public QIODevice
     {
-        QByteArray data;
-        int bytes, bytesRead = 0;
-        unzOpenCurrentFile(uf);
-        do {
-            data.resize(data.size() + 8192);
-            bytes = unzReadCurrentFile(uf, data.data() + bytesRead, 8192);
-            if (bytes > 0) {
-                bytesRead += bytes;
+    public:
+        ZipFileDevice(void* uf, qint64 size)
+            : m_uf(uf)
+            , m_size(size)
+        {
+        }
+
+        ~ZipFileDevice() override
+        {
+            close();
+        }
+
+        bool open(OpenMode mode) override
+        {
+            if (mode != ReadOnly || unzOpenCurrentFile(m_uf) != UNZ_OK) {
+                return false;
             }
-        } while (bytes > 0);
-        unzCloseCurrentFile(uf);
-        data.truncate(bytesRead);
-        return data;
-    }
+            m_pos = 0;
+            return QIODevice::open(mode | Unbuffered);
+        }
+
+        void close() override
+        {
+            if (isOpen()) {
+                unzCloseCurrentFile(m_uf);
+                QIODevice::close();
+            }
+        }
+
+        qint64 size() const override
+        {
+            return m_size;
+        }
+
+        bool seek(qint64 pos) override
+        {
+            if (!isOpen() || pos < 0 || pos > m_size) {
+                return false;
+            }
+            if (pos < m_pos) {
+                unzCloseCurrentFile(m_uf);
+                if (unzOpenCurrentFile(m_uf) != UNZ_OK) {
+                    return false;
+                }
+                m_pos = 0;
+            }
+            char buffer[8192];
+            while (m_pos < pos) {
+                if (readData(buffer, qMin<qint64>(pos - m_pos, sizeof(buffer))) <= 0) {
+                    return false;
+                }
+            }
+            return QIODevice::seek(pos);
+        }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override
+        {
+            int bytes = unzReadCurrentFile(m_uf, data, static_cast<unsigned>(qMin<qint64>(maxSize, 1 << 30)));
+            if (bytes < 0) {
+                setErrorString(ShareImport::tr("Could not read the share container."));
+                return -1;
+            }
+            m_pos += bytes;
+            return bytes;
+        }
+
+        qint64 writeData(const char* data, qint64 maxSize) override
+        {
+            Q_UNUSED(data);
+            Q_UNUSED(maxSize);
+            return -1;
+        }
+
+    private:
+        void* m_uf;
+        qint64 m_size;
+        qint64 m_pos = 0;
+    };
 } // namespace
 
 ShareObserver::Result ShareImport::containerInto(const QString& resolvedPath,
                                                  const KeeShareSettings::Reference& reference,
                                                  Group* targetGroup)
 {
-    QByteArray dbData;
+    KeePass2Reader reader;
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
+    auto sourceDb = QSharedPointer<Database>::create();
+    sourceDb->setEmitModified(false);
 
+    // Stream the database straight from the container, it is never held in memory as a whole
+    bool ok = false;
     auto uf = unzOpen64(resolvedPath.toLatin1().constData());
     if (uf) {
-        // Open zip share, extract database portion, ignore signature file
+        // Open zip share, read database portion, ignore signature file
         char zipFileName[256];
+        unz_file_info64 fileInfo;
+        bool found = false;
         auto err = unzGoToFirstFile(uf);
         while (err == UNZ_OK) {
-            unzGetCurrentFileInfo64(uf, nullptr, zipFileName, sizeof(zipFileName), nullptr, 0, nullptr, 0);
+            unzGetCurrentFileInfo64(uf, &fileInfo, zipFileName, sizeof(zipFileName), nullptr, 0, nullptr, 0);
             if (QString(zipFileName).compare(KeeShare::containerFileName()) == 0) {
-                dbData = readZipFile(uf);
+                found = true;
+                break;
             }
             err = unzGoToNextFile(uf);
         }
+        ZipFileDevice device(uf, found ? static_cast<qint64>(fileInfo.uncompressed_size) : 0);
+        if (!found || !device.open(QIODevice::ReadOnly)) {
+            unzClose(uf);
+            qCritical("Unable to read database from share container %s.", qPrintable(reference.path));
+            return {
+                reference.path, ShareObserver::Result::Error, ShareImport::tr("Could not read the share container.")};
+        }
+        ok = reader.readDatabase(&device, key, sourceDb.data());
+        device.close();
         unzClose(uf);
     } else {
         // Open KDBX file directly
@@ -69,19 +156,10 @@ ShareObserver::Result ShareImport::containerInto(const QString& resolvedPath,
             qCritical("Unable to open file %s.", qPrintable(reference.path));
             return {reference.path, ShareObserver::Result::Error, file.errorString()};
         }
-        dbData = file.readAll();
-        file.close();
+        ok = reader.readDatabase(&file, key, sourceDb.data());
     }
 
-    QBuffer buffer(&dbData);
-    buffer.open(QIODevice::ReadOnly);
-
-    KeePass2Reader reader;
-    auto key = QSharedPointer<CompositeKey>::create();
-    key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
-    auto sourceDb = QSharedPointer<Database>::create();
-    sourceDb->setEmitModified(false);
-    if (!reader.readDatabase(&buffer, key, sourceDb.data())) {
+    if (!ok) {
         qCritical("Error while parsing the database: %s", qPrintable(reader.errorString()));
         return {reference.path, ShareObserver::Result::Error, reader.errorString()};
     }
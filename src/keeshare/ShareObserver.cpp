@@ -16,6 +16,7 @@
  */
 
 #include "ShareObserver.h"
+#include "core/AsyncTask.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
 #include "keeshare/KeeShare.h"
@@ -49,6 +50,15 @@ ShareObserver::ShareObserver(QSharedPointer<Database> db, QObject* parent)
     connect(m_db.data(), &Database::modified, this, &ShareObserver::handleDatabaseChanged);
     connect(m_db.data(), &Database::databaseSaved, this, &ShareObserver::handleDatabaseSaved);
 
+    // Track which exported shares changed since their last export
+    connect(m_db.data(), &Database::groupDataChanged, this, &ShareObserver::markExportDirty);
+    connect(m_db.data(), &Database::groupAboutToAdd, this, &ShareObserver::handleGroupAboutToAdd);
+    connect(m_db.data(), &Database::groupAboutToRemove, this, &ShareObserver::markExportDirty);
+    connect(m_db.data(), &Database::groupAboutToMove, this, [this](Group* group, Group* toGroup) {
+        markExportDirty(group);
+        markExportDirty(toGroup);
+    });
+
     handleDatabaseChanged();
 }
 
@@ -62,10 +72,18 @@ void ShareObserver::deinitialize()
     m_groupToReference.clear();
     m_shareToGroup.clear();
     m_fileWatchers.clear();
+    m_dirtyExports.clear();
+    m_exportKeys.clear();
 }
 
 void ShareObserver::reinitialize()
 {
+    if (m_watchedRoot != m_db->rootGroup()) {
+        // Initial call or the root group was replaced
+        m_watchedRoot = m_db->rootGroup();
+        handleGroupAboutToAdd(m_watchedRoot);
+    }
+
     QList<QPair<QPointer<Group>, KeeShareSettings::Reference>> shares;
     for (Group* group : m_db->rootGroup()->groupsRecursive(true)) {
         auto oldReference = m_groupToReference.value(group);
@@ -84,6 +102,9 @@ void ShareObserver::reinitialize()
             const auto newResolvedPath = resolvePath(newReference.path, m_db);
             m_shareToGroup[newResolvedPath] = group;
         }
+        if (newReference.isExporting()) {
+            m_dirtyExports.insert(group->uuid());
+        }
 
         shares.append({group, newReference});
     }
@@ -211,6 +232,61 @@ void ShareObserver::handleFileUpdated(const QString& path)
     }
 }
 
+void ShareObserver::handleGroupAboutToAdd(Group* group)
+{
+    for (auto* child : group->groupsRecursive(true)) {
+        watchGroup(child);
+    }
+    markExportDirty(group);
+}
+
+void ShareObserver::handleEntryAdded(Entry* entry)
+{
+    connect(entry, &Entry::modified, this, &ShareObserver::handleEntryModified, Qt::UniqueConnection);
+    markExportDirty(entry->group());
+}
+
+void ShareObserver::handleEntryAboutToRemove(Entry* entry)
+{
+    Q_UNUSED(entry);
+    // The entry may be in destruction, use the group it is removed from
+    markExportDirty(qobject_cast<Group*>(sender()));
+}
+
+void ShareObserver::handleEntryModified()
+{
+    auto* entry = qobject_cast<Entry*>(sender());
+    if (entry) {
+        markExportDirty(entry->group());
+    }
+}
+
+void ShareObserver::watchGroup(Group* group)
+{
+    connect(group, &Group::entryAdded, this, &ShareObserver::handleEntryAdded, Qt::UniqueConnection);
+    connect(group, &Group::entryAboutToRemove, this, &ShareObserver::handleEntryAboutToRemove, Qt::UniqueConnection);
+    for (auto* entry : group->entries()) {
+        connect(entry, &Entry::modified, this, &ShareObserver::handleEntryModified, Qt::UniqueConnection);
+    }
+}
+
+/**
+ * Mark every exported share containing the group as changed.
+ *
+ * Deletions outside of a share are not tracked, their deleted object records
+ * reach the share with its next export.
+ *
+ * @param group changed group
+ */
+void ShareObserver::markExportDirty(Group* group)
+{
+    for (; group; group = group->parentGroup()) {
+        if (m_groupToReference.value(group).isExporting()) {
+            m_dirtyExports.insert(group->uuid());
+        }
+    }
+}
+
 ShareObserver::Result ShareObserver::importShare(const QString& path)
 {
     if (!KeeShare::active().in) {
@@ -278,21 +354,63 @@ QList<ShareObserver::Result> ShareObserver::exportShares()
         return results;
     }
 
+    QList<ShareExport::Container> containers;
+    QList<QUuid> containerGroups;
     for (auto it = references.cbegin(); it != references.cend(); ++it) {
         auto reference = it.value().first();
         const QString resolvedPath = resolvePath(reference.config.path, m_db);
-        auto watcher = m_fileWatchers.value(resolvedPath);
+        const auto uuid = reference.group->uuid();
+        if (!m_dirtyExports.contains(uuid) && QFileInfo::exists(resolvedPath)) {
+            // Share is unchanged since its last export
+            continue;
+        }
+        m_dirtyExports.remove(uuid);
+
+        // Reuse the derived key of the last export as long as the password did not change
+        const auto exportKey = m_exportKeys.value(uuid);
+        const auto* keySource = exportKey.first == reference.config.password ? exportKey.second.data() : nullptr;
+        // TODO: save new path into group settings if not saving to signed container anymore
+        containers << ShareExport::prepare(resolvedPath, reference.config, reference.group, keySource);
+        containerGroups << uuid;
+    }
+    if (containers.isEmpty()) {
+        return results;
+    }
+
+    for (const auto& container : asConst(containers)) {
+        auto watcher = m_fileWatchers.value(container.resolvedPath);
         if (watcher) {
             watcher->stop();
         }
+    }
 
-        // TODO: save new path into group settings if not saving to signed container anymore
-        results << ShareExport::intoContainer(resolvedPath, reference.config, reference.group);
+    // Key derivation and encryption dominate, write the containers in parallel
+    // The observer may be deleted while waiting, e.g. when the database is closed meanwhile
+    QPointer<ShareObserver> guard(this);
+    const auto written = AsyncTask::runAndWaitForFuture(
+        [&] { return QtConcurrent::blockingMapped<QList<Result>>(containers, &ShareExport::write); });
+    if (!guard) {
+        return written;
+    }
+
+    for (int i = 0; i < containers.size(); ++i) {
+        const auto& container = containers.at(i);
+        if (written.at(i).isError()) {
+            // Try again on the next save
+            m_dirtyExports.insert(containerGroups.at(i));
+        } else {
+            auto keyDb = QSharedPointer<Database>::create();
+            keyDb->setEmitModified(false);
+            keyDb->adoptKey(container.database.data());
+            m_exportKeys.insert(containerGroups.at(i), {container.reference.password, keyDb});
+        }
 
+        auto watcher = m_fileWatchers.value(container.resolvedPath);
         if (watcher) {
-            watcher->start(resolvedPath, FileWatchPeriod, FileWatchSize);
+            watcher->start(container.resolvedPath, FileWatchPeriod, FileWatchSize);
         }
     }
+    results << written;
     return results;
 }
 
@@ -301,11 +419,26 @@ void ShareObserver::handleDatabaseSaved()
     if (!KeeShare::active().out) {
         return;
     }
+    if (m_inExport) {
+        // Saved again while exporting, export those changes once the current export is done
+        m_exportPending = true;
+        return;
+    }
     QStringList error;
     QStringList warning;
     QStringList success;
 
-    const auto results = exportShares();
+    QList<Result> results;
+    QPointer<ShareObserver> guard(this);
+    m_inExport = true;
+    do {
+        m_exportPending = false;
+        results << exportShares();
+        if (!guard) {
+            return;
+        }
+    } while (m_exportPending);
+    m_inExport = false;
     for (const Result& result : results) {
         if (!result.isValid()) {
             Q_ASSERT(result.isValid());
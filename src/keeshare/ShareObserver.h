@@ -20,11 +20,14 @@
 
 #include <QMap>
 #include <QObject>
+#include <QSet>
+#include <QUuid>
 
 #include "gui/MessageWidget.h"
 #include "keeshare/KeeShareSettings.h"
 
 class FileWatcher;
+class Entry;
 class Group;
 class Database;
 
@@ -67,11 +70,18 @@ private slots:
     void handleDatabaseChanged();
     void handleDatabaseSaved();
     void handleFileUpdated(const QString& path);
+    void handleGroupAboutToAdd(Group* group);
+    void handleEntryAdded(Entry* entry);
+    void handleEntryAboutToRemove(Entry* entry);
+    void handleEntryModified();
 
 private:
     Result importShare(const QString& path);
     QList<Result> exportShares();
 
+    void watchGroup(Group* group);
+    void markExportDirty(Group* group);
+
     void deinitialize();
     void reinitialize();
     void notifyAbout(const QStringList& success, const QStringList& warning, const QStringList& error);
@@ -81,7 +91,14 @@ private:
     QMap<QPointer<Group>, KeeShareSettings::Reference> m_groupToReference;
     QMap<QString, QPointer<Group>> m_shareToGroup;
     QMap<QString, QSharedPointer<FileWatcher>> m_fileWatchers;
+    // Exporting groups changed since their last export, by group uuid
+    QSet<QUuid> m_dirtyExports;
+    // Password and database holding the derived key of the last export of each group
+    QHash<QUuid, QPair<QString, QSharedPointer<Database>>> m_exportKeys;
+    QPointer<Group> m_watchedRoot;
     bool m_inFileUpdate = false;
+    bool m_inExport = false;
+    bool m_exportPending = false;
 };
 
 #endif // KEEPASSXC_SHAREOBSERVER_H
@@ -32,6 +32,7 @@ QUuid CompositeKey::UUID("76a7ae25-a542-4add-9849-7c06be945b94");
 
 CompositeKey::CompositeKey()
     : Key(UUID)
+    , m_transformedKeys(MaxTransformedKeys)
 {
 }
 
@@ -44,6 +45,7 @@ void CompositeKey::clear()
 {
     m_keys.clear();
     m_challengeResponseKeys.clear();
+    clearTransformedKeys();
 }
 
 bool CompositeKey::isEmpty() const
@@ -114,21 +116,57 @@ QByteArray CompositeKey::rawKey(const QByteArray* transformSeed, bool* ok, QStri
  * challenge response key components after key transformation.
  * KDBX4+ KDFs transform the whole key including challenge-response components.
  *
+ * The result is remembered for the KDF parameters until the key is changed,
+ * transforming again with the same KDF and seed returns it without running the KDF.
+ *
  * @param kdf key derivation function
  * @param result transformed key hash
  * @return true on success
  */
 bool CompositeKey::transform(const Kdf& kdf, QByteArray& result, QString* error) const
 {
+    // The parameters are not secret, they are stored in the database header as they are.
+    // Do not add a hash of the raw key here, that would allow checking passwords without the KDF.
+    QByteArray parameters;
+    {
+        QDataStream stream(&parameters, QIODevice::WriteOnly);
+        stream << kdf.uuid() << kdf.clone()->writeParameters();
+    }
+
+    {
+        QMutexLocker locker(&m_transformedKeysMutex);
+        auto transformedKey = m_transformedKeys.object(parameters);
+        if (transformedKey) {
+            result = transformedKey->rawKey();
+            return true;
+        }
+    }
+
+    bool ok = false;
     if (kdf.uuid() == KeePass2::KDF_AES_KDBX3) {
         // legacy KDBX3 AES-KDF, challenge response is added later to the hash
-        return kdf.transform(rawKey(), result);
+        ok = kdf.transform(rawKey(), result);
+    } else {
+        QByteArray seed = kdf.seed();
+        Q_ASSERT(!seed.isEmpty());
+        bool challengeOk = false;
+        ok = kdf.transform(rawKey(&seed, &challengeOk, error), result) && challengeOk;
+    }
+    if (!ok) {
+        return false;
     }
 
-    QByteArray seed = kdf.seed();
-    Q_ASSERT(!seed.isEmpty());
-    bool ok = false;
-    return kdf.transform(rawKey(&seed, &ok, error), result) && ok;
+    auto transformedKey = new PasswordKey();
+    transformedKey->setRawKey(result);
+    QMutexLocker locker(&m_transformedKeysMutex);
+    m_transformedKeys.insert(parameters, transformedKey);
+    return true;
+}
+
+void CompositeKey::clearTransformedKeys()
+{
+    QMutexLocker locker(&m_transformedKeysMutex);
+    m_transformedKeys.clear();
 }
 
 bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result, QString* error) const
@@ -167,6 +205,7 @@ bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result, QString
 void CompositeKey::addKey(const QSharedPointer<Key>& key)
 {
     m_keys.append(key);
+    clearTransformedKeys();
 }
 
 /**
@@ -217,6 +256,7 @@ const QList<QSharedPointer<Key>>& CompositeKey::keys() const
 void CompositeKey::addChallengeResponseKey(const QSharedPointer<ChallengeResponseKey>& key)
 {
     m_challengeResponseKeys.append(key);
+    clearTransformedKeys();
 }
 
 /**
@@ -257,6 +297,7 @@ void CompositeKey::deserialize(const QByteArray& data)
     // Clear existing keys
     m_keys.clear();
     m_challengeResponseKeys.clear();
+    clearTransformedKeys();
 
     while (!stream.atEnd()) {
         // Read the UUID first to construct the key
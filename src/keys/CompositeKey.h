@@ -19,12 +19,15 @@
 #ifndef KEEPASSX_COMPOSITEKEY_H
 #define KEEPASSX_COMPOSITEKEY_H
 
+#include <QCache>
+#include <QMutex>
 #include <QSharedPointer>
 
 #include "keys/Key.h"
 
 class Kdf;
 class ChallengeResponseKey;
+class PasswordKey;
 
 class CompositeKey : public Key
 {
@@ -55,9 +58,16 @@ public:
 
 private:
     QByteArray rawKey(const QByteArray* transformSeed, bool* ok = nullptr, QString* error = nullptr) const;
+    void clearTransformedKeys();
 
     QList<QSharedPointer<Key>> m_keys;
     QList<QSharedPointer<ChallengeResponseKey>> m_challengeResponseKeys;
+
+    // Transformed keys by KDF parameters (including the seed), so reopening a database
+    // with an unchanged KDF header does not run the key derivation again
+    static constexpr int MaxTransformedKeys = 4;
+    mutable QCache<QByteArray, PasswordKey> m_transformedKeys;
+    mutable QMutex m_transformedKeysMutex;
 };
 
 #endif // KEEPASSX_COMPOSITEKEY_H
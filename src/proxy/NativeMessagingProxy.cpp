@@ -22,7 +22,7 @@
 #include <QFuture>
 #include <QtConcurrent/qtconcurrentrun.h>
 
-#include <iostream>
+#include <cstdio>
 
 #ifdef Q_OS_WIN
 #include <fcntl.h>
@@ -32,6 +32,11 @@
 #include <sys/socket.h>
 #endif
 
+namespace
+{
+    constexpr int HandshakeTimeout = 500;
+} // namespace
+
 NativeMessagingProxy::NativeMessagingProxy()
     : QObject()
 {
@@ -58,33 +63,33 @@ void NativeMessagingProxy::setupStandardInput()
 #endif
 
     QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
-
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
-
-                if (msg.length() > 0) {
-                    emit stdinMessage(msg);
-                }
+        // Block on the browser until a message arrives, each one is prefixed with its length in native byte order
+        quint32 length = 0;
+        while (std::fread(&length, sizeof(length), 1, stdin) == 1) {
+            if (length > BrowserShared::NATIVEMSG_MAX_FRAMED_LENGTH) {
+                break;
+            }
+            QByteArray msg(static_cast<int>(length), '\0');
+            if (std::fread(msg.data(), 1, length, stdin) != length) {
+                break;
+            }
+            if (!msg.isEmpty()) {
+                emit stdinMessage(msg);
             }
-            QThread::msleep(100);
         }
         QCoreApplication::quit();
     });
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
+    if (!m_handshakeDone) {
+        m_pendingMessages.append(msg);
+        return;
+    }
+
     if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
+        m_localSocket->write(m_hostFraming ? BrowserShared::frameMessage(msg) : msg);
         m_localSocket->flush();
     }
 }
@@ -102,21 +107,63 @@ void NativeMessagingProxy::setupLocalSocket()
 
     connect(m_localSocket.data(), SIGNAL(readyRead()), this, SLOT(transferSocketMessage()));
     connect(m_localSocket.data(), SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
+
+    // An empty framed message asks the host to switch to framed messages. It is acknowledged
+    // with an empty framed message, older hosts ignore it and keep receiving bare JSON.
+    // Only those never answer, so the timeout does not delay messages to current hosts.
+    m_handshakeTimer.setSingleShot(true);
+    connect(&m_handshakeTimer, &QTimer::timeout, this, [this] { finishHandshake(false); });
+    m_localSocket->write(BrowserShared::frameMessage({}));
+    m_localSocket->flush();
+    m_handshakeTimer.start(HandshakeTimeout);
+}
+
+void NativeMessagingProxy::finishHandshake(bool hostFraming)
+{
+    if (m_handshakeDone) {
+        return;
+    }
+    m_handshakeTimer.stop();
+    m_hostFraming = hostFraming;
+    m_handshakeDone = true;
+
+    const auto pending = m_pendingMessages;
+    m_pendingMessages.clear();
+    for (const auto& msg : pending) {
+        transferStdinMessage(msg);
+    }
 }
 
 void NativeMessagingProxy::transferSocketMessage()
 {
-    auto msg = m_localSocket->readAll();
-    if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
-        std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
-
-        // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+    m_socketBuffer.append(m_localSocket->readAll());
+    while (m_socketBuffer.size() >= BrowserShared::NATIVEMSG_HEADER_LENGTH) {
+        QByteArray msg;
+        if (!BrowserShared::isFramedMessage(m_socketBuffer)) {
+            // Bare JSON only comes from older hosts
+            msg = m_socketBuffer;
+            m_socketBuffer.clear();
+            finishHandshake(false);
+        } else if (BrowserShared::takeFramedMessage(m_socketBuffer, msg)) {
+            finishHandshake(true);
+        } else {
+            break;
+        }
+
+        if (!msg.isEmpty()) {
+            writeStdoutMessage(msg);
+        }
     }
 }
 
+void NativeMessagingProxy::writeStdoutMessage(const QByteArray& msg)
+{
+    quint32 length = msg.size();
+    std::fwrite(&length, sizeof(length), 1, stdout);
+    std::fwrite(msg.constData(), 1, msg.size(), stdout);
+    std::fflush(stdout);
+}
+
 void NativeMessagingProxy::socketDisconnected()
 {
     // Shutdown the proxy when disconnected from the application
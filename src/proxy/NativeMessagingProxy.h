@@ -19,6 +19,7 @@
 #define NATIVEMESSAGINGPROXY_H
 
 #include <QLocalSocket>
+#include <QTimer>
 
 class QWinEventNotifier;
 class QSocketNotifier;
@@ -31,19 +32,28 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(QByteArray msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
     void socketDisconnected();
 
 private:
     void setupStandardInput();
     void setupLocalSocket();
+    void writeStdoutMessage(const QByteArray& msg);
+    void finishHandshake(bool hostFraming);
 
 private:
     QScopedPointer<QLocalSocket> m_localSocket;
+    QByteArray m_socketBuffer;
+    // Set once the host acknowledged framed messages, older hosts expect bare JSON
+    bool m_hostFraming = false;
+    // Browser messages are held back until the host answered the handshake or timed out
+    bool m_handshakeDone = false;
+    QList<QByteArray> m_pendingMessages;
+    QTimer m_handshakeTimer;
 
     Q_DISABLE_COPY(NativeMessagingProxy)
 };
@@ -17,6 +17,8 @@
 
 #include "HmacBlockStream.h"
 
+#include <QtConcurrent>
+
 #include "core/Endian.h"
 #include "crypto/CryptoHash.h"
 
@@ -26,6 +28,7 @@ HmacBlockStream::HmacBlockStream(QIODevice* baseDevice, QByteArray key)
     : LayeredStream(baseDevice)
     , m_blockSize(1024 * 1024)
     , m_key(std::move(key))
+    , m_maxPendingBlocks(0)
 {
     init();
 }
@@ -34,6 +37,7 @@ HmacBlockStream::HmacBlockStream(QIODevice* baseDevice, QByteArray key, qint32 b
     : LayeredStream(baseDevice)
     , m_blockSize(blockSize)
     , m_key(std::move(key))
+    , m_maxPendingBlocks(0)
 {
     init();
 }
@@ -48,6 +52,7 @@ void HmacBlockStream::init()
     m_buffer.clear();
     m_bufferPos = 0;
     m_blockIndex = 0;
+    m_pendingBlocks.clear();
     m_eof = false;
     m_error = false;
 }
@@ -88,6 +93,17 @@ void HmacBlockStream::close()
     LayeredStream::close();
 }
 
+/**
+ * Compute the HMAC of up to maxPendingBlocks written blocks concurrently.
+ * Blocks are still written to the base device in order, so the output is
+ * identical to the default of computing each HMAC inline (0).
+ */
+void HmacBlockStream::setMaxPendingBlocks(int maxPendingBlocks)
+{
+    Q_ASSERT(maxPendingBlocks >= 0);
+    m_maxPendingBlocks = maxPendingBlocks;
+}
+
 qint64 HmacBlockStream::readData(char* data, qint64 maxSize)
 {
     if (m_error) {
@@ -153,13 +169,7 @@ bool HmacBlockStream::readHashedBlock()
         return false;
     }
 
-    CryptoHash hasher(CryptoHash::Sha256, true);
-    hasher.setKey(getCurrentHmacKey());
-    hasher.addData(Endian::sizedIntToBytes<quint64>(m_blockIndex, ByteOrder));
-    hasher.addData(blockSizeBytes);
-    hasher.addData(m_buffer);
-
-    if (hmac != hasher.result()) {
+    if (hmac != getBlockHmac(m_blockIndex, m_key, m_buffer)) {
         m_error = true;
         setErrorString("Mismatch between hash and data.");
         return false;
@@ -208,41 +218,63 @@ qint64 HmacBlockStream::writeData(const char* data, qint64 maxSize)
 
 bool HmacBlockStream::writeHashedBlock()
 {
-    CryptoHash hasher(CryptoHash::Sha256, true);
-    hasher.setKey(getCurrentHmacKey());
-    hasher.addData(Endian::sizedIntToBytes<quint64>(m_blockIndex, ByteOrder));
-    hasher.addData(Endian::sizedIntToBytes<qint32>(m_buffer.size(), ByteOrder));
-    hasher.addData(m_buffer);
-    QByteArray hash = hasher.result();
-
-    if (m_baseDevice->write(hash) != hash.size()) {
-        m_error = true;
-        setErrorString(m_baseDevice->errorString());
+    if (m_maxPendingBlocks > 0 && !m_buffer.isEmpty()) {
+        m_pendingBlocks.enqueue(
+            {QtConcurrent::run(&HmacBlockStream::getBlockHmac, m_blockIndex, m_key, m_buffer), m_buffer});
+        m_buffer.clear();
+        ++m_blockIndex;
+        return m_pendingBlocks.size() <= m_maxPendingBlocks || writePendingBlock();
+    }
+
+    if (!writePendingBlocks() || !writeBlock(getBlockHmac(m_blockIndex, m_key, m_buffer), m_buffer)) {
         return false;
     }
+    m_buffer.clear();
+    ++m_blockIndex;
+    return true;
+}
 
-    if (!Endian::writeSizedInt<qint32>(m_buffer.size(), m_baseDevice, ByteOrder)) {
-        m_error = true;
-        setErrorString(m_baseDevice->errorString());
+bool HmacBlockStream::writePendingBlock()
+{
+    auto block = m_pendingBlocks.dequeue();
+    if (!writeBlock(block.hmac.result(), block.data)) {
+        m_pendingBlocks.clear();
         return false;
     }
+    return true;
+}
 
-    if (!m_buffer.isEmpty()) {
-        if (m_baseDevice->write(m_buffer) != m_buffer.size()) {
-            m_error = true;
-            setErrorString(m_baseDevice->errorString());
+bool HmacBlockStream::writePendingBlocks()
+{
+    while (!m_pendingBlocks.isEmpty()) {
+        if (!writePendingBlock()) {
             return false;
         }
-
-        m_buffer.clear();
     }
-    ++m_blockIndex;
     return true;
 }
 
-QByteArray HmacBlockStream::getCurrentHmacKey() const
+bool HmacBlockStream::writeBlock(const QByteArray& hmac, const QByteArray& data)
 {
-    return getHmacKey(m_blockIndex, m_key);
+    if (m_baseDevice->write(hmac) != hmac.size()) {
+        m_error = true;
+        setErrorString(m_baseDevice->errorString());
+        return false;
+    }
+
+    if (!Endian::writeSizedInt<qint32>(data.size(), m_baseDevice, ByteOrder)) {
+        m_error = true;
+        setErrorString(m_baseDevice->errorString());
+        return false;
+    }
+
+    if (!data.isEmpty() && m_baseDevice->write(data) != data.size()) {
+        m_error = true;
+        setErrorString(m_baseDevice->errorString());
+        return false;
+    }
+
+    return true;
 }
 
 QByteArray HmacBlockStream::getHmacKey(quint64 blockIndex, const QByteArray& key)
@@ -18,6 +18,8 @@
 #ifndef KEEPASSX_HMACBLOCKSTREAM_H
 #define KEEPASSX_HMACBLOCKSTREAM_H
 
+#include <QFuture>
+#include <QQueue>
 #include <QSysInfo>
 
 #include "streams/LayeredStream.h"
@@ -34,7 +36,10 @@ public:
     bool reset() override;
     void close() override;
 
+    void setMaxPendingBlocks(int maxPendingBlocks);
+
     static QByteArray getHmacKey(quint64 blockIndex, const QByteArray& key);
+    static QByteArray getBlockHmac(quint64 blockIndex, const QByteArray& key, const QByteArray& data);
 
     bool atEnd() const override;
 
@@ -46,7 +51,15 @@ private:
     void init();
     bool readHashedBlock();
     bool writeHashedBlock();
-    QByteArray getCurrentHmacKey() const;
+    bool writeBlock(const QByteArray& hmac, const QByteArray& data);
+    bool writePendingBlock();
+    bool writePendingBlocks();
+
+    struct PendingBlock
+    {
+        QFuture<QByteArray> hmac;
+        QByteArray data;
+    };
 
     static const QSysInfo::Endian ByteOrder;
     qint32 m_blockSize;
@@ -54,6 +67,8 @@ private:
     QByteArray m_key;
     int m_bufferPos;
     quint64 m_blockIndex;
+    int m_maxPendingBlocks;
+    QQueue<PendingBlock> m_pendingBlocks;
     bool m_eof;
     bool m_error;
 };
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReadAheadStream.h"
+
+#include <QThread>
+
+#include <functional>
+
+namespace
+{
+    class ReadAheadThread : public QThread
+    {
+    public:
+        explicit ReadAheadThread(std::function<void()> function)
+            : m_function(std::move(function))
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            m_function();
+        }
+
+    private:
+        std::function<void()> m_function;
+    };
+} // namespace
+
+ReadAheadStream::ReadAheadStream(QIODevice* baseDevice, int chunkSize, int maxChunks)
+    : LayeredStream(baseDevice)
+    , m_chunkSize(chunkSize)
+    , m_maxChunks(maxChunks)
+    , m_finished(false)
+    , m_stopped(false)
+    , m_error(false)
+    , m_currentPos(0)
+    , m_eof(false)
+{
+    Q_ASSERT(chunkSize > 0 && maxChunks > 0);
+}
+
+ReadAheadStream::~ReadAheadStream()
+{
+    close();
+}
+
+bool ReadAheadStream::open(QIODevice::OpenMode mode)
+{
+    if (mode & QIODevice::WriteOnly) {
+        qWarning("ReadAheadStream::open: Writing is not supported.");
+        return false;
+    }
+
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_chunks.clear();
+    m_finished = false;
+    m_stopped = false;
+    m_error = false;
+    m_current.clear();
+    m_currentPos = 0;
+    m_eof = false;
+
+    m_thread.reset(new ReadAheadThread([this] { readAhead(); }));
+    m_thread->start();
+    return true;
+}
+
+void ReadAheadStream::close()
+{
+    stopReadAhead();
+    LayeredStream::close();
+}
+
+bool ReadAheadStream::atEnd() const
+{
+    return m_eof;
+}
+
+qint64 ReadAheadStream::readData(char* data, qint64 maxSize)
+{
+    qint64 bytesRead = 0;
+    while (bytesRead < maxSize) {
+        if (m_currentPos == m_current.size()) {
+            QMutexLocker locker(&m_mutex);
+            while (m_chunks.isEmpty() && !m_finished) {
+                m_chunkAvailable.wait(&m_mutex);
+            }
+
+            if (m_chunks.isEmpty()) {
+                if (m_error) {
+                    setErrorString(m_baseErrorString);
+                    return bytesRead > 0 ? bytesRead : -1;
+                }
+                m_eof = true;
+                return bytesRead;
+            }
+
+            m_current = m_chunks.dequeue();
+            m_currentPos = 0;
+            m_spaceAvailable.wakeOne();
+        }
+
+        const auto bytesToCopy = qMin(maxSize - bytesRead, static_cast<qint64>(m_current.size() - m_currentPos));
+        memcpy(data + bytesRead, m_current.constData() + m_currentPos, static_cast<size_t>(bytesToCopy));
+        bytesRead += bytesToCopy;
+        m_currentPos += bytesToCopy;
+    }
+
+    return bytesRead;
+}
+
+qint64 ReadAheadStream::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+/**
+ * Runs on the read ahead thread until the base device is exhausted,
+ * fails or the stream is closed.
+ */
+void ReadAheadStream::readAhead()
+{
+    while (true) {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_stopped) {
+                return;
+            }
+        }
+
+        QByteArray chunk(m_chunkSize, Qt::Uninitialized);
+        const qint64 bytesRead = m_baseDevice->read(chunk.data(), m_chunkSize);
+
+        QMutexLocker locker(&m_mutex);
+        if (bytesRead <= 0) {
+            if (bytesRead < 0) {
+                m_error = true;
+                m_baseErrorString = m_baseDevice->errorString();
+            }
+            m_finished = true;
+            m_chunkAvailable.wakeAll();
+            return;
+        }
+
+        while (m_chunks.size() >= m_maxChunks && !m_stopped) {
+            m_spaceAvailable.wait(&m_mutex);
+        }
+        if (m_stopped) {
+            return;
+        }
+
+        chunk.resize(static_cast<int>(bytesRead));
+        m_chunks.enqueue(chunk);
+        m_chunkAvailable.wakeOne();
+    }
+}
+
+void ReadAheadStream::stopReadAhead()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_chunks.clear();
+        m_spaceAvailable.wakeAll();
+    }
+    m_thread->wait();
+    m_thread.reset();
+}
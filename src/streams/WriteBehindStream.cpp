@@ -0,0 +1,212 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WriteBehindStream.h"
+
+#include <QThread>
+
+#include <functional>
+
+namespace
+{
+    class WriteBehindThread : public QThread
+    {
+    public:
+        explicit WriteBehindThread(std::function<void()> function)
+            : m_function(std::move(function))
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            m_function();
+        }
+
+    private:
+        std::function<void()> m_function;
+    };
+} // namespace
+
+WriteBehindStream::WriteBehindStream(QIODevice* baseDevice, int chunkSize, int maxChunks)
+    : LayeredStream(baseDevice)
+    , m_chunkSize(chunkSize)
+    , m_maxChunks(maxChunks)
+    , m_writing(false)
+    , m_stopped(false)
+    , m_error(false)
+{
+    Q_ASSERT(chunkSize > 0 && maxChunks > 0);
+}
+
+WriteBehindStream::~WriteBehindStream()
+{
+    close();
+}
+
+bool WriteBehindStream::open(QIODevice::OpenMode mode)
+{
+    if (mode & QIODevice::ReadOnly) {
+        qWarning("WriteBehindStream::open: Reading is not supported.");
+        return false;
+    }
+
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_chunks.clear();
+    m_writing = false;
+    m_stopped = false;
+    m_error = false;
+    m_current.clear();
+
+    m_thread.reset(new WriteBehindThread([this] { writeBehind(); }));
+    m_thread->start();
+    return true;
+}
+
+bool WriteBehindStream::reset()
+{
+    return flush();
+}
+
+void WriteBehindStream::close()
+{
+    if (m_thread) {
+        flush();
+        stopWriteBehind();
+    }
+    LayeredStream::close();
+}
+
+qint64 WriteBehindStream::readData(char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 WriteBehindStream::writeData(const char* data, qint64 maxSize)
+{
+    Q_ASSERT(maxSize >= 0);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_error) {
+            setErrorString(m_baseErrorString);
+            return -1;
+        }
+    }
+
+    qint64 bytesRemaining = maxSize;
+    qint64 offset = 0;
+    while (bytesRemaining > 0) {
+        const auto bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_chunkSize - m_current.size()));
+        m_current.append(data + offset, static_cast<int>(bytesToCopy));
+        offset += bytesToCopy;
+        bytesRemaining -= bytesToCopy;
+
+        if (m_current.size() == m_chunkSize && !enqueueCurrent()) {
+            return -1;
+        }
+    }
+
+    return maxSize;
+}
+
+/**
+ * Hand the current chunk to the write behind thread, waiting
+ * for space in the queue if necessary.
+ */
+bool WriteBehindStream::enqueueCurrent()
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_chunks.size() >= m_maxChunks && !m_error) {
+        m_chunkWritten.wait(&m_mutex);
+    }
+    if (m_error) {
+        setErrorString(m_baseErrorString);
+        return false;
+    }
+
+    m_chunks.enqueue(m_current);
+    m_current.clear();
+    m_chunkAvailable.wakeOne();
+    return true;
+}
+
+/**
+ * Wait until all data written so far has reached the base device.
+ */
+bool WriteBehindStream::flush()
+{
+    if (!m_current.isEmpty() && !enqueueCurrent()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    while ((!m_chunks.isEmpty() || m_writing) && !m_error) {
+        m_chunkWritten.wait(&m_mutex);
+    }
+    if (m_error) {
+        setErrorString(m_baseErrorString);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs on the write behind thread until the stream is closed.
+ */
+void WriteBehindStream::writeBehind()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (m_chunks.isEmpty() && !m_stopped) {
+            m_chunkAvailable.wait(&m_mutex);
+        }
+        if (m_stopped) {
+            return;
+        }
+
+        const auto chunk = m_chunks.dequeue();
+        m_writing = true;
+        locker.unlock();
+        const bool ok = m_baseDevice->write(chunk) == chunk.size();
+        locker.relock();
+        m_writing = false;
+
+        if (!ok) {
+            m_error = true;
+            m_baseErrorString = m_baseDevice->errorString();
+            m_chunks.clear();
+        }
+        m_chunkWritten.wakeAll();
+    }
+}
+
+void WriteBehindStream::stopWriteBehind()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_chunkAvailable.wakeAll();
+    }
+    m_thread->wait();
+    m_thread.reset();
+}
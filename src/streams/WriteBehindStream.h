@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_WRITEBEHINDSTREAM_H
+#define KEEPASSXC_WRITEBEHINDSTREAM_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QWaitCondition>
+
+#include "streams/LayeredStream.h"
+
+class QThread;
+
+/**
+ * Write-only stream that writes to its base device on a separate thread.
+ *
+ * The write counterpart of ReadAheadStream: written data is collected in
+ * chunks of chunkSize bytes and at most maxChunks chunks are queued for the
+ * base device. reset() and close() wait until everything has been written
+ * to the base device, after which the base device may be used again.
+ * Errors of the base device are reported by the next write or reset().
+ */
+class WriteBehindStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    explicit WriteBehindStream(QIODevice* baseDevice, int chunkSize = 1024 * 1024, int maxChunks = 4);
+    ~WriteBehindStream() override;
+
+    bool open(QIODevice::OpenMode mode) override;
+    bool reset() override;
+    void close() override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    void writeBehind();
+    bool enqueueCurrent();
+    bool flush();
+    void stopWriteBehind();
+
+    const int m_chunkSize;
+    const int m_maxChunks;
+    QScopedPointer<QThread> m_thread;
+
+    // Shared with the write behind thread
+    QMutex m_mutex;
+    QWaitCondition m_chunkAvailable;
+    QWaitCondition m_chunkWritten;
+    QQueue<QByteArray> m_chunks;
+    bool m_writing;
+    bool m_stopped;
+    bool m_error;
+    QString m_baseErrorString;
+
+    QByteArray m_current;
+};
+
+#endif // KEEPASSXC_WRITEBEHINDSTREAM_H
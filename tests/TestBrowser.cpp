@@ -736,3 +736,89 @@ void TestBrowser::testRestrictBrowserKey()
     QCOMPARE(sorted[2]->url(), QString("https://example.com/2"));
     QCOMPARE(sorted[3]->url(), QString("https://example.com/0"));
 }
+
+void TestBrowser::testSearchEntriesIndexUpdates()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+
+    QStringList urls = {"https://github.com/", "https://example.com", "https://www.keepassxc.org"};
+    auto entries = createEntries(urls, root);
+
+    auto result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    // Changing the URL moves the entry to another domain
+    entries[0]->setUrl("https://gitlab.com");
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 0);
+    result = m_browserService->searchEntries(db, "https://gitlab.com", "https://gitlab.com");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    // Additional URLs are indexed as well
+    entries[1]->attributes()->set(EntryAttributes::AdditionalUrlAttribute, "https://sub.gitlab.com");
+    result = m_browserService->searchEntries(db, "https://sub.gitlab.com", "https://sub.gitlab.com");
+    QCOMPARE(result.length(), 2);
+    QCOMPARE(result[0], entries[0]);
+    QCOMPARE(result[1], entries[1]);
+
+    // Entries added later and entries in new groups are found
+    auto* group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(root);
+    QStringList groupUrls = {"https://gitlab.com/login"};
+    auto groupEntries = createEntries(groupUrls, group);
+    result = m_browserService->searchEntries(db, "https://gitlab.com", "https://gitlab.com");
+    QCOMPARE(result.length(), 2);
+    QCOMPARE(result[0], entries[0]);
+    QCOMPARE(result[1], groupEntries[0]);
+
+    // Deleted and recycled entries are gone
+    delete entries[0];
+    db->recycleEntry(groupEntries[0]);
+    result = m_browserService->searchEntries(db, "https://gitlab.com", "https://gitlab.com");
+    QCOMPARE(result.length(), 0);
+
+    // The www subdomain is only omitted through the group option
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.length(), 0);
+    root->customData()->set(BrowserService::OPTION_OMIT_WWW, TRUE_STR);
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[2]);
+}
+
+void TestBrowser::benchmarkSearchEntries()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, entryCount);
+
+    auto db = QSharedPointer<Database>::create();
+    QStringList urls;
+    for (int i = 0; i < entryCount; ++i) {
+        urls << QString("https://login.domain%1.com/").arg(i);
+    }
+    createEntries(urls, db->rootGroup());
+
+    // Build the index outside of the measurement
+    const auto siteUrl = QString("https://login.domain%1.com").arg(entryCount / 2);
+    QCOMPARE(m_browserService->searchEntries(db, siteUrl, siteUrl).length(), 1);
+
+    QBENCHMARK {
+        m_browserService->searchEntries(db, siteUrl, siteUrl);
+    }
+}
+
+void TestBrowser::benchmarkSearchEntries_data()
+{
+    QTest::addColumn<int>("entryCount");
+    QTest::newRow("100 entries") << 100;
+    QTest::newRow("10000 entries") << 10000;
+}
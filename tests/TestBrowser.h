@@ -50,6 +50,9 @@ private slots:
     void testBestMatchingCredentials();
     void testBestMatchingWithAdditionalURLs();
     void testRestrictBrowserKey();
+    void testSearchEntriesIndexUpdates();
+    void benchmarkSearchEntries();
+    void benchmarkSearchEntries_data();
 
 private:
     QList<Entry*> createEntries(QStringList& urls, Group* root) const;
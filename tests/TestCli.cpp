@@ -43,6 +43,7 @@
 #include "cli/Export.h"
 #include "cli/Generate.h"
 #include "cli/Help.h"
+#include "cli/HibpIndex.h"
 #include "cli/Import.h"
 #include "cli/List.h"
 #include "cli/Merge.h"
@@ -237,6 +238,7 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("export"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
     QVERIFY(Commands::getCommand("import"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
@@ -269,6 +271,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("exit"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
     QVERIFY(Commands::getCommand("mkdir"));
@@ -450,6 +453,40 @@ void TestCli::testAnalyze()
     QCOMPARE(m_stderr->readAll(), QByteArray());
 }
 
+void TestCli::testHibpIndex()
+{
+    HibpIndex hibpIndexCmd;
+    QVERIFY(!hibpIndexCmd.name.isEmpty());
+    QVERIFY(hibpIndexCmd.getDescriptionLine().contains(hibpIndexCmd.name));
+
+    // The test data file is not ordered by hash
+    const QString hibpPath = QString(KEEPASSX_TEST_DATA_DIR).append("/hibp.txt");
+    TemporaryFile indexFile;
+    indexFile.open(QIODevice::WriteOnly);
+    indexFile.close();
+    execCmd(hibpIndexCmd, {"hibp-index", hibpPath, indexFile.fileName()});
+    QVERIFY(m_stderr->readAll().contains("not sorted"));
+
+    TemporaryFile sortedFile;
+    QVERIFY(sortedFile.open());
+    sortedFile.write("000000005AD76BD555C1D6D771DE417A4B87E4B4:4\r\n"
+                     "8BE3C943B1609FFFBFC51AAD666D0A04ADF83C9D:123\r\n");
+    sortedFile.close();
+
+    execCmd(hibpIndexCmd, {"hibp-index", "-b", "8", sortedFile.fileName(), indexFile.fileName()});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(m_stdout->readAll().contains("Successfully built HIBP index"));
+
+    Analyze analyzeCmd;
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--hibp", indexFile.fileName(), m_dbFile->fileName()});
+    auto output = m_stdout->readAll();
+    QVERIFY(output.contains("Sample Entry"));
+    QVERIFY(output.contains("123"));
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+}
+
 void TestCli::testAttachmentExport()
 {
     AttachmentExport attachmentExportCmd;
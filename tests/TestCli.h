@@ -67,6 +67,7 @@ private slots:
     void testKeyFileOption();
     void testNoPasswordOption();
     void testHelp();
+    void testHibpIndex();
     void testInteractiveCommands();
     void testList();
     void testMerge();
@@ -23,6 +23,7 @@
 #include <QTest>
 
 #include "config-keepassx-tests.h"
+#include "core/Clock.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
@@ -63,6 +64,30 @@ void TestDatabase::testOpen()
     QVERIFY(db->isModified());
 }
 
+void TestDatabase::testOpenPartiallyLoaded()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error, KeePass2::SkipAll));
+    QVERIFY(db->isInitialized());
+    QVERIFY(db->isPartiallyLoaded());
+
+    // Saving would lose the skipped parts
+    db->metadata()->setName("test");
+    QVERIFY(!db->save(Database::Atomic, {}, &error));
+    QVERIFY(!error.isEmpty());
+
+    auto fullDb = QSharedPointer<Database>::create();
+    QVERIFY(fullDb->open(tempFile.fileName(), key, &error));
+    QVERIFY(!fullDb->isPartiallyLoaded());
+}
+
 void TestDatabase::testSave()
 {
     TemporaryFile tempFile;
@@ -268,3 +293,135 @@ void TestDatabase::testCustomIcons()
     QCOMPARE(iconData.name, QString("Test"));
     QCOMPARE(iconData.lastModified, date);
 }
+
+void TestDatabase::testDeletedObjects()
+{
+    Database db;
+    const QDateTime now = Clock::currentDateTimeUtc();
+
+    DeletedObject oldObject{QUuid::createUuid(), now.addDays(-400)};
+    DeletedObject recentObject{QUuid::createUuid(), now.addDays(-10)};
+    db.addDeletedObject(oldObject);
+    db.addDeletedObject(recentObject.uuid);
+    QVERIFY(db.containsDeletedObject(oldObject.uuid));
+    QVERIFY(db.containsDeletedObject(recentObject));
+    QVERIFY(!db.containsDeletedObject(QUuid::createUuid()));
+
+    // Bulk insert skips already recorded uuids and keeps the order
+    DeletedObject newObject{QUuid::createUuid(), now};
+    db.addDeletedObjects({recentObject, newObject, newObject});
+    QCOMPARE(db.deletedObjects().size(), 3);
+    QCOMPARE(db.deletedObjects().first().uuid, oldObject.uuid);
+    QCOMPARE(db.deletedObjects().last(), newObject);
+
+    // Without an expiry policy only duplicates are removed
+    db.addDeletedObject(oldObject);
+    QCOMPARE(db.deletedObjects().size(), 4);
+    QCOMPARE(db.compactDeletedObjects(), 1);
+    QCOMPARE(db.deletedObjects().size(), 3);
+    QVERIFY(db.containsDeletedObject(oldObject.uuid));
+
+    db.metadata()->setDeletedObjectsMaxAgeDays(365);
+    QCOMPARE(db.metadata()->deletedObjectsMaxAgeDays(), 365);
+    QCOMPARE(db.compactDeletedObjects(), 1);
+    QCOMPARE(db.deletedObjects().size(), 2);
+    QVERIFY(!db.containsDeletedObject(oldObject.uuid));
+    QVERIFY(db.containsDeletedObject(recentObject.uuid));
+    QVERIFY(db.containsDeletedObject(newObject.uuid));
+
+    db.metadata()->setDeletedObjectsMaxAgeDays(0);
+    QCOMPARE(db.metadata()->deletedObjectsMaxAgeDays(), Metadata::DefaultDeletedObjectsMaxAgeDays);
+    QVERIFY(!db.metadata()->customData()->contains("KPXC_deletedObjectsMaxAgeDays"));
+
+    db.setDeletedObjects({});
+    QVERIFY(db.deletedObjects().isEmpty());
+    QVERIFY(!db.containsDeletedObject(recentObject.uuid));
+}
+
+void TestDatabase::testReloadFrom()
+{
+    Database db;
+    auto* groupA = new Group();
+    groupA->setUuid(QUuid::createUuid());
+    groupA->setName("A");
+    groupA->setParent(db.rootGroup());
+    auto* groupB = new Group();
+    groupB->setUuid(QUuid::createUuid());
+    groupB->setName("B");
+    groupB->setParent(db.rootGroup());
+    // A nested branch that is removed as a whole
+    auto* groupD = new Group();
+    groupD->setUuid(QUuid::createUuid());
+    groupD->setName("D");
+    groupD->setParent(db.rootGroup());
+    Group* parentGroup = groupD;
+    QList<QPointer<Group>> removedGroups{groupD};
+    for (int i = 0; i < 4; ++i) {
+        auto* subgroup = new Group();
+        subgroup->setUuid(QUuid::createUuid());
+        subgroup->setName(QString("D%1").arg(i));
+        subgroup->setParent(parentGroup);
+        removedGroups.append(subgroup);
+        parentGroup = subgroup;
+    }
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 4; ++i) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("entry%1").arg(i));
+        entry->setGroup(groupA);
+        entries.append(entry);
+    }
+    db.markAsClean();
+
+    // The reloaded file is a copy with a few changes on top
+    Database other;
+    delete other.setRootGroup(db.rootGroup()->clone(Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    Group* otherA = other.rootGroup()->findGroupByUuid(groupA->uuid());
+    Group* otherB = other.rootGroup()->findGroupByUuid(groupB->uuid());
+    delete other.rootGroup()->findGroupByUuid(groupD->uuid());
+    other.rootGroup()->findEntryByUuid(entries[0]->uuid())->setTitle("changed");
+    delete other.rootGroup()->findEntryByUuid(entries[1]->uuid());
+    other.rootGroup()->findEntryByUuid(entries[2]->uuid())->setGroup(otherB);
+    otherA->moveEntryDown(otherA->entries().first());
+    auto* newEntry = new Entry();
+    newEntry->setUuid(QUuid::createUuid());
+    newEntry->setTitle("new");
+    newEntry->setGroup(otherB);
+    auto* newGroup = new Group();
+    newGroup->setUuid(QUuid::createUuid());
+    newGroup->setName("C");
+    newGroup->setParent(other.rootGroup(), 0);
+    other.metadata()->setName("reloaded");
+    other.markAsClean();
+
+    QPointer<Entry> unchangedEntry = entries[3];
+    QPointer<Entry> changedEntry = entries[0];
+    QPointer<Entry> removedEntry = entries[1];
+    QVERIFY(db.reloadFrom(&other));
+
+    // Existing items are updated in place, removed ones are gone
+    QVERIFY(unchangedEntry);
+    QVERIFY(changedEntry);
+    QVERIFY(!removedEntry);
+    for (const auto& group : asConst(removedGroups)) {
+        QVERIFY(!group);
+    }
+    QCOMPARE(changedEntry->title(), QString("changed"));
+    QCOMPARE(db.rootGroup()->children().size(), 3);
+    QCOMPARE(db.rootGroup()->children().first()->uuid(), newGroup->uuid());
+    QCOMPARE(groupA->entries().size(), 2);
+    QCOMPARE(groupA->entries().first(), unchangedEntry.data());
+    QCOMPARE(groupA->entries().last(), changedEntry.data());
+    QCOMPARE(groupB->entries().size(), 2);
+    QCOMPARE(groupB->entries().first(), entries[2]);
+    QCOMPARE(groupB->entries().last()->uuid(), newEntry->uuid());
+    QCOMPARE(db.metadata()->name(), QString("reloaded"));
+    QVERIFY(!db.isModified());
+
+    // Databases with a different root group can not be patched
+    Database unrelated;
+    QVERIFY(!db.reloadFrom(&unrelated));
+    QCOMPARE(db.rootGroup()->children().size(), 3);
+}
@@ -28,6 +28,7 @@ class TestDatabase : public QObject
 private slots:
     void initTestCase();
     void testOpen();
+    void testOpenPartiallyLoaded();
     void testSave();
     void testSaveAs();
     void testSignals();
@@ -36,6 +37,8 @@ private slots:
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
     void testCustomIcons();
+    void testDeletedObjects();
+    void testReloadFrom();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
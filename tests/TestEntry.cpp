@@ -672,6 +672,68 @@ void TestEntry::testResolveClonedEntry()
     QCOMPARE(cclone4->resolveMultiplePlaceholders(cclone4->password()), original->password());
 }
 
+void TestEntry::testResolvedPlaceholderCache()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* entry1 = new Entry();
+    entry1->setGroup(root);
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setTitle("Title1");
+    entry1->setUsername("{TITLE}");
+
+    auto* entry2 = new Entry();
+    entry2->setGroup(root);
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setTitle(QString("{REF:U@I:%1}").arg(entry1->uuidToHex()));
+
+    auto* entry3 = new Entry();
+    entry3->setGroup(root);
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setTitle(QString("{REF:T@I:%1} copy").arg(entry2->uuidToHex()));
+
+    Entry::resetPlaceholderCacheStatistics();
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString("Title1 copy"));
+    QCOMPARE(Entry::placeholderCacheStatistics().misses, 1ull);
+    QCOMPARE(Entry::placeholderCacheStatistics().hits, 0ull);
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString("Title1 copy"));
+    QCOMPARE(Entry::placeholderCacheStatistics().hits, 1ull);
+
+    // Strings without placeholders bypass the cache
+    QCOMPARE(entry1->resolvePlaceholder(entry1->title()), QString("Title1"));
+    QCOMPARE(Entry::placeholderCacheStatistics().misses, 1ull);
+
+    // Changes propagate through the reference chain
+    entry1->setTitle("Title2");
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString("Title2 copy"));
+    QCOMPARE(entry2->resolvePlaceholder(entry2->title()), QString("Title2"));
+    entry2->setTitle(QString("{REF:T@I:%1}").arg(entry1->uuidToHex()));
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString("Title2 copy"));
+
+    // Changes while modification signals are suppressed
+    entry1->setEmitModified(false);
+    entry1->setTitle("Title3");
+    entry1->setEmitModified(true);
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString("Title3 copy"));
+
+    // Removed references
+    delete entry1;
+    QCOMPARE(entry2->resolvePlaceholder(entry2->title()), QString());
+    QCOMPARE(entry3->resolveMultiplePlaceholders(entry3->title()), QString(" copy"));
+
+    // Results depending on the time or on lookups by other fields are never cached
+    Entry::resetPlaceholderCacheStatistics();
+    entry2->setTitle("{DT_SIMPLE}");
+    entry2->resolvePlaceholder(entry2->title());
+    entry2->resolvePlaceholder(entry2->title());
+    entry3->setTitle(QString("{REF:T@U:%1}").arg("user"));
+    entry3->resolvePlaceholder(entry3->title());
+    entry3->resolvePlaceholder(entry3->title());
+    QCOMPARE(Entry::placeholderCacheStatistics().hits, 0ull);
+    QCOMPARE(Entry::placeholderCacheStatistics().misses, 4ull);
+}
+
 void TestEntry::testIsRecycled()
 {
     auto entry = new Entry();
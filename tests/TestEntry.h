@@ -39,6 +39,7 @@ private slots:
     void testResolveConversionPlaceholders();
     void testResolveReplacePlaceholders();
     void testResolveClonedEntry();
+    void testResolvedPlaceholderCache();
     void testIsRecycled();
     void testMoveUpDown();
     void testPreviousParentGroup();
@@ -16,10 +16,12 @@
  */
 
 #include "TestEntrySearcher.h"
+#include "core/EntrySearchIndex.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 
 #include <QTest>
+#include <QThread>
 
 QTEST_GUILESS_MAIN(TestEntrySearcher)
 
@@ -394,3 +396,230 @@ void TestEntrySearcher::testUUIDSearch()
     m_searchResult = m_entrySearcher.search("uuid:" + Tools::uuidToHex(uuid1), m_rootGroup);
     QCOMPARE(m_searchResult.count(), 1);
 }
+
+void TestEntrySearcher::testSearchIndex()
+{
+    Database db;
+    auto root = db.rootGroup();
+
+    auto group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(root);
+
+    auto e1 = new Entry();
+    e1->setUuid(QUuid::createUuid());
+    e1->setTitle("Bank Account");
+    e1->setUsername("alice");
+    e1->setUrl("https://bank.example.com");
+    e1->setTags("finance");
+    e1->setGroup(root);
+
+    auto e2 = new Entry();
+    e2->setUuid(QUuid::createUuid());
+    e2->setTitle("Mail");
+    e2->setUsername("bob");
+    e2->setNotes("Backup codes for the bank");
+    e2->setGroup(group1);
+
+    // Title is only known after resolving the reference
+    auto e3 = new Entry();
+    e3->setUuid(QUuid::createUuid());
+    e3->setTitle(QString("{REF:T@I:%1}").arg(e1->uuidToHex()));
+    e3->setUsername("carol");
+    e3->setGroup(group1);
+
+    auto e4 = new Entry();
+    e4->setUuid(QUuid::createUuid());
+    e4->setTitle("Server");
+    e4->setPassword("correct horse battery");
+    e4->setGroup(root);
+
+    const QStringList queries{"bank",
+                              "BANK",
+                              "title:bank",
+                              "ban",
+                              "b*k",
+                              "ba?k",
+                              "bank acc",
+                              "+\"bank account\"",
+                              "*ban.*",
+                              "*ba[nm]k",
+                              "bank|mail",
+                              "user:ali",
+                              "tag:fin",
+                              "notes:codes",
+                              "url:example",
+                              "-bank",
+                              "bank -mail",
+                              "pw:horse",
+                              "nonexistent"};
+
+    auto searchAll = [&]() {
+        QList<QList<Entry*>> results;
+        for (const auto& query : queries) {
+            results << m_entrySearcher.search(query, root);
+        }
+        return results;
+    };
+
+    const auto expected = searchAll();
+    db.setSearchIndexEnabled(true);
+    QVERIFY(db.searchIndex());
+    QCOMPARE(db.searchIndex()->size(), 4);
+    QCOMPARE(searchAll(), expected);
+
+    // The index narrows down the candidates
+    QSet<const Entry*> candidates;
+    m_entrySearcher.parseSearchTerms("bank");
+    QVERIFY(db.searchIndex()->candidates(m_entrySearcher.m_searchTerms, false, candidates));
+    QVERIFY(candidates.contains(e1));
+    QVERIFY(candidates.contains(e2));
+    QVERIFY(candidates.contains(e3));
+    QVERIFY(!candidates.contains(e4));
+
+    // Protected fields are not indexed unless requested
+    candidates.clear();
+    m_entrySearcher.parseSearchTerms("pw:horse");
+    QVERIFY(!db.searchIndex()->candidates(m_entrySearcher.m_searchTerms, false, candidates));
+
+    db.setSearchIndexEnabled(true, true);
+    QCOMPARE(searchAll(), expected);
+    candidates.clear();
+    QVERIFY(db.searchIndex()->candidates(m_entrySearcher.m_searchTerms, false, candidates));
+    QCOMPARE(candidates, QSet<const Entry*>{e4});
+    candidates.clear();
+    QVERIFY(!db.searchIndex()->candidates(m_entrySearcher.m_searchTerms, true, candidates));
+
+    // Modifications, moves and deletions are picked up
+    e2->setNotes("Nothing to see here");
+    e4->setTitle("Bank Server");
+    auto group2 = new Group();
+    group2->setName("group2");
+    group2->setParent(root);
+    group1->setParent(group2);
+    auto e5 = new Entry();
+    e5->setUuid(QUuid::createUuid());
+    e5->setTitle("Second bank");
+    e5->setGroup(group1);
+    delete e1;
+
+    const auto indexedResults = searchAll();
+    db.setSearchIndexEnabled(false);
+    QVERIFY(!db.searchIndex());
+    QCOMPARE(indexedResults, searchAll());
+}
+
+void TestEntrySearcher::benchmarkSearchIndex_data()
+{
+    QTest::addColumn<bool>("indexed");
+    QTest::newRow("Full scan") << false;
+    QTest::newRow("Search index") << true;
+}
+
+void TestEntrySearcher::benchmarkSearchIndex()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, indexed);
+
+    Database db;
+    for (int i = 0; i < 100; ++i) {
+        auto group = new Group();
+        group->setName(QString("Group %1").arg(i));
+        group->setParent(db.rootGroup());
+        for (int j = 0; j < 1000; ++j) {
+            auto entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setTitle(QString("Entry %1-%2").arg(i).arg(j));
+            entry->setUsername(QString("user%1@example.com").arg(j));
+            entry->setUrl(QString("https://site%1.example.com/login").arg(i * 1000 + j));
+            entry->setNotes(QString("Notes for entry %1").arg(j));
+            entry->setGroup(group);
+        }
+    }
+    db.setSearchIndexEnabled(indexed);
+
+    // Build the index outside of the measurement
+    QCOMPARE(m_entrySearcher.search("site4242", db.rootGroup()).size(), 1);
+
+    QBENCHMARK
+    {
+        m_entrySearcher.search("site4242", db.rootGroup());
+    };
+}
+
+void TestEntrySearcher::testParallelSearch()
+{
+    for (int i = 0; i < 10; ++i) {
+        auto group = new Group();
+        group->setName(QString("group%1").arg(i));
+        group->setParent(m_rootGroup);
+        for (int j = 0; j < 1000; ++j) {
+            auto entry = new Entry();
+            entry->setTitle(QString("Entry %1-%2").arg(i).arg(j));
+            entry->setNotes(j % 7 == 0 ? "needle in a haystack" : "haystack");
+            entry->attributes()->set("Color", j % 2 ? "red" : "blue");
+            entry->setGroup(group);
+        }
+    }
+
+    const QStringList queries{"notes:*needle*", "attribute:red", "-notes:needle attribute:blue", "entry 4-", ""};
+    for (const auto& query : queries) {
+        m_entrySearcher.setThreadCount(1);
+        const auto expected = m_entrySearcher.search(query, m_rootGroup);
+        const auto expectedEntries = m_entrySearcher.searchEntries(query, m_rootGroup->entriesRecursive());
+
+        m_entrySearcher.setThreadCount(4);
+        QCOMPARE(m_entrySearcher.threadCount(), 4);
+        QCOMPARE(m_entrySearcher.search(query, m_rootGroup), expected);
+        QCOMPARE(m_entrySearcher.searchEntries(query, m_rootGroup->entriesRecursive()), expectedEntries);
+    }
+
+    m_entrySearcher.setThreadCount(0);
+    QCOMPARE(m_entrySearcher.threadCount(), QThread::idealThreadCount());
+}
+
+void TestEntrySearcher::benchmarkParallelSearch_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("Ideal thread count") << 0;
+}
+
+void TestEntrySearcher::benchmarkParallelSearch()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, threads);
+
+    for (int i = 0; i < 100; ++i) {
+        auto group = new Group();
+        group->setName(QString("Group %1").arg(i));
+        group->setParent(m_rootGroup);
+        for (int j = 0; j < 1000; ++j) {
+            auto entry = new Entry();
+            entry->setTitle(QString("Entry %1-%2").arg(i).arg(j));
+            entry->setUsername(QString("user%1@example.com").arg(j));
+            entry->setNotes(QString("Notes for entry %1 of group %2").arg(j).arg(i));
+            entry->attributes()->set("Custom", QString("Value %1").arg(j));
+            entry->setGroup(group);
+        }
+    }
+    m_entrySearcher.setThreadCount(threads);
+
+    // Compare the timings of the rows to get the speedup over a single thread
+    QBENCHMARK
+    {
+        m_entrySearcher.search("notes:*group*42 attribute:value", m_rootGroup);
+    };
+}
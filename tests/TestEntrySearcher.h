@@ -39,6 +39,12 @@ private slots:
     void testGroup();
     void testSkipProtected();
     void testUUIDSearch();
+    void testSearchIndex();
+    void benchmarkSearchIndex_data();
+    void benchmarkSearchIndex();
+    void testParallelSearch();
+    void benchmarkParallelSearch_data();
+    void benchmarkParallelSearch();
 
 private:
     Group* m_rootGroup;
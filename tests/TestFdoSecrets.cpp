@@ -21,6 +21,7 @@
 #include "core/Group.h"
 #include "crypto/Random.h"
 #include "fdosecrets/objects/Collection.h"
+#include "fdosecrets/objects/ItemAttributeIndex.h"
 #include "fdosecrets/objects/SessionCipher.h"
 
 #include <QTest>
@@ -124,3 +125,42 @@ void TestFdoSecrets::testDBusPathParse()
     parsed = DBusMgr::parsePath(QStringLiteral("/org"));
     QCOMPARE(parsed.type, PathType::Unknown);
 }
+
+void TestFdoSecrets::testItemAttributeIndex()
+{
+    using FdoSecrets::ItemAttributeIndex;
+
+    const QScopedPointer<Group> root(new Group());
+    auto e1 = new Entry();
+    e1->setGroup(root.data());
+    e1->setTitle("title");
+    e1->attributes()->set("application", "git");
+
+    auto e2 = new Entry();
+    e2->setGroup(root.data());
+    e2->setTitle("{REF:T@I:00000000000000000000000000000000}");
+    e2->attributes()->set("application", "git\n");
+    e2->attributes()->set("token", "secret", true);
+
+    ItemAttributeIndex index;
+    index.addEntry(e1);
+    index.addEntry(e2);
+
+    // Values with trailing line breaks remain candidates
+    QCOMPARE(index.candidates({{"application", "git"}}), QSet<Entry*>({e1, e2}));
+    QCOMPARE(index.candidates({{"application", "svn"}}), QSet<Entry*>{});
+
+    // Fields with placeholders and protected attributes are always candidates
+    QCOMPARE(index.candidates({{"Title", "title"}}), QSet<Entry*>({e1, e2}));
+    QCOMPARE(index.candidates({{"token", "anything"}}), QSet<Entry*>{e2});
+    QCOMPARE(index.candidates({{"application", "git"}, {"token", "anything"}}), QSet<Entry*>{e2});
+
+    // Modified entries are re-indexed
+    e1->attributes()->set("application", "svn");
+    QCOMPARE(index.candidates({{"application", "svn"}}), QSet<Entry*>{e1});
+    QCOMPARE(index.candidates({{"application", "git"}}), QSet<Entry*>{e2});
+
+    index.removeEntry(e2);
+    QCOMPARE(index.candidates({{"application", "git"}}), QSet<Entry*>{});
+    QCOMPARE(index.candidates({{"token", "anything"}}), QSet<Entry*>{});
+}
@@ -29,6 +29,7 @@ private slots:
     void testCrazyAttributeKey();
     void testSpecialCharsInAttributeValue();
     void testDBusPathParse();
+    void testItemAttributeIndex();
 };
 
 #endif // KEEPASSXC_TESTFDOSECRETS_H
@@ -554,6 +554,74 @@ void TestGroup::testFindEntry()
     QVERIFY(!entry);
 }
 
+void TestGroup::testFindByUuidIndex()
+{
+    QScopedPointer<Database> db(new Database());
+    auto root = db->rootGroup();
+
+    auto group1 = new Group();
+    group1->setUuid(QUuid::createUuid());
+    group1->setParent(root);
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(group1);
+
+    QCOMPARE(root->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(group1->findEntryByUuid(entry1->uuid(), false), entry1);
+    QVERIFY(!root->findEntryByUuid(entry1->uuid(), false));
+    QCOMPARE(root->findGroupByUuid(group1->uuid()), group1);
+    QCOMPARE(root->findGroupByUuid(root->uuid()), root);
+    QVERIFY(!group1->findGroupByUuid(root->uuid()));
+
+    // Changing the uuid updates the index
+    const QUuid oldUuid = entry1->uuid();
+    entry1->setUuid(QUuid::createUuid());
+    QVERIFY(!root->findEntryByUuid(oldUuid));
+    QCOMPARE(root->findEntryByUuid(entry1->uuid()), entry1);
+
+    // Moving an entry within the database
+    entry1->setGroup(root);
+    QCOMPARE(root->findEntryByUuid(entry1->uuid(), false), entry1);
+    QVERIFY(!group1->findEntryByUuid(entry1->uuid()));
+
+    // Attaching a subtree that was built outside of the database
+    auto group2 = new Group();
+    group2->setUuid(QUuid::createUuid());
+    auto entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setGroup(group2);
+    QVERIFY(!root->findEntryByUuid(entry2->uuid()));
+
+    group2->setParent(group1);
+    QCOMPARE(root->findEntryByUuid(entry2->uuid()), entry2);
+    QCOMPARE(group1->findEntryByUuid(entry2->uuid()), entry2);
+    QCOMPARE(root->findGroupByUuid(group2->uuid()), group2);
+
+    // Moving a subtree to another database
+    QScopedPointer<Database> db2(new Database());
+    group1->setParent(db2->rootGroup());
+    QVERIFY(!root->findEntryByUuid(entry2->uuid()));
+    QVERIFY(!root->findGroupByUuid(group2->uuid()));
+    QCOMPARE(db2->rootGroup()->findEntryByUuid(entry2->uuid()), entry2);
+    QCOMPARE(db2->rootGroup()->findGroupByUuid(group2->uuid()), group2);
+
+    // Deleted objects are removed from the index
+    const QUuid entry2Uuid = entry2->uuid();
+    const QUuid group2Uuid = group2->uuid();
+    delete group2;
+    QVERIFY(!db2->rootGroup()->findEntryByUuid(entry2Uuid));
+    QVERIFY(!db2->rootGroup()->findGroupByUuid(group2Uuid));
+
+    // A replaced root group is no longer part of the index but can still be searched
+    const QUuid entry1Uuid = entry1->uuid();
+    auto oldRoot = db->setRootGroup(new Group());
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entry1Uuid));
+    QCOMPARE(oldRoot->findEntryByUuid(entry1Uuid), entry1);
+    QCOMPARE(db->rootGroup()->findGroupByUuid(db->rootGroup()->uuid()), db->rootGroup());
+    delete oldRoot;
+}
+
 void TestGroup::testFindGroupByPath()
 {
     QScopedPointer<Database> db(new Database());
@@ -1319,3 +1387,56 @@ void TestGroup::testAutoTypeState()
     QVERIFY(!entry1->groupAutoTypeEnabled());
     QVERIFY(entry2->groupAutoTypeEnabled());
 }
+
+void TestGroup::benchmarkFindEntryByUuid_data()
+{
+    QTest::addColumn<bool>("indexed");
+    QTest::newRow("Linear scan") << false;
+    QTest::newRow("Uuid index") << true;
+}
+
+void TestGroup::benchmarkFindEntryByUuid()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, indexed);
+
+    Database db;
+    QList<QUuid> uuids;
+    for (int i = 0; i < 100; ++i) {
+        auto group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setParent(db.rootGroup());
+        for (int j = 0; j < 500; ++j) {
+            auto entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setGroup(group);
+            if (j % 100 == 0) {
+                uuids << entry->uuid();
+            }
+        }
+    }
+
+    QBENCHMARK
+    {
+        for (const auto& uuid : asConst(uuids)) {
+            Entry* found = nullptr;
+            if (indexed) {
+                found = db.rootGroup()->findEntryByUuid(uuid);
+            } else {
+                // Previous lookup path: flatten the tree and scan it
+                for (auto entry : db.rootGroup()->entriesRecursive()) {
+                    if (entry->uuid() == uuid) {
+                        found = entry;
+                        break;
+                    }
+                }
+            }
+            QVERIFY(found);
+        }
+    };
+}
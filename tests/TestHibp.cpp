@@ -24,6 +24,7 @@
 #include <QBuffer>
 #include <QByteArray>
 #include <QList>
+#include <QTemporaryFile>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestHibp)
@@ -31,6 +32,14 @@ QTEST_GUILESS_MAIN(TestHibp)
 const char* TEST_HIBP_CONTENTS = "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n" // SHA-1 of "foo"
                                  "62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\n"; // SHA-1 of "bar"
 
+// SHA-1 of "foo", "xyz" and "bar" in ascending order, surrounded by filler lines
+const char* TEST_SORTED_HIBP_CONTENTS = "00000000000000000000000000000000000000AA:1\r\n"
+                                        "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\r\n"
+                                        "3B7C1A9C0C6A6B7B1D8C5F5E0F1A0D9E0C4B2A11:7\r\n"
+                                        "62CDB7020FF920E5AA642C3D4066950DD1F01F4D:456\r\n"
+                                        "66B27417D37E024C46526C2F6D358A754FC552F3:0\r\n"
+                                        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF:2\r\n";
+
 const char* TEST_BAD_HIBP_CONTENTS = "barf:nope\n";
 
 void TestHibp::initTestCase()
@@ -118,3 +127,137 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+void TestHibp::testSortedFile()
+{
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    hibpFile.write(TEST_SORTED_HIBP_CONTENTS);
+    QVERIFY(hibpFile.flush());
+    QVERIFY(hibpFile.seek(0));
+
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("bar");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("xyz");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setPassword("foo");
+    entry3->setGroup(root);
+
+    auto entry4 = new Entry();
+    entry4->setPassword("bar");
+    entry4->setGroup(root);
+
+    auto entry5 = new Entry();
+    entry5->setPassword("not leaked");
+    entry5->setGroup(root);
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::report(m_db, hibpFile, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 4);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 456);
+    QCOMPARE(findings[1].first, entry2);
+    QCOMPARE(findings[1].second, 0);
+    QCOMPARE(findings[2].first, entry3);
+    QCOMPARE(findings[2].second, 123);
+    QCOMPARE(findings[3].first, entry4);
+    QCOMPARE(findings[3].second, 456);
+}
+
+void TestHibp::testUnsortedFile()
+{
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    hibpFile.write("62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\n"
+                   "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n"
+                   "barf:nope\n");
+    QVERIFY(hibpFile.flush());
+    QVERIFY(hibpFile.seek(0));
+
+    auto entry = new Entry();
+    entry->setPassword("foo");
+    entry->setGroup(m_db->rootGroup());
+
+    // Unsorted files are scanned line by line, so the parse error is found
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(!HibpOffline::report(m_db, hibpFile, findings, &error));
+    QVERIFY(error.contains("line 3"));
+    QCOMPARE(findings.size(), 0);
+}
+
+void TestHibp::testIndex()
+{
+    QByteArray hibpContents(TEST_SORTED_HIBP_CONTENTS);
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QTemporaryFile indexFile;
+    QVERIFY(indexFile.open());
+    QString error;
+    QVERIFY(!HibpOffline::buildIndex(hibpBuffer, indexFile, 4, &error));
+    QVERIFY(!error.isEmpty());
+
+    error.clear();
+    QVERIFY(HibpOffline::buildIndex(hibpBuffer, indexFile, 10, &error));
+    QCOMPARE(error, QString());
+    QVERIFY(indexFile.flush());
+    QVERIFY(indexFile.seek(0));
+
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("bar");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("not leaked");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setPassword("foo");
+    entry3->setGroup(root);
+
+    QList<QPair<const Entry*, int>> findings;
+    QVERIFY(HibpOffline::report(m_db, indexFile, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 2);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 456);
+    QCOMPARE(findings[1].first, entry3);
+    QCOMPARE(findings[1].second, 123);
+
+    // Index files cannot be streamed
+    QVERIFY(indexFile.seek(0));
+    auto indexContents = indexFile.readAll();
+    QBuffer indexBuffer(&indexContents);
+    QVERIFY(indexBuffer.open(QIODevice::ReadOnly));
+    findings.clear();
+    QVERIFY(!HibpOffline::report(m_db, indexBuffer, findings, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestHibp::testIndexUnsorted()
+{
+    QByteArray hibpContents(TEST_HIBP_CONTENTS);
+    hibpContents.prepend("62CDB7020FF920E5AA642C3D4066950DD1F01F4D:1\n");
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QByteArray indexContents;
+    QBuffer indexBuffer(&indexContents);
+    QVERIFY(indexBuffer.open(QIODevice::WriteOnly));
+
+    QString error;
+    QVERIFY(!HibpOffline::buildIndex(hibpBuffer, indexBuffer, 20, &error));
+    QVERIFY(error.contains("not sorted"));
+}
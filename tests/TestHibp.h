@@ -34,6 +34,10 @@ private slots:
     void testEmpty();
     void testIoError();
     void testPwned();
+    void testSortedFile();
+    void testUnsortedFile();
+    void testIndex();
+    void testIndexUnsorted();
 
 private:
     QSharedPointer<Database> m_db;
@@ -18,16 +18,20 @@
 #include "TestKdbx4.h"
 
 #include "config-keepassx-tests.h"
+#include "core/AttachmentSpillFile.h"
 #include "core/Metadata.h"
+#include "crypto/CryptoHash.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KdbxXmlWriter.h"
 #include "format/KeePass2.h"
+#include "format/KeePass2RandomStream.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "keys/FileKey.h"
 #include "keys/PasswordKey.h"
 #include "mock/MockChallengeResponseKey.h"
 #include "mock/MockClock.h"
+#include "streams/HmacBlockStream.h"
 #include <QTest>
 
 int main(int argc, char* argv[])
@@ -123,6 +127,8 @@ void TestKdbx4Format::init()
 void TestKdbx4Format::cleanup()
 {
     MockClock::teardown();
+    // Restore the spill threshold even if a test changing it failed
+    AttachmentSpillFile::instance()->setThreshold(AttachmentSpillFile::DefaultThreshold);
 }
 
 void TestKdbx4Format::testFormat400()
@@ -511,6 +517,117 @@ void TestKdbx4Format::testAttachmentIndexStability()
     QCOMPARE(a3->value("b"), attachment2);
     QCOMPARE(a3->value("x"), attachment3);
     QCOMPARE(a3->value("y"), attachment3);
+
+    // References to the same binary share one blob
+    QCOMPARE(a1->blob("a"), a2->blob("a"));
+    QCOMPARE(a3->blob("x"), a3->blob("y"));
+    QCOMPARE(a1->blob("a")->digest(), CryptoHash::hash(attachment1, CryptoHash::Sha256));
+}
+
+void TestKdbx4Format::testAttachmentSpill()
+{
+    auto spillFile = AttachmentSpillFile::instance();
+    spillFile->setThreshold(16);
+
+    QScopedPointer<Database> db(new Database());
+    db->changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID)));
+    db->setKey(QSharedPointer<CompositeKey>::create());
+
+    const QByteArray small("small");
+    const QByteArray large = QByteArray("large attachment ").repeated(64);
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->attachments()->set("small", small);
+    entry->attachments()->set("large", large);
+    entry->setGroup(db->rootGroup());
+    QVERIFY(!entry->attachments()->blob("small")->isSpilled());
+    QVERIFY(entry->attachments()->blob("large")->isSpilled());
+    QCOMPARE(entry->attachments()->value("large"), large);
+    QCOMPARE(entry->attachments()->attachmentsSize(), 10 + small.size() + large.size());
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    buffer.seek(0);
+    KeePass2Reader reader;
+    auto db2 = QSharedPointer<Database>::create();
+    reader.readDatabase(&buffer, QSharedPointer<CompositeKey>::create(), db2.data());
+    QVERIFY(!reader.hasError());
+
+    // Spilled content is decrypted on demand and compares equal to the original
+    auto attachments = db2->rootGroup()->findEntryByUuid(entry->uuid())->attachments();
+    QVERIFY(attachments->blob("large")->isSpilled());
+    QCOMPARE(attachments->value("small"), small);
+    QCOMPARE(attachments->value("large"), large);
+    QCOMPARE(attachments->blob("large")->digest(), CryptoHash::hash(large, CryptoHash::Sha256));
+    QVERIFY(*attachments == *entry->attachments());
+
+    // The space of released regions is reused
+    const QByteArray other = QByteArray("other attachment").repeated(64);
+    AttachmentSpillFile::Region first, second, third;
+    QVERIFY(spillFile->write(large, first));
+    QVERIFY(spillFile->write(large, second));
+    spillFile->release(first);
+    QVERIFY(spillFile->write(other.left(large.size()), third));
+    QCOMPARE(third.offset, first.offset);
+    QByteArray data;
+    QVERIFY(spillFile->read(third, data));
+    QCOMPARE(data, other.left(large.size()));
+    QVERIFY(spillFile->read(second, data));
+    QCOMPARE(data, large);
+    spillFile->release(second);
+    spillFile->release(third);
+}
+
+void TestKdbx4Format::testReadOptions()
+{
+    QScopedPointer<Database> db(new Database());
+    db->changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID)));
+    db->setKey(QSharedPointer<CompositeKey>::create());
+
+    const QUuid iconUuid = QUuid::createUuid();
+    db->metadata()->addCustomIcon(iconUuid, QByteArray("icon data"));
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setPassword("old password");
+    entry1->setGroup(db->rootGroup());
+    entry1->beginUpdate();
+    entry1->setPassword("password1");
+    entry1->attachments()->set("attachment", QByteArray("attachment data"));
+    entry1->endUpdate();
+    QCOMPARE(entry1->historyItems().size(), 1);
+
+    // Protected values after the skipped parts must still be decrypted correctly
+    auto entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setPassword("password2");
+    entry2->setGroup(db->rootGroup());
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    buffer.seek(0);
+    KeePass2Reader reader;
+    reader.setReadOptions(KeePass2::SkipAll);
+    auto db2 = QSharedPointer<Database>::create();
+    reader.readDatabase(&buffer, QSharedPointer<CompositeKey>::create(), db2.data());
+    QVERIFY(!reader.hasError());
+
+    auto readEntry1 = db2->rootGroup()->findEntryByUuid(entry1->uuid());
+    auto readEntry2 = db2->rootGroup()->findEntryByUuid(entry2->uuid());
+    QVERIFY(readEntry1);
+    QVERIFY(readEntry2);
+    QCOMPARE(readEntry1->password(), QString("password1"));
+    QCOMPARE(readEntry2->password(), QString("password2"));
+    QVERIFY(readEntry1->historyItems().isEmpty());
+    QVERIFY(readEntry1->attachments()->isEmpty());
+    QVERIFY(!db2->metadata()->hasCustomIcon(iconUuid));
 }
 
 void TestKdbx4Format::testCustomData()
@@ -606,3 +723,127 @@ void TestKdbx4Format::testCustomData()
     QCOMPARE(newEntry->customData()->value(customDataKey1), customData1);
     QCOMPARE(newEntry->customData()->value(customDataKey2), customData2);
 }
+
+void TestKdbx4Format::testParallelHmacBlocks()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i) {
+        data.append(static_cast<char>(i % 251));
+    }
+    const QByteArray key(64, '\x42');
+
+    QBuffer serialBuffer;
+    QVERIFY(serialBuffer.open(QIODevice::WriteOnly));
+    HmacBlockStream serialWriter(&serialBuffer, key, 64);
+    QVERIFY(serialWriter.open(QIODevice::WriteOnly));
+    QCOMPARE(serialWriter.write(data), qint64(data.size()));
+    QVERIFY(serialWriter.reset());
+
+    QBuffer parallelBuffer;
+    QVERIFY(parallelBuffer.open(QIODevice::WriteOnly));
+    HmacBlockStream parallelWriter(&parallelBuffer, key, 64);
+    parallelWriter.setMaxPendingBlocks(4);
+    QVERIFY(parallelWriter.open(QIODevice::WriteOnly));
+    QCOMPARE(parallelWriter.write(data), qint64(data.size()));
+    QVERIFY(parallelWriter.reset());
+
+    // Concurrent HMAC computation must not change the output
+    QCOMPARE(parallelBuffer.data(), serialBuffer.data());
+
+    parallelBuffer.close();
+    QVERIFY(parallelBuffer.open(QIODevice::ReadOnly));
+    HmacBlockStream reader(&parallelBuffer, key);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QCOMPARE(reader.readAll(), data);
+}
+
+void TestKdbx4Format::benchmarkSave()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    db.changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID)));
+    db.setKey(QSharedPointer<CompositeKey>::create());
+
+    for (int i = 0; i < 2000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setPassword(QString("password%1").arg(i));
+        entry->setNotes(QString("Notes for entry %1").arg(i).repeated(20));
+        entry->setGroup(db.rootGroup());
+    }
+    auto attachmentEntry = db.rootGroup()->entries().first();
+    for (int i = 0; i < 8; ++i) {
+        QByteArray attachment(1024 * 1024, static_cast<char>(i));
+        attachmentEntry->attachments()->set(QString("attachment%1").arg(i), attachment);
+    }
+
+    QByteArray data;
+    QBENCHMARK
+    {
+        QBuffer buffer;
+        QVERIFY(buffer.open(QBuffer::WriteOnly));
+        KeePass2Writer writer;
+        QVERIFY(writer.writeDatabase(&buffer, &db));
+        data = buffer.data();
+    }
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QBuffer::ReadOnly));
+    KeePass2Reader reader;
+    auto newDb = QSharedPointer<Database>::create();
+    QVERIFY(reader.readDatabase(&buffer, QSharedPointer<CompositeKey>::create(), newDb.data()));
+    QCOMPARE(newDb->rootGroup()->entries().size(), 2000);
+    QCOMPARE(newDb->rootGroup()->entries().first()->attachments()->keys().size(), 8);
+}
+
+void TestKdbx4Format::benchmarkReadXml()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    for (int i = 0; i < 5000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setPassword(QString("password%1").arg(i));
+        entry->setUrl(QString("https://example%1.com").arg(i));
+        entry->attributes()->set("Protected attribute", QString("secret%1").arg(i), true);
+        entry->setGroup(db.rootGroup());
+    }
+
+    const QByteArray protectedStreamKey(64, '\x11');
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    KeePass2RandomStream writeStream;
+    QVERIFY(writeStream.init(SymmetricCipher::ChaCha20, protectedStreamKey));
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_4, {});
+    writer.writeDatabase(&buffer, &db, &writeStream);
+    QVERIFY(!writer.hasError());
+    buffer.close();
+
+    QBENCHMARK
+    {
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        KeePass2RandomStream readStream;
+        QVERIFY(readStream.init(SymmetricCipher::ChaCha20, protectedStreamKey));
+        Database newDb;
+        KdbxXmlReader reader(KeePass2::FILE_VERSION_4);
+        reader.readDatabase(&buffer, &newDb, &readStream);
+        QVERIFY(!reader.hasError());
+        QCOMPARE(newDb.rootGroup()->entries().size(), 5000);
+        QCOMPARE(newDb.rootGroup()->entries().last()->password(), QString("password4999"));
+        buffer.close();
+    }
+}
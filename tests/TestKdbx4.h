@@ -65,7 +65,12 @@ private slots:
     void testUpgradeMasterKeyIntegrity();
     void testUpgradeMasterKeyIntegrity_data();
     void testAttachmentIndexStability();
+    void testAttachmentSpill();
+    void testReadOptions();
     void testCustomData();
+    void testParallelHmacBlocks();
+    void benchmarkSave();
+    void benchmarkReadXml();
 };
 
 #endif // KEEPASSXC_TEST_KDBX4_H
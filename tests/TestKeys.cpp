@@ -36,6 +36,22 @@
 #include "mock/MockChallengeResponseKey.h"
 
 QTEST_GUILESS_MAIN(TestKeys)
+
+namespace
+{
+    // AES-KDF counting how often the key derivation actually runs
+    class CountingKdf : public AesKdf
+    {
+    public:
+        bool transform(const QByteArray& raw, QByteArray& result) const override
+        {
+            ++count;
+            return AesKdf::transform(raw, result);
+        }
+
+        mutable int count = 0;
+    };
+} // namespace
 Q_DECLARE_METATYPE(FileKey::Type);
 
 void TestKeys::initTestCase()
@@ -73,6 +89,43 @@ void TestKeys::testComposite()
     QCOMPARE(compositeKey1->rawKey(), compositeKey3->rawKey());
 }
 
+void TestKeys::testTransformCache()
+{
+    auto compositeKey = QSharedPointer<CompositeKey>::create();
+    compositeKey->addKey(QSharedPointer<PasswordKey>::create("password"));
+
+    CountingKdf kdf;
+    kdf.setRounds(1);
+    QByteArray transformed1;
+    QVERIFY(compositeKey->transform(kdf, transformed1));
+    QCOMPARE(kdf.count, 1);
+
+    // same KDF parameters and seed, the derivation is skipped
+    QByteArray transformed2;
+    QVERIFY(compositeKey->transform(kdf, transformed2));
+    QCOMPARE(kdf.count, 1);
+    QCOMPARE(transformed2, transformed1);
+
+    // a new seed derives a new key
+    kdf.randomizeSeed();
+    QVERIFY(compositeKey->transform(kdf, transformed2));
+    QCOMPARE(kdf.count, 2);
+    QVERIFY(transformed2 != transformed1);
+
+    // changing the composite key drops the remembered keys
+    compositeKey->addKey(QSharedPointer<PasswordKey>::create("other"));
+    QVERIFY(compositeKey->transform(kdf, transformed2));
+    QCOMPARE(kdf.count, 3);
+
+    auto compositeKey2 = QSharedPointer<CompositeKey>::create();
+    compositeKey2->addKey(QSharedPointer<PasswordKey>::create("password"));
+    compositeKey2->addKey(QSharedPointer<PasswordKey>::create("other"));
+    QByteArray expected;
+    QVERIFY(compositeKey2->transform(kdf, expected));
+    QCOMPARE(kdf.count, 4);
+    QCOMPARE(transformed2, expected);
+}
+
 void TestKeys::testFileKey()
 {
     QFETCH(FileKey::Type, type);
@@ -242,6 +295,8 @@ void TestKeys::benchmarkTransformKey()
 
     QBENCHMARK
     {
+        // use a new seed every time, otherwise the transformed key is reused
+        kdf.randomizeSeed();
         Q_UNUSED(!compositeKey->transform(kdf, result));
     };
 }
@@ -28,6 +28,7 @@ class TestKeys : public QObject
 private slots:
     void initTestCase();
     void testComposite();
+    void testTransformCache();
     void testFileKey();
     void testFileKey_data();
     void testCreateFileKey();
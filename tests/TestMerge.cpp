@@ -1452,6 +1452,140 @@ void TestMerge::testMergeModified()
     QTRY_VERIFY(!modifiedSignalSpy.empty());
 }
 
+/**
+ * Planning a merge must not touch the target, applying the plan must
+ * have the same result as a merge.
+ */
+void TestMerge::testMergePlan()
+{
+    QScopedPointer<Database> dbSource(createTestDatabase());
+    QScopedPointer<Database> dbDestination(
+        createTestDatabaseStructureClone(dbSource.data(), Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    QPointer<Entry> entrySource1 = dbSource->rootGroup()->findEntryByPath("entry1");
+    QPointer<Entry> entrySource2 = dbSource->rootGroup()->findEntryByPath("entry2");
+    QVERIFY(entrySource1 && entrySource2);
+    entrySource1->setTitle("entry1 updated");
+    const QUuid uuid2 = entrySource2->uuid();
+    delete entrySource2;
+
+    auto* newEntry = new Entry();
+    newEntry->setUuid(QUuid::createUuid());
+    newEntry->setTitle("entry3");
+    newEntry->setGroup(dbSource->rootGroup());
+
+    const QUuid iconUuid = QUuid::createUuid();
+    dbSource->metadata()->addCustomIcon(iconUuid, QByteArray("custom icon"));
+
+    m_clock->advanceSecond(1);
+
+    dbDestination->markAsClean();
+    const auto deletedObjects = dbDestination->deletedObjects();
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.setForcedMergeMode(Group::Synchronize);
+    const auto changes = merger.plan();
+
+    QList<Merger::ChangeType> types;
+    for (const auto& change : changes) {
+        types << change.type;
+    }
+    QVERIFY(types.contains(Merger::ChangeType::UpdateEntry));
+    QVERIFY(types.contains(Merger::ChangeType::CreateEntry));
+    QVERIFY(types.contains(Merger::ChangeType::DeleteEntry));
+    QVERIFY(types.contains(Merger::ChangeType::DeletedObjects));
+    QVERIFY(types.contains(Merger::ChangeType::AddCustomIcon));
+
+    const auto createEntry = changes.at(types.indexOf(Merger::ChangeType::CreateEntry)).toVariantMap();
+    QCOMPARE(createEntry.value("type").toString(), QString("CreateEntry"));
+    QCOMPARE(createEntry.value("uuid").toString(), newEntry->uuidToHex());
+    QCOMPARE(createEntry.value("group").toString(), dbDestination->rootGroup()->uuidToHex());
+
+    // The target is untouched by planning
+    QVERIFY(!dbDestination->isModified());
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 2);
+    QVERIFY(dbDestination->rootGroup()->findEntryByPath("entry1"));
+    QVERIFY(dbDestination->rootGroup()->findEntryByUuid(uuid2));
+    QCOMPARE(dbDestination->deletedObjects(), deletedObjects);
+    QVERIFY(!dbDestination->metadata()->hasCustomIcon(iconUuid));
+
+    QStringList descriptions;
+    for (const auto& change : changes) {
+        descriptions << change.description;
+    }
+    QCOMPARE(merger.apply(changes), descriptions);
+
+    QVERIFY(dbDestination->isModified());
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 2);
+    QVERIFY(dbDestination->rootGroup()->findEntryByPath("entry1 updated"));
+    QVERIFY(dbDestination->rootGroup()->findEntryByPath("entry3"));
+    QVERIFY(!dbDestination->rootGroup()->findEntryByUuid(uuid2));
+    QVERIFY(dbDestination->containsDeletedObject(uuid2));
+    QVERIFY(dbDestination->metadata()->hasCustomIcon(iconUuid));
+}
+
+/**
+ * Synchronize two large databases with updated, created and deleted entries.
+ */
+void TestMerge::benchmarkMergeLarge()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QScopedPointer<Database> dbSource(new Database());
+    QList<Group*> sourceGroups;
+    for (int i = 0; i < 10; ++i) {
+        auto group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(QString("group%1").arg(i));
+        group->setParent(dbSource->rootGroup());
+        sourceGroups << group;
+    }
+    for (int i = 0; i < 100000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("entry%1").arg(i));
+        entry->setGroup(sourceGroups[i % sourceGroups.size()]);
+    }
+
+    QScopedPointer<Database> dbDestination(
+        createTestDatabaseStructureClone(dbSource.data(), Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    // Update every 10th entry, delete every 100th entry and create new ones in the source
+    const auto sourceEntries = dbSource->rootGroup()->entriesRecursive();
+    for (int i = 0; i < sourceEntries.size(); ++i) {
+        if (i % 100 == 0) {
+            delete sourceEntries[i];
+        } else if (i % 10 == 0) {
+            sourceEntries[i]->setTitle(sourceEntries[i]->title() + " updated");
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("new entry%1").arg(i));
+        entry->setGroup(sourceGroups[i % sourceGroups.size()]);
+    }
+
+    m_clock->advanceSecond(1);
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.setForcedMergeMode(Group::Synchronize);
+    QBENCHMARK_ONCE
+    {
+        merger.merge();
+    }
+
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 100000 - 1000 + 1000);
+    QCOMPARE(dbDestination->deletedObjects().size(), 1000);
+}
+
 Database* TestMerge::createTestDatabase()
 {
     auto db = new Database();
@@ -56,6 +56,8 @@ private slots:
     void testDeletedGroup();
     void testDeletedRevertedEntry();
     void testDeletedRevertedGroup();
+    void testMergePlan();
+    void benchmarkMergeLarge();
 
 private:
     Database* createTestDatabase();
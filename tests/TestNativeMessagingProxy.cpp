@@ -0,0 +1,182 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestNativeMessagingProxy.h"
+
+#include "browser/BrowserHost.h"
+#include "browser/BrowserShared.h"
+
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTest>
+#include <QTimer>
+
+#include <cstring>
+
+QTEST_GUILESS_MAIN(TestNativeMessagingProxy)
+
+namespace
+{
+    constexpr int MessageTimeout = 5000;
+} // namespace
+
+void TestNativeMessagingProxy::initTestCase()
+{
+#ifdef Q_OS_WIN
+    QSKIP("The host pipe name cannot be moved away from a running instance on Windows");
+#endif
+    QVERIFY(m_runtimeDir.isValid());
+    // Keep the stand-in host apart from a running KeePassXC, the proxy inherits the environment
+    qputenv("XDG_RUNTIME_DIR", m_runtimeDir.path().toLocal8Bit());
+    qputenv("TMPDIR", m_runtimeDir.path().toLocal8Bit());
+}
+
+void TestNativeMessagingProxy::init()
+{
+    // The stand-in host echoes every message back to the proxy
+    m_host.reset(new BrowserHost());
+    auto* host = m_host.data();
+    connect(host, &BrowserHost::clientMessageReceived, host, [host](QLocalSocket* socket, const QJsonObject& json) {
+        host->sendClientMessage(socket, json);
+    });
+    m_host->start();
+
+    m_stdoutBuffer.clear();
+    m_proxy.reset(new QProcess());
+    m_proxy->start(KEEPASSXC_PROXY_PATH, {});
+    QVERIFY(m_proxy->waitForStarted(MessageTimeout));
+}
+
+void TestNativeMessagingProxy::cleanup()
+{
+    if (m_proxy) {
+        m_proxy->closeWriteChannel();
+        if (!m_proxy->waitForFinished(MessageTimeout)) {
+            m_proxy->kill();
+            m_proxy->waitForFinished();
+        }
+        m_proxy.reset();
+    }
+    m_host.reset();
+}
+
+void TestNativeMessagingProxy::writeMessage(const QByteArray& message)
+{
+    // Browsers prefix messages with their length in native byte order
+    const quint32 length = message.size();
+    m_proxy->write(reinterpret_cast<const char*>(&length), sizeof(length));
+    m_proxy->write(message);
+}
+
+QByteArray TestNativeMessagingProxy::readMessage()
+{
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(m_proxy.data(), &QProcess::readyReadStandardOutput, &loop, &QEventLoop::quit);
+    timeout.start(MessageTimeout);
+
+    // The event loop also runs the stand-in host
+    quint32 length = 0;
+    while (timeout.isActive()) {
+        m_stdoutBuffer.append(m_proxy->readAllStandardOutput());
+        if (m_stdoutBuffer.size() >= static_cast<int>(sizeof(length))) {
+            memcpy(&length, m_stdoutBuffer.constData(), sizeof(length));
+            if (m_stdoutBuffer.size() >= static_cast<int>(sizeof(length) + length)) {
+                const auto message = m_stdoutBuffer.mid(sizeof(length), length);
+                m_stdoutBuffer.remove(0, sizeof(length) + length);
+                return message;
+            }
+        }
+        loop.exec();
+    }
+    return {};
+}
+
+void TestNativeMessagingProxy::testRoundTrip()
+{
+    const QByteArray message = QStringLiteral(R"({"action":"test","text":"Grüße 🔑"})").toUtf8();
+    writeMessage(message);
+    QCOMPARE(QJsonDocument::fromJson(readMessage()), QJsonDocument::fromJson(message));
+}
+
+void TestNativeMessagingProxy::testPipelinedMessages()
+{
+    // Several requests in flight at once must come back as separate messages, in order
+    QList<QByteArray> messages;
+    for (int i = 0; i < 20; ++i) {
+        messages << QStringLiteral(R"({"action":"test","id":%1,"padding":"%2"})")
+                        .arg(i)
+                        .arg(QString(i * 1000, 'x'))
+                        .toUtf8();
+        writeMessage(messages.last());
+    }
+    for (const auto& message : messages) {
+        QCOMPARE(QJsonDocument::fromJson(readMessage()), QJsonDocument::fromJson(message));
+    }
+}
+
+void TestNativeMessagingProxy::testLegacyHost()
+{
+    // Replace the stand-in host with one that only understands bare JSON, like hosts without framing
+    cleanup();
+    QLocalServer legacyHost;
+    QLocalServer::removeServer(BrowserShared::localServerPath());
+    QVERIFY(legacyHost.listen(BrowserShared::localServerPath()));
+    connect(&legacyHost, &QLocalServer::newConnection, &legacyHost, [&legacyHost] {
+        auto* socket = legacyHost.nextPendingConnection();
+        connect(socket, &QLocalSocket::readyRead, socket, [socket] {
+            // The handshake is ignored, a message glued to it would be lost
+            const auto data = socket->readAll();
+            if (!QJsonDocument::fromJson(data).isNull()) {
+                socket->write(data);
+                socket->flush();
+            }
+        });
+    });
+
+    m_proxy.reset(new QProcess());
+    m_proxy->start(KEEPASSXC_PROXY_PATH, {});
+    QVERIFY(m_proxy->waitForStarted(MessageTimeout));
+
+    const QByteArray message = R"({"action":"test"})";
+    writeMessage(message);
+    QCOMPARE(QJsonDocument::fromJson(readMessage()), QJsonDocument::fromJson(message));
+    writeMessage(message);
+    QCOMPARE(QJsonDocument::fromJson(readMessage()), QJsonDocument::fromJson(message));
+}
+
+void TestNativeMessagingProxy::benchmarkRoundTrip()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const QByteArray message = R"({"action":"get-logins","url":"https://example.com/login"})";
+    writeMessage(message);
+    QVERIFY(!readMessage().isEmpty());
+
+    QBENCHMARK {
+        writeMessage(message);
+        QVERIFY(!readMessage().isEmpty());
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+#define KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+
+#include <QObject>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+
+class BrowserHost;
+
+class TestNativeMessagingProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testRoundTrip();
+    void testPipelinedMessages();
+    void testLegacyHost();
+    void benchmarkRoundTrip();
+
+private:
+    void writeMessage(const QByteArray& message);
+    QByteArray readMessage();
+
+    QTemporaryDir m_runtimeDir;
+    QScopedPointer<BrowserHost> m_host;
+    QScopedPointer<QProcess> m_proxy;
+    QByteArray m_stdoutBuffer;
+};
+
+#endif // KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
@@ -17,14 +17,19 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Group.h"
 #include "core/PasswordHealth.h"
+#include "core/PasswordHealthService.h"
+#include "crypto/Crypto.h"
 
+#include <QSignalSpy>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestPasswordHealth)
 
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +69,57 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testHealthService()
+{
+    QSharedPointer<Database> db(new Database());
+    auto* root = db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setTitle("entry1");
+    entry1->setPassword("Yohb2ChR4");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setTitle("entry2");
+    entry2->setPassword("Yohb2ChR4");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setTitle("entry3");
+    entry3->setPassword("MIhIN9UKrgtPL2hp");
+    entry3->setGroup(root);
+
+    // Without the service the re-use map is built by the checker
+    const auto reused = HealthChecker(db).evaluate(entry1);
+    QVERIFY(reused->scoreReason().contains("used 2 time"));
+
+    db->setPasswordHealthServiceEnabled(true);
+    auto* service = db->passwordHealthService();
+    QVERIFY(service);
+
+    QSignalSpy finishedSpy(service, SIGNAL(evaluationFinished()));
+    service->evaluate();
+    QVERIFY(finishedSpy.count() == 1 || finishedSpy.wait());
+    QVERIFY(!service->isEvaluating());
+    QCOMPARE(service->entropy("Yohb2ChR4"), PasswordHealth::calculateEntropy("Yohb2ChR4"));
+
+    QCOMPARE(service->entriesUsingPassword("Yohb2ChR4").size(), 2);
+    QCOMPARE(HealthChecker(db).evaluate(entry1)->score(), reused->score());
+    QCOMPARE(entry3->passwordHealth()->quality(), PasswordHealth::Quality::Good);
+
+    // The re-use map follows password changes and removed entries
+    entry2->setPassword("MIhIN9UKrgtPL2hp");
+    QCOMPARE(service->entriesUsingPassword("Yohb2ChR4").size(), 1);
+    QCOMPARE(service->entriesUsingPassword("MIhIN9UKrgtPL2hp").size(), 2);
+    QVERIFY(!HealthChecker(db).evaluate(entry1)->scoreReason().contains("used"));
+    QVERIFY(HealthChecker(db).evaluate(entry3)->scoreReason().contains("used 2 time"));
+
+    delete entry2;
+    QCOMPARE(service->entriesUsingPassword("MIhIN9UKrgtPL2hp").size(), 1);
+
+    auto entry4 = new Entry();
+    entry4->setPassword("Yohb2ChR4");
+    entry4->setGroup(root);
+    QCOMPARE(service->entriesUsingPassword("Yohb2ChR4").size(), 2);
+}
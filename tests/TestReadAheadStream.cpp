@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestReadAheadStream.h"
+
+#include <QBuffer>
+#include <QTest>
+
+#include "FailDevice.h"
+#include "streams/ReadAheadStream.h"
+
+QTEST_GUILESS_MAIN(TestReadAheadStream)
+
+void TestReadAheadStream::testRead()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i) {
+        data.append(static_cast<char>(i % 251));
+    }
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    // Chunks smaller than the reads and a queue that fills up quickly
+    ReadAheadStream reader(&buffer, 7, 2);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QVERIFY(!reader.open(QIODevice::ReadOnly));
+
+    QByteArray result;
+    while (!reader.atEnd()) {
+        const auto chunk = reader.read(100);
+        QVERIFY(chunk.size() <= 100);
+        result.append(chunk);
+    }
+    QCOMPARE(result, data);
+    QCOMPARE(reader.read(1).size(), 0);
+}
+
+void TestReadAheadStream::testEarlyClose()
+{
+    QByteArray data(1024 * 1024, 'Z');
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    ReadAheadStream reader(&buffer, 16, 4);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QCOMPARE(reader.read(10), data.left(10));
+    // Must not block on the read ahead thread waiting for space in the queue
+    reader.close();
+    QVERIFY(!reader.isOpen());
+}
+
+void TestReadAheadStream::testReadFailure()
+{
+    QByteArray data(2000, 'Z');
+    FailDevice failDevice(1500);
+    failDevice.setData(data);
+    QVERIFY(failDevice.open(QIODevice::ReadOnly));
+
+    ReadAheadStream reader(&failDevice, 500, 4);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+
+    QCOMPARE(reader.read(1500), data.left(1500));
+    QCOMPARE(reader.read(500), QByteArray());
+    QCOMPARE(reader.errorString(), QString("FAILDEVICE"));
+}
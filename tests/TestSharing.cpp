@@ -17,12 +17,21 @@
 
 #include "TestSharing.h"
 
+#include <QFileInfo>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QXmlStreamReader>
 
+#include "core/Config.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "crypto/Random.h"
+#include "keeshare/KeeShare.h"
 #include "keeshare/KeeShareSettings.h"
+#include "keeshare/ShareExport.h"
+#include "keeshare/ShareImport.h"
+#include "keeshare/ShareObserver.h"
+#include "keys/PasswordKey.h"
 
 #include <botan/rsa.h>
 
@@ -35,6 +44,8 @@ Q_DECLARE_METATYPE(KeeShareSettings::Certificate)
 void TestSharing::initTestCase()
 {
     QVERIFY(Crypto::init());
+    Config::createTempFileInstance();
+    KeeShare::init(this);
 }
 
 void TestSharing::testNullObjects()
@@ -175,6 +186,164 @@ void TestSharing::testSettingsSerialization_data()
     QTest::newRow("5") << false << false << certificate0 << key0;
 }
 
+void TestSharing::testExportKeyReuse()
+{
+    Database db;
+    auto* group = new Group();
+    group->setName("Shared");
+    group->setParent(db.rootGroup());
+    auto* entry = new Entry();
+    entry->setTitle("Shared Entry");
+    entry->setGroup(group);
+
+    KeeShareSettings::Reference reference;
+    reference.type = KeeShareSettings::ExportTo;
+    reference.path = "share.kdbx";
+    reference.password = "password";
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto path = dir.filePath(reference.path);
+
+    // The key is derived while writing the first export
+    const auto first = ShareExport::prepare(path, reference, group);
+    QVERIFY(first.database->transformedDatabaseKey().isEmpty());
+    QVERIFY(!ShareExport::write(first).isError());
+    const auto transformedKey = first.database->transformedDatabaseKey();
+    QVERIFY(!transformedKey.isEmpty());
+
+    // and reused by the following ones
+    entry->setTitle("Changed Entry");
+    const auto second = ShareExport::prepare(path, reference, group, first.database.data());
+    QCOMPARE(second.database->transformedDatabaseKey(), transformedKey);
+    QVERIFY(!ShareExport::write(second).isError());
+    QCOMPARE(second.database->transformedDatabaseKey(), transformedKey);
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
+    Database exported;
+    QVERIFY(exported.open(path, key));
+    QCOMPARE(exported.rootGroup()->entries().size(), 1);
+    QCOMPARE(exported.rootGroup()->entries().first()->title(), QString("Changed Entry"));
+}
+
+void TestSharing::testExportDirtyTracking()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    KeeShareSettings::Active active;
+    active.out = true;
+    KeeShare::setActive(active);
+
+    auto db = QSharedPointer<Database>::create();
+    db->setFilePath(dir.filePath("database.kdbx"));
+    QList<Entry*> entries;
+    QStringList paths;
+    for (const auto& name : {QString("SharedA"), QString("SharedB"), QString("Private")}) {
+        auto* group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(name);
+        group->setParent(db->rootGroup());
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(name);
+        entry->setGroup(group);
+        entries << entry;
+
+        if (name.startsWith("Shared")) {
+            KeeShareSettings::Reference reference;
+            reference.type = KeeShareSettings::ExportTo;
+            reference.path = name + ".kdbx";
+            reference.password = "password";
+            KeeShare::setReferenceTo(group, reference);
+            paths << dir.filePath(reference.path);
+        }
+    }
+
+    auto readContainer = [](const QString& path) {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    };
+    auto markStale = [](const QString& path) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write("stale") == 5;
+    };
+
+    // Every share is exported on the first save
+    ShareObserver observer(db);
+    emit db->databaseSaved();
+    for (const auto& path : asConst(paths)) {
+        QVERIFY(QFileInfo::exists(path));
+        QVERIFY(markStale(path));
+    }
+
+    // Changes outside of the shared groups do not export anything
+    entries[2]->setTitle("Changed Private");
+    emit db->databaseSaved();
+    QCOMPARE(readContainer(paths[0]), QByteArray("stale"));
+    QCOMPARE(readContainer(paths[1]), QByteArray("stale"));
+
+    // Only the share containing a changed entry is exported again
+    entries[0]->setTitle("Changed SharedA");
+    emit db->databaseSaved();
+    QVERIFY(readContainer(paths[0]) != QByteArray("stale"));
+    QCOMPARE(readContainer(paths[1]), QByteArray("stale"));
+
+    // and nothing is left to export afterwards
+    QVERIFY(markStale(paths[0]));
+    emit db->databaseSaved();
+    QCOMPARE(readContainer(paths[0]), QByteArray("stale"));
+
+    KeeShare::setActive({});
+}
+
+void TestSharing::testImportContainer()
+{
+    QFETCH(QString, fileName);
+
+    Database sourceDb;
+    auto* sourceGroup = new Group();
+    sourceGroup->setUuid(QUuid::createUuid());
+    sourceGroup->setName("Shared");
+    sourceGroup->setParent(sourceDb.rootGroup());
+    auto* entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("Shared Entry");
+    entry->setGroup(sourceGroup);
+
+    KeeShareSettings::Reference reference;
+    reference.type = KeeShareSettings::SynchronizeWith;
+    reference.path = fileName;
+    reference.password = "password";
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto path = dir.filePath(fileName);
+    QVERIFY(!ShareExport::intoContainer(path, reference, sourceGroup).isError());
+
+    Database targetDb;
+    auto* targetGroup = new Group();
+    targetGroup->setUuid(QUuid::createUuid());
+    targetGroup->setParent(targetDb.rootGroup());
+    const auto result = ShareImport::containerInto(path, reference, targetGroup);
+    QVERIFY(!result.isError());
+    auto* importedEntry = targetGroup->findEntryByUuid(entry->uuid());
+    QVERIFY(importedEntry);
+    QCOMPARE(importedEntry->title(), entry->title());
+
+    // A wrong password is reported, not silently ignored
+    reference.password = "wrong";
+    QVERIFY(ShareImport::containerInto(path, reference, targetGroup).isError());
+}
+
+void TestSharing::testImportContainer_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::newRow("Database") << QString("share.kdbx");
+    QTest::newRow("Signed container") << QString("share.kdbx.share");
+}
+
 const QSharedPointer<Botan::RSA_PrivateKey> TestSharing::stubkey(int index)
 {
     static QMap<int, QSharedPointer<Botan::RSA_PrivateKey>> keys;
@@ -36,6 +36,10 @@ private slots:
     void testReferenceSerialization_data();
     void testSettingsSerialization();
     void testSettingsSerialization_data();
+    void testExportKeyReuse();
+    void testExportDirtyTracking();
+    void testImportContainer();
+    void testImportContainer_data();
 
 private:
     const QSharedPointer<Botan::RSA_PrivateKey> stubkey(int index = 0);
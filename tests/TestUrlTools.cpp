@@ -142,3 +142,42 @@ void TestUrlTools::testDomainHasIllegalCharacters()
     QVERIFY(urlTools()->domainHasIllegalCharacters("domain has spaces.com"));
     QVERIFY(urlTools()->domainHasIllegalCharacters("example#|.com"));
 }
+
+void TestUrlTools::testNormalizeUrl()
+{
+    auto url = urlTools()->normalizeUrl("https://login.example.co.uk:8443/path?query=1");
+    QVERIFY(url.hasScheme);
+    QCOMPARE(url.scheme, QString("https"));
+    QCOMPARE(url.host, QString("login.example.co.uk"));
+    QCOMPARE(url.port, 8443);
+    QCOMPARE(url.path, QString("/path"));
+    QCOMPARE(url.baseDomain, QString("example.co.uk"));
+    QVERIFY(!url.hasIllegalCharacters);
+
+    // URLs without a scheme are parsed as user input
+    url = urlTools()->normalizeUrl("www.example.com/login");
+    QVERIFY(!url.hasScheme);
+    QCOMPARE(url.host, QString("www.example.com"));
+    QCOMPARE(url.port, -1);
+    QCOMPARE(url.path, QString("/login"));
+    QCOMPARE(url.baseDomain, QString("example.com"));
+
+    url = urlTools()->normalizeUrl("https://192.168.0.1:8000");
+    QCOMPARE(url.host, QString("192.168.0.1"));
+    QCOMPARE(url.baseDomain, QString("192.168.0.1"));
+
+    url = urlTools()->normalizeUrl("https://example.com/{USERNAME}");
+    QVERIFY(url.hasIllegalCharacters);
+
+    url = urlTools()->normalizeUrl("file:///home/user/test.html");
+    QVERIFY(url.host.isEmpty());
+    QVERIFY(url.baseDomain.isEmpty());
+
+    // Cached results are identical to freshly parsed ones
+    for (int i = 0; i < 2; ++i) {
+        url = urlTools()->normalizeUrl("https://another.example.co.uk");
+        QCOMPARE(url.host, QString("another.example.co.uk"));
+        QCOMPARE(url.baseDomain, QString("example.co.uk"));
+        QCOMPARE(urlTools()->getTopLevelDomainFromUrl("https://another.example.co.uk"), QString("co.uk"));
+    }
+}
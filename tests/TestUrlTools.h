@@ -35,6 +35,7 @@ private slots:
     void testIsUrlIdentical();
     void testIsUrlValid();
     void testDomainHasIllegalCharacters();
+    void testNormalizeUrl();
 
 private:
     QPointer<UrlTools> m_urlTools;
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestWriteBehindStream.h"
+
+#include <QBuffer>
+#include <QTest>
+
+#include "FailDevice.h"
+#include "streams/WriteBehindStream.h"
+
+QTEST_GUILESS_MAIN(TestWriteBehindStream)
+
+void TestWriteBehindStream::testWrite()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i) {
+        data.append(static_cast<char>(i % 251));
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    // Chunks smaller than the writes and a queue that fills up quickly
+    WriteBehindStream writer(&buffer, 7, 2);
+    QVERIFY(!writer.open(QIODevice::ReadOnly));
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+
+    for (int i = 0; i < data.size(); i += 100) {
+        QCOMPARE(writer.write(data.mid(i, 100)), qint64(100));
+    }
+    QVERIFY(writer.reset());
+    QCOMPARE(buffer.data(), data);
+
+    // The stream remains usable after reset()
+    QCOMPARE(writer.write(data.left(10)), qint64(10));
+    writer.close();
+    QCOMPARE(buffer.data(), data + data.left(10));
+}
+
+void TestWriteBehindStream::testWriteFailure()
+{
+    FailDevice failDevice(1500);
+    QVERIFY(failDevice.open(QIODevice::WriteOnly));
+
+    WriteBehindStream writer(&failDevice, 500, 4);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+
+    QCOMPARE(writer.write(QByteArray(1500, 'Z')), qint64(1500));
+    writer.write(QByteArray(500, 'Z'));
+    QVERIFY(!writer.reset());
+    QCOMPARE(writer.errorString(), QString("FAILDEVICE"));
+    QCOMPARE(writer.write(QByteArray(500, 'Z')), qint64(-1));
+}
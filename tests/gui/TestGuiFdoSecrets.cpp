@@ -334,6 +334,29 @@ void TestGuiFdoSecrets::testServiceSearch()
         COMPARE(unlocked, {QDBusObjectPath(item->path())});
     }
 
+    // matching items are returned in tree order
+    {
+        QStringList expected;
+        for (const auto& other : m_db->rootGroup()->entriesRecursive()) {
+            if (!other->isRecycled()) {
+                other->attributes()->set("fdosecrets-order", "1");
+                expected << other->uuidToHex();
+            }
+        }
+        VERIFY(expected.size() >= 2);
+
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-order", "1"}}));
+        COMPARE(locked, {});
+        QStringList actual;
+        for (const auto& path : unlocked) {
+            auto found = getProxy<ItemProxy>(path);
+            VERIFY(found);
+            DBUS_GET(attributes, found->attributes());
+            actual << attributes.value(ItemAttributes::UuidKey);
+        }
+        COMPARE(actual, expected);
+    }
+
     // searching using empty terms returns nothing
     {
         DBUS_GET2(unlocked, locked, service->SearchItems({}));
@@ -1559,6 +1582,87 @@ void TestGuiFdoSecrets::testItemRejectSetReferenceFields()
     }
 }
 
+void TestGuiFdoSecrets::testItemLoadedOnDemand()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    // listing the items does not create them
+    DBUS_GET(itemPaths, coll->items());
+    VERIFY(itemPaths.size() > 1);
+    COMPARE(collObj->findChildren<Item*>().size(), 0);
+
+    // accessing an item over DBus creates only that item
+    auto item = getProxy<ItemProxy>(itemPaths.first());
+    VERIFY(item);
+    DBUS_COMPARE(item->locked(), false);
+    COMPARE(collObj->findChildren<Item*>().size(), 1);
+
+    auto itemObj = m_plugin->dbus()->pathToObject<Item>(itemPaths.first());
+    VERIFY(itemObj);
+    COMPARE(itemObj->objectPath(), itemPaths.first());
+    COMPARE(collObj->findChildren<Item*>().size(), 1);
+
+    // modifying an entry that has no item yet still notifies clients
+    QSignalSpy spyItemChanged(coll.data(), SIGNAL(ItemChanged(QDBusObjectPath)));
+    VERIFY(spyItemChanged.isValid());
+    auto id = itemPaths.last().path().section('/', -1);
+    auto entry = m_db->rootGroup()->findEntryByUuid(QUuid::fromRfc4122(QByteArray::fromHex(id.toLatin1())));
+    VERIFY(entry);
+    entry->setTitle("Changed title");
+    QTRY_VERIFY(!spyItemChanged.isEmpty());
+    for (const auto& args : spyItemChanged) {
+        COMPARE(args.at(0).value<QDBusObjectPath>(), itemPaths.last());
+    }
+    COMPARE(collObj->findChildren<Item*>().size(), 1);
+}
+
+void TestGuiFdoSecrets::testItemPinnedByPrompt()
+{
+    FdoSecrets::settings()->setConfirmDeleteItem(true);
+
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+    auto item = getFirstItem(coll);
+    VERIFY(item);
+    const auto itemPath = item->path();
+    QPointer<Item> itemObj = m_plugin->dbus()->pathToObject<Item>(QDBusObjectPath(itemPath));
+    VERIFY(itemObj);
+    QPointer<Entry> entry = itemObj->backend();
+    VERIFY(entry);
+
+    DBUS_GET(promptPath, item->Delete());
+    auto prompt = getProxy<PromptProxy>(promptPath);
+    VERIFY(prompt);
+
+    // load more items than the collection keeps loaded, the item of the pending prompt stays
+    for (int i = 0; i < 1100; ++i) {
+        auto other = new Entry();
+        other->setUuid(QUuid::createUuid());
+        other->setGroup(m_db->rootGroup());
+        VERIFY(collObj->itemById(other->uuidToHex()));
+    }
+    processEvents();
+    VERIFY(itemObj);
+
+    QSignalSpy spyPromptCompleted(prompt.data(), SIGNAL(Completed(bool, QDBusVariant)));
+    VERIFY(spyPromptCompleted.isValid());
+    MessageBox::setNextAnswer(MessageBox::Delete);
+    DBUS_VERIFY(prompt->Prompt(""));
+    VERIFY(waitForSignal(spyPromptCompleted, 1));
+    COMPARE(spyPromptCompleted.takeFirst().at(0).toBool(), false);
+    // the entry is actually gone, not just reported as deleted
+    VERIFY(!entry || entry->isRecycled());
+}
+
 void TestGuiFdoSecrets::testAlias()
 {
     auto service = enableService();
@@ -93,6 +93,8 @@ private slots:
     void testItemDelete();
     void testItemLockState();
     void testItemRejectSetReferenceFields();
+    void testItemLoadedOnDemand();
+    void testItemPinnedByPrompt();
 
     void testAlias();
     void testDefaultAliasAlwaysPresent();